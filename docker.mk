@@ -3,6 +3,6 @@
 # Default options for ambre computer
 #######################################
 CC=gcc
-LIBSLOCAL=-L/usr/lib -llapack -lblas -lm
+LIBSLOCAL=-L/usr/lib -llapack -lblas -lm -lpthread -lrt
 INCLUDEBLASLOCAL=-I/usr/include
-OPTCLOCAL=-O3 -fPIC -I/usr/include
+OPTCLOCAL=-O3 -fPIC -fopenmp -I/usr/include
@@ -8,15 +8,21 @@
 #include <math.h>
 #include <float.h>
 #include <limits.h>
+#include <string.h>
+#include <pthread.h>
 #include "atlas_headers.h"
 
 void set_GB_operator_colMajor_poisson1D(double* AB, int* lab, int *la, int *kv);
+void set_GB_operator_colMajor_poisson1D_quiet(double* AB, int* lab, int *la, int *kv);
 void set_GB_operator_colMajor_poisson1D_DGBMV(double* AB, int* lab, int *la, int *kv);
 void set_GB_operator_colMajor_poisson1D_Id(double* AB, int* lab, int *la, int *kv);
 void set_dense_RHS_DBC_1D(double* RHS, int* la, double* BC0, double* BC1);
 void set_analytical_solution_DBC_1D(double* EX_SOL, double* X, int* la, double* BC0, double* BC1);
 void set_grid_points_1D(double* x, int* la);
 double relative_forward_error(double* x, double* y, int* la);
+double dot_repro(int *n, double *x, double *y);
+double nrm2_repro(int *n, double *x);
+double nrm2_diff_repro(int *n, double *x, double *y);
 void write_GB2AIJ_operator_poisson1D(double* AB, int *la, char* filename);
 void write_GB_operator_rowMajor_poisson1D(double* AB, int* lab, int *la, char* filename);
 void write_GB_operator_colMajor_poisson1D(double* AB, int* lab, int* la, char* filename);
@@ -26,6 +32,7 @@ void eig_poisson1D(double* eigval, int *la);
 double eigmax_poisson1D(int *la);
 double eigmin_poisson1D(int *la);
 double richardson_alpha_opt(int *la);
+double richardson_alpha_step(double *AB, double *RHS, double *X, double *AX, double *resid, double *alpha_rich, int *lab, int *la, int *ku, int *kl);
 void richardson_alpha(double *AB, double *RHS, double *X, double *alpha_rich, int *lab, int *la,int *ku, int*kl, double *tol, int *maxit, double *resvec, int *nbite);
 void extract_MB_jacobi_tridiag(double *AB, double *MB, int *lab, int *la,int *ku, int*kl, int *kv);
 void extract_MB_gauss_seidel_tridiag(double *AB, double *MB, int *lab, int *la,int *ku, int*kl, int *kv);
@@ -35,5 +42,511 @@ int dgbtrftridiag(int *la, int *n, int *kl, int *ku, double *AB, int *lab, int *
 int test_dgbtrftridiag(void);
 void dgbmv_poisson1D(double *AB, double *RHS, double *X, int *la, int *lab, int *ku, int *kl, int *kv);
 int test_dgbmv_poisson1D(void);
+double jacobi_tridiag_step(double *AB, double *RHS, double *X, double *X_new, int *lab, int *la);
 void jacobi_tridiag(double *AB, double *RHS, double *X, int *lab, int *la, int *ku, int *kl, double *tol, int *maxit, double *resvec, int *nbite);
+double gauss_seidel_tridiag_step(double *AB, double *RHS, double *X, double *AX, int *lab, int *la, int *ku, int *kl);
 void gauss_seidel_tridiag(double *AB, double *RHS, double *X, int *lab, int *la, int *ku, int *kl, double *tol, int *maxit, double *resvec, int *nbite);
+
+/* Sparse storage: CSR and SELL-C-sigma */
+#define SELL_MAX_C 16
+typedef struct {
+  int n;          /* number of rows */
+  int m;          /* number of columns */
+  int nnz;
+  int *rowptr;    /* size n+1 */
+  int *colind;    /* size nnz, 0-based */
+  double *val;    /* size nnz */
+} csr_matrix;
+typedef struct {
+  int n;          /* number of rows */
+  int C;          /* chunk height (SIMD width) */
+  int sigma;      /* sorting window */
+  int nchunks;
+  int *perm;      /* perm[c*C+k] = original row of lane k in chunk c, -1 if padding */
+  int *chunkptr;  /* offset of each chunk in colind/val, size nchunks+1 */
+  int *chunklen;  /* width of each chunk */
+  int *colind;
+  double *val;
+} sell_matrix;
+int csr_alloc(csr_matrix *A, int n, int m, int nnz);
+void csr_free(csr_matrix *A);
+int GB2CSR_operator_colMajor(double *AB, int *lab, int *la, int *ku, int *kl, int *kv, csr_matrix *A);
+int read_AIJ_operator(char *filename, int *la, csr_matrix *A);
+void csr_spmv(csr_matrix *A, double *x, double *y);
+int CSR2SELL(csr_matrix *A, int C, int sigma, sell_matrix *S);
+void sell_free(sell_matrix *S);
+void sell_spmv(sell_matrix *S, double *x, double *y);
+void richardson_alpha_csr(csr_matrix *A, double *RHS, double *X, double *alpha_rich, double *tol, int *maxit, double *resvec, int *nbite);
+void jacobi_csr(csr_matrix *A, double *RHS, double *X, double *tol, int *maxit, double *resvec, int *nbite);
+void gauss_seidel_csr(csr_matrix *A, double *RHS, double *X, double *tol, int *maxit, double *resvec, int *nbite);
+
+/* Fast spectral solver: DST-I on an in-house mixed-radix FFT */
+#define DST_MAX_RADIX 64
+typedef struct {
+  int n;          /* DST-I length (la) */
+  int M;          /* complex FFT length, n+1 */
+  int L;          /* inner FFT length: M, or 2^q >= 2M-1 (Bluestein) */
+  int nfact;
+  int fact[64];   /* (radix, remaining length) pairs of L */
+  double *tw;     /* exp(-2i pi k/L), interleaved re/im */
+  double *twr;    /* exp(-i pi k/M), real post-processing */
+  double *chirp;  /* exp(-i pi k^2/M), Bluestein only */
+  double *bfft;   /* FFT of the Bluestein kernel */
+  double *eig;    /* eigenvalues of the [-1 2 -1] operator */
+} dst_plan;
+int dst_plan_create(dst_plan *plan, int *la);
+void dst_plan_free(dst_plan *plan);
+int dst_plan_worksize(const dst_plan *plan);
+void dst1_apply(const dst_plan *plan, double *x, double *work);
+void poisson1D_dst_solve(dst_plan *plan, double *RHS, int *nrhs, int *ldrhs, double *diag, double *offdiag);
+
+/* Autotuned solver dispatch */
+#define POISSON1D_DGBSV 0
+#define POISSON1D_DGBTRFTRIDIAG 1
+#define POISSON1D_DST 2
+#define POISSON1D_MIXED 3
+#define POISSON1D_RICHARDSON 4
+#define POISSON1D_JACOBI 5
+#define POISSON1D_GS 6
+#define POISSON1D_NMETHOD 7
+typedef struct {
+  int method;     /* POISSON1D_* */
+  int nthreads;
+  int tile;       /* right-hand sides per solve batch */
+  double tol;     /* backward error the configuration was validated for */
+  double time;    /* measured time per right-hand side (s) */
+} poisson1D_config;
+const char *poisson1D_method_name(int method);
+int poisson1D_autotune(int *la, double *tol, poisson1D_config *best);
+/* Solves the nrhs systems in place with the configuration tuned for the size
+   class of la. The backward error is checked against tol and the systems are
+   re-solved with dgbsv if the tuned method misses it; nonzero if that fails */
+int poisson1D_solve(double *RHS, int *la, int *nrhs, double *tol);
+
+/* Checkpoint/restart of the iterative solvers */
+#define CKPT_RICHARDSON 0
+#define CKPT_JACOBI 1
+#define CKPT_GS 2
+typedef struct {
+  char magic[8];
+  int version;
+  int solver;
+  int la;
+  int iter;
+  int maxit;
+  int pad;
+  double tol;
+  double alpha;
+  unsigned long long checksum;   /* FNV-1a of X then resvec[0..iter] */
+} ckpt_header;
+typedef struct {
+  char *filename;
+  int every;          /* checkpoint period in iterations, 0 = never */
+  int pending;        /* an asynchronous write is in flight */
+  int status;         /* result of the last write */
+  pthread_t thread;
+  ckpt_header hdr;
+  double *buf;        /* snapshot being written */
+  size_t buflen;
+  size_t bufcap;
+} ckpt_ctx;
+void ckpt_init(ckpt_ctx *ctx, char *filename, int every);
+int ckpt_save(ckpt_ctx *ctx, int solver, int *la, int iter, int *maxit, double *tol, double *alpha, double *X, double *resvec);
+int ckpt_load(ckpt_ctx *ctx, int solver, int *la, int *maxit, double *tol, double *alpha, double *X, double *resvec, int *iter);
+int ckpt_wait(ckpt_ctx *ctx);
+void ckpt_free(ckpt_ctx *ctx);
+void iterative_solve_ckpt(int solver, double *AB, double *RHS, double *X, double *alpha_rich, int *lab, int *la, int *ku, int *kl, double *tol, int *maxit, double *resvec, int *nbite, ckpt_ctx *ctx);
+
+/* Superposition cache of the Dirichlet basis solutions, keyed by la */
+typedef struct bc_entry {
+  int la;
+  int refcount;             /* queries in progress, pinned against eviction */
+  unsigned long long hits;
+  size_t bytes;
+  double *B;                /* u0 and u1 interleaved: B[2j] = u0[j], B[2j+1] = u1[j] */
+  struct bc_entry *prev;
+  struct bc_entry *next;
+} bc_entry;
+typedef struct {
+  bc_entry *head;           /* most recently used */
+  bc_entry *tail;           /* least recently used */
+  size_t bytes;
+  size_t max_bytes;         /* 0 = unbounded */
+  int nentries;
+  unsigned long long nsolves;
+  pthread_mutex_t lock;
+} bc_cache;
+void bc_cache_init(bc_cache *cache, size_t max_bytes);
+int bc_cache_solve(bc_cache *cache, int *la, double *BC0, double *BC1, double *X);
+void bc_cache_free(bc_cache *cache);
+
+/* Out-of-core vectors: binary files of n doubles, memory-mapped */
+typedef struct {
+  int fd;
+  long long n;
+  size_t len;               /* bytes mapped */
+  double *map;
+} ooc_vec;
+int ooc_vec_create(ooc_vec *v, char *filename, long long n);
+int ooc_vec_open(ooc_vec *v, char *filename, long long n);
+void ooc_vec_close(ooc_vec *v);
+int ooc_set_dense_RHS_DBC_1D(ooc_vec *RHS, double *BC0, double *BC1);
+/* Streaming Thomas solve; DL, D, DU may be NULL for the [-1 2 -1] operator.
+   SPILL holds the factor (2n doubles). Returns 0, -1 if SOL or SPILL is too
+   small, or i+1 when the pivot of row i is below 1e-10 relative to the terms
+   |d_i| + |l_i c'_{i-1}| it is computed from. */
+long long ooc_tridiag_solve(ooc_vec *DL, ooc_vec *D, ooc_vec *DU, ooc_vec *RHS, ooc_vec *SOL, ooc_vec *SPILL, long long chunk);
+
+/* Resident solver server: fixed-size binary messages on a Unix socket,
+   solutions in a POSIX shared memory segment created by the client */
+#define P1D_SERVER_MAGIC 0x50314453u
+#define P1D_OP_ATTACH 1       /* map the client segment named in shm */
+#define P1D_OP_SOLVE 2
+#define P1D_OP_SHUTDOWN 3
+#define P1D_SOLVER_BCCACHE 0  /* Dirichlet problem (T0, T1), superposition cache */
+#define P1D_SOLVER_LU 1       /* RHS read from the segment, solved in place with a cached LU */
+#define P1D_EPROTO -1
+#define P1D_ESHM -2
+#define P1D_ESOLVE -3
+#define P1D_ETOL -4           /* solved, but backward error above tol */
+typedef struct {
+  unsigned int magic;
+  int op;
+  int la;
+  int solver;
+  double T0, T1;
+  double tol;
+  char shm[64];
+} p1d_request;
+typedef struct {
+  int status;
+  int la;
+  double berr;              /* backward error of the returned solution */
+} p1d_reply;
+typedef struct p1d_lu_entry {
+  int la;
+  int refcount;             /* solves in progress, pinned against eviction */
+  size_t bytes;
+  double *AB;               /* dgbtrf factor, lab = 4 */
+  int *ipiv;
+  struct p1d_lu_entry *prev;
+  struct p1d_lu_entry *next;
+} p1d_lu_entry;
+typedef struct {
+  int fd;
+  char path[108];
+  volatile int stop;
+  bc_cache bc;
+  p1d_lu_entry *lu_head;    /* LU cache, most recently used first */
+  p1d_lu_entry *lu_tail;
+  size_t lu_bytes;
+  size_t lu_max_bytes;      /* same bound as the BC cache, 0 = unbounded */
+  int nlu;
+  pthread_mutex_t lu_lock;
+  struct p1d_conn *conns;   /* live connections, drained by p1d_server_run */
+  int nconn;
+  pthread_mutex_t conn_lock;
+  pthread_cond_t conn_done;
+  int nfactor;
+  unsigned long long nrequests;
+} p1d_server;
+typedef struct {
+  int fd;
+  int maxla;
+  size_t len;
+  char shm[64];
+  double *X;                /* shared segment: RHS in, solution out */
+} p1d_client;
+/* cache_bytes bounds the BC cache and the LU cache, each (LRU eviction) */
+int p1d_server_init(p1d_server *srv, char *path, size_t cache_bytes);
+/* Returns once stopped and every connection thread has exited */
+int p1d_server_run(p1d_server *srv);
+void p1d_server_stop(p1d_server *srv);
+void p1d_server_free(p1d_server *srv);
+int p1d_client_connect(p1d_client *cli, char *path, int maxla);
+int p1d_client_solve(p1d_client *cli, p1d_request *req, p1d_reply *rep);
+int p1d_client_shutdown(p1d_client *cli);
+void p1d_client_close(p1d_client *cli);
+
+/* NUMA-aware assembly: same static partition as the OpenMP solvers */
+#define POISSON1D_PIN_NONE 0
+#define POISSON1D_PIN_COMPACT 1   /* fill one socket before the next */
+#define POISSON1D_PIN_SPREAD 2    /* round-robin over sockets */
+void poisson1D_partition(int *la, int nthreads, int tid, int *lo, int *hi);
+void set_GB_operator_colMajor_poisson1D_par(double* AB, int* lab, int *la, int *kv);
+void set_dense_RHS_DBC_1D_par(double* RHS, int* la, double* BC0, double* BC1);
+void set_analytical_solution_DBC_1D_par(double* EX_SOL, double* X, int* la, double* BC0, double* BC1);
+void set_grid_points_1D_par(double* x, int* la);
+int poisson1D_pin_policy(char *name);
+int poisson1D_pin_threads(int policy);
+/* CPU assigned to thread tid by the policy, -1 for POISSON1D_PIN_NONE */
+int poisson1D_pin_cpu(int policy, int tid);
+
+/* Source term -u'' = f on ]0,1[: RHS builders for the [-1 2 -1] operator */
+typedef double (*poisson1D_source)(double x, void *ctx);
+void set_dense_RHS_source_1D(double* RHS, int* la, poisson1D_source f, void *ctx, double* BC0, double* BC1);
+void set_dense_RHS_numerov_1D(double* RHS, int* la, poisson1D_source f, void *ctx, double* BC0, double* BC1);
+/* Uc on la points, Uf on 2*la+1 points, scheme of order p; U has la points */
+void richardson_extrapolate_1D(double *Uc, double *Uf, int *lac, int *p, double *U);
+
+/* Non-uniform grids: x holds the la interior nodes, strictly increasing in ]0,1[ */
+void set_grid_points_stretched_1D(double* x, int* la, double* beta);
+void set_grid_points_graded_1D(double* x, int* la, double* ratio);
+int check_grid_points_1D(double* x, int* la);
+void set_GB_operator_colMajor_poisson1D_nonuniform(double* AB, int *lab, int *la, double *x, int *kv);
+void set_dense_RHS_nonuniform_1D(double* RHS, int* la, double *x, poisson1D_source f, void *ctx, double* BC0, double* BC1);
+/* Adaptive loop from a uniform grid of la0 points: bisects the intervals whose
+   interpolation error estimate exceeds tol, warm-starting each level from the
+   previous solution. *uout is the discrete solution on the returned grid
+   *xout; both are allocated (free them). Returns -1 if an allocation fails. */
+int poisson1D_adaptive(poisson1D_source f, void *ctx, double *BC0, double *BC1, double *tol,
+                       int la0, int maxla, int maxlevel, double **xout, double **uout, int *laout, int *nlevel);
+
+/* 2D/3D Dirichlet Poisson -Laplace(u) = f on the unit square/cube, 5/7-point
+   stencil, arrays ordered x fastest: U[i + nx*(j + ny*l)] */
+typedef double (*poisson_nd_func)(double x, double y, double z, void *ctx);
+typedef struct {
+  int dim;
+  int n[3];
+  double h[3];
+  dst_plan dst[2];  /* DST-I along the transformed axes (all but the last) */
+  long P;           /* points per plane orthogonal to the last axis */
+  int nlast;
+  double *lambda;   /* diagonal of each batched tridiagonal system, size P */
+  double *invm;     /* reciprocal Thomas pivots, size P*nlast */
+} poisson_nd_plan;
+int poisson2D_plan_create(poisson_nd_plan *plan, int *nx, int *ny);
+int poisson3D_plan_create(poisson_nd_plan *plan, int *nx, int *ny, int *nz);
+void poisson_nd_plan_free(poisson_nd_plan *plan);
+void poisson_nd_solve(poisson_nd_plan *plan, double *U);
+void set_dense_RHS_DBC_nd(double *RHS, poisson_nd_plan *plan, poisson_nd_func f, poisson_nd_func g, void *ctx);
+
+/* Convection-diffusion -u'' + v u' = f (scaled by h^2 like [-1 2 -1]) and
+   Krylov solvers on tridiagonal operators */
+#define CONVDIFF_CENTRAL 0
+#define CONVDIFF_UPWIND 1
+#define KRYLOV_PREC_NONE 0
+#define KRYLOV_PREC_JACOBI 1
+#define KRYLOV_PREC_ILU0 2   /* tridiagonal ILU(0) */
+typedef struct {
+  int n;
+  int m;            /* GMRES restart length */
+  int prec;
+  double *dl, *d, *du;  /* operator diagonals: A(i,i-1), A(i,i), A(i,i+1) */
+  double *pl, *pu;      /* preconditioner: L multipliers, reciprocal pivots */
+  double *V;        /* n x (m+1) Krylov basis */
+  double *Z;        /* 8 work vectors of size n */
+  double *H;        /* (m+1) x m Hessenberg, column-major */
+  double *hv;       /* Givens and right-hand side, 4(m+1) */
+  double *partial;  /* per-block partial sums of the fused reductions */
+} krylov_ws;
+void set_GB_operator_colMajor_convdiff(double* AB, int *lab, int *la, int *kv, double *v, int scheme);
+void set_dense_RHS_DBC_convdiff(double* RHS, int* la, double *v, int scheme, double* BC0, double* BC1);
+void set_analytical_solution_convdiff(double* EX_SOL, double* X, int* la, double *v, double* BC0, double* BC1);
+int krylov_ws_init(krylov_ws *ws, double *AB, int *lab, int *la, int *kv, int *m, int prec);
+void krylov_ws_free(krylov_ws *ws);
+void gmres_tridiag(krylov_ws *ws, double *RHS, double *X, double *tol, int *maxit, double *resvec, int *nbite);
+void bicgstab_tridiag(krylov_ws *ws, double *RHS, double *X, double *tol, int *maxit, double *resvec, int *nbite);
+
+/* General boundary conditions: alpha u + beta du/dn = g, du/dn being the
+   outward normal derivative (-u'(0) at the left end, u'(1) at the right end).
+   Dirichlet rows are eliminated as in set_dense_RHS_DBC_1D; Neumann/Robin end
+   nodes are unknowns and their rows are halved so the operator stays
+   symmetric; periodic identifies x=1 with x=0 and puts the two corners
+   A(0,la-1), A(la-1,0) in corner[0..1]. */
+#define BC_DIRICHLET 0
+#define BC_NEUMANN 1
+#define BC_ROBIN 2
+#define BC_PERIODIC 3
+typedef struct {
+  int type;
+  double alpha;
+  double beta;
+  double g;
+} poisson1D_bc;
+int set_grid_points_bc_1D(double* x, int* la, poisson1D_bc *left, poisson1D_bc *right);
+/* -u'' + sigma u, scaled by h^2 */
+int set_GB_operator_colMajor_bc(double* AB, int *lab, int *la, int *kv, double *sigma,
+                                poisson1D_bc *left, poisson1D_bc *right, double *corner);
+int set_dense_RHS_bc_1D(double* RHS, int* la, poisson1D_source f, void *ctx,
+                        poisson1D_bc *left, poisson1D_bc *right);
+/* Cyclic tridiagonal solve in O(n) by Sherman-Morrison, la >= 3 */
+int cyclic_tridiag_solve(double *AB, int *lab, int *la, int *kv, double *corner, double *RHS);
+/* O(n) solve for any boundary type. A singular operator (pure Neumann or
+   periodic, sigma = 0) gets the constant part of f removed from RHS (returned
+   in *mean) and the solution with zero trapezoidal mean. */
+int poisson1D_bc_solve(double *AB, int *lab, int *la, int *kv, double *corner,
+                       poisson1D_bc *left, poisson1D_bc *right, double *RHS, double *mean);
+
+/* Persistent thread team: threads are created (and pinned) once, the caller
+   is member 0. Iterative solves synchronize through neighbour halo flags and
+   a combined reduction lagged by one sweep, not through a join per loop. */
+#define P1D_TEAM_RING 4
+#define P1D_TEAM_NRED 4
+typedef struct {
+  int epoch;                       /* last published sweep (halo flag) */
+  int sense;                       /* local barrier sense */
+  int red_parity;
+  double ring[P1D_TEAM_RING];      /* partial sums of the last sweeps */
+  double red[2][P1D_TEAM_NRED];    /* p1d_team_allreduce, double-buffered */
+} __attribute__((aligned(64))) p1d_team_slot;
+typedef struct p1d_team p1d_team;
+typedef void (*p1d_team_fn)(p1d_team *team, int tid, void *arg);
+struct p1d_team {
+  int nthreads;
+  int policy;                      /* POISSON1D_PIN_* */
+  pthread_t *threads;
+  void *args;
+  pthread_mutex_t lock;            /* only taken to wake sleeping workers */
+  pthread_cond_t wake;
+  int gen;                         /* job generation */
+  int stop;
+  p1d_team_fn fn;
+  void *arg;
+  int bar_count;
+  int bar_sense;
+  p1d_team_slot *slot;             /* one cache line per member */
+};
+int p1d_team_create(p1d_team *team, int nthreads, int policy);
+void p1d_team_free(p1d_team *team);
+/* Runs fn on every member and returns after the closing barrier */
+void p1d_team_run(p1d_team *team, p1d_team_fn fn, void *arg);
+void p1d_team_barrier(p1d_team *team, int tid);
+void p1d_team_allreduce(p1d_team *team, int tid, double *v, int nv);
+void p1d_team_publish(p1d_team *team, int tid, int epoch, double partial);
+void p1d_team_wait(p1d_team *team, int tid, int epoch);
+double p1d_team_gather(p1d_team *team, int epoch);
+/* Same iterates, resvec and nbite as jacobi_tridiag / richardson_alpha (up to
+   rounding in the residual norms); the slice of each member is given by
+   poisson1D_partition */
+void jacobi_tridiag_team(p1d_team *team, double *AB, double *RHS, double *X, int *lab, int *la,
+                         double *tol, int *maxit, double *resvec, int *nbite);
+void richardson_alpha_team(p1d_team *team, double *AB, double *RHS, double *X, double *alpha_rich,
+                           int *lab, int *la, double *tol, int *maxit, double *resvec, int *nbite);
+
+/* Heat equation u_t = u_xx on ]0,1[, u(0) = T0, u(1) = T1, implicit Euler:
+   (I + r A) U^{n+1} = U^n + r (T0 e_1 + T1 e_la), r = dt/h^2. The matrix is
+   factorized once by dgbtrftridiag; each step is one dgbtrs. */
+typedef struct {
+  int la;
+  double dt;
+  double r;         /* dt/h^2 */
+  double bc[2];     /* r*T0, r*T1 */
+  double *LU;       /* factors of I + r A, lab = 4, kv = 1 */
+  int *ipiv;
+} heat_ie_plan;
+int heat_ie_plan_create(heat_ie_plan *p, int *la, double *dt, double *T0, double *T1);
+void heat_ie_plan_free(heat_ie_plan *p);
+void heat_ie_step(heat_ie_plan *p, double *U, int *nsteps);
+/* Parareal over nslices time slices: nfine steps of 'fine' or ncoarse steps of
+   'coarse' per slice. U holds (nslices+1) states of size la, U[0..la-1] being
+   the initial one; on return U[n*la..] is the state at the end of slice n.
+   The fine propagations of an iteration run on nthreads OpenMP threads.
+   resvec[k] = max change of the slice states at iteration k relative to their
+   max norm; stops below tol or after maxk (<= nslices) iterations, after
+   which U equals sequential stepping. */
+int heat_parareal(heat_ie_plan *fine, heat_ie_plan *coarse, int *nslices, int *nfine, int *ncoarse,
+                  double *U, double *tol, int *maxk, int *nthreads, double *resvec, int *nbite);
+
+/* Variable conductivity -(kappa u')', scaled by h^2: kappa has la+1 edge
+   values, kappa[e] between nodes e-1 and e (kappa[0], kappa[la] at the ends) */
+void set_GB_operator_colMajor_conductivity(double* AB, int *lab, int *la, int *kv, double *kappa);
+void set_dense_RHS_DBC_conductivity(double* RHS, int* la, double *kappa, double* BC0, double* BC1);
+
+/* Low-rank re-solves: A = A0 + W D W^T on top of the dgbtrf factors of A0.
+   A conductivity change on one edge or a diagonal change on one node is a
+   rank-1 term; each new term costs one band solve (a column of Z = A0^-1 W)
+   and each solve adds k axpys and a k x k capacitance solve. Past kmax terms
+   (or on a singular capacitance) the current operator is refactorized. */
+#define P1D_LOWRANK_KMAX 8
+typedef struct {
+  int la;
+  int kmax;
+  int k;            /* rank-1 terms since the last factorization */
+  int nupdate;
+  int nrefactor;
+  double *AB;       /* current operator, lab = 4, kv = 1 */
+  double *LU;       /* dgbtrf factors of A0 */
+  int *ipiv;
+  int *wi;          /* w_a = e_wi[2a] - e_wi[2a+1] (second index -1: none) */
+  double *d;        /* weights D */
+  double *Z;        /* A0^-1 W, la x kmax */
+  double *C;        /* dgetrf factors of I + D W^T Z, k x k */
+  int *cpiv;
+  double *work;
+} p1d_lowrank;
+/* AB in any band layout with ku = kl = 1; kmax <= 0 selects P1D_LOWRANK_KMAX */
+int p1d_lowrank_init(p1d_lowrank *lr, double *AB, int *lab, int *la, int *kv, int *kmax);
+void p1d_lowrank_free(p1d_lowrank *lr);
+int p1d_lowrank_refactor(p1d_lowrank *lr);
+/* kappa[edge] += dkappa, 0 <= edge <= la */
+int p1d_lowrank_update_edge(p1d_lowrank *lr, int *edge, double *dkappa);
+/* A(i,i) += dsigma */
+int p1d_lowrank_update_diag(p1d_lowrank *lr, int *i, double *dsigma);
+/* In place, nrhs right-hand sides of size la */
+int p1d_lowrank_solve(p1d_lowrank *lr, double *RHS, int *nrhs);
+
+/* Compressed snapshots (.p1z). Lossy mode (eb > 0): values quantized to
+   multiples of 2 eb (|error| <= eb, checked; chunks that cannot honour it are
+   stored raw), second-order prediction on the integers, zigzag residuals
+   bit-packed per block of 64 at the block's width. Lossless mode (eb = 0):
+   XOR with the previous value, only the significant bits are kept (residual
+   histories). Chunks of 'chunk' values are coded independently, in parallel,
+   and located through an offset table, so any range decodes on its own. */
+#define P1Z_LOSSY 0
+#define P1Z_LOSSLESS 1
+#define P1Z_CHUNK 4096
+typedef struct {
+  FILE *file;
+  int mode;
+  int chunk;
+  int nchunks;
+  long long n;
+  double eb;
+  long data;                   /* file offset of the first chunk */
+  unsigned long long *off;     /* nchunks+1 chunk offsets from data */
+} p1z_reader;
+/* chunk <= 0 selects P1Z_CHUNK */
+int p1z_write(double *vec, long long n, double eb, int chunk, char *filename);
+int p1z_open(p1z_reader *r, char *filename);
+int p1z_read(p1z_reader *r, long long i0, long long n, double *out);
+void p1z_close(p1z_reader *r);
+/* Output mode of write_vec / write_vec_history: POISSON1D_COMPRESS=<eb> or
+   lossless; returns 0 (plain text) when unset */
+int poisson1D_compress_eb(double *eb);
+void write_vec_history(double* vec, int* la, char* filename);
+
+/* Extreme eigenvalues of a symmetric tridiagonal operator (any band layout
+   with kl = ku = 1, diagonal on row lab-2), of A or, with
+   KRYLOV_PREC_JACOBI, of D^-1 A, by m Lanczos steps from a fixed start
+   vector. theta_* are the extreme Ritz values and res_* their Kaniel-Paige
+   residual bounds; lmin = theta_min (never below the true lambda_min) and
+   lmax = theta_max + res_max, so the step parameters stay convergent. */
+#define SPECTRUM_M 40
+#define SPECTRUM_CACHE_SIZE 16
+typedef struct {
+  double lmin, lmax;           /* estimates used for the step parameters */
+  double theta_min, theta_max;
+  double res_min, res_max;
+  int nmatvec;
+  int cached;                  /* 1 if returned by the cache */
+} p1d_spectrum;
+/* Returns 0, -1 (allocation, non-positive diagonal with KRYLOV_PREC_JACOBI)
+   or SPECTRUM_ENONSYM when A(i+1,i) != A(i,i+1): Lanczos needs a symmetric AB */
+#define SPECTRUM_ENONSYM -2
+int spectrum_lanczos_tridiag(double *AB, int *lab, int *la, int prec, int *m, p1d_spectrum *spec);
+/* Estimate with SPECTRUM_M steps, cached per operator (size, preconditioner
+   and hash of the three diagonals); thread-safe */
+int spectrum_get(double *AB, int *lab, int *la, int prec, p1d_spectrum *spec);
+void spectrum_cache_clear(void);
+/* 2/(lmin + lmax) for any symmetric positive definite tridiagonal AB,
+   0 if AB is not symmetric */
+double richardson_alpha_auto(double *AB, int *lab, int *la);
+/* Step used by richardson_MB: 2/(lmin + lmax) of D^-1 A (spectrum_get with
+   KRYLOV_PREC_JACOBI) when MB = D, 1 for any other splitting (Gauss-Seidel) */
+double richardson_MB_alpha(double *AB, double *MB, int *lab, int *la, int *kl);
+/* Chebyshev iteration on [lmin, lmax] of spectrum_get, prec KRYLOV_PREC_NONE
+   or KRYLOV_PREC_JACOBI; resvec[0..nbite] are ||b - Ax||/||b||. Returns the
+   spectrum_get error, X untouched, when no estimate is available */
+int chebyshev_tridiag(double *AB, double *RHS, double *X, int *lab, int *la, int prec,
+                      double *tol, int *maxit, double *resvec, int *nbite);
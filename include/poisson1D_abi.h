@@ -0,0 +1,54 @@
+/**********************************************/
+/* poisson1D_abi.h                            */
+/* Stable C ABI of lib_poisson1D: plain       */
+/* values and caller-owned arrays, no BLAS    */
+/* headers, for bindings (Python, ...)        */
+/**********************************************/
+#ifndef POISSON1D_ABI_H
+#define POISSON1D_ABI_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Bumped on any incompatible change of the functions below */
+#define P1D_ABI_VERSION 1
+
+/* Solvers; also the index of the timing counters */
+#define P1D_ABI_DIRECT 0         /* dgbsv */
+#define P1D_ABI_RICHARDSON 1     /* optimal alpha */
+#define P1D_ABI_JACOBI 2
+#define P1D_ABI_GAUSS_SEIDEL 3
+#define P1D_ABI_NSOLVER 4
+
+/* Status codes: 0 on success */
+#define P1D_ABI_EINVAL -1
+#define P1D_ABI_ENOMEM -2
+#define P1D_ABI_ESOLVE -3
+
+int p1d_abi_version(void);
+
+/* Dirichlet problem -u'' = 0, u(0) = t0, u(1) = t1 on la interior points */
+int p1d_abi_grid(int la, double *x);
+int p1d_abi_rhs_dirichlet(int la, double t0, double t1, double *rhs);
+int p1d_abi_exact_dirichlet(int la, double t0, double t1, const double *x, double *u);
+
+/* sol = A^-1 rhs for the [-1 2 -1] operator */
+int p1d_abi_solve_direct(int la, const double *rhs, double *sol);
+
+/* Iterative solve of A sol = rhs from the initial guess in sol. resvec holds
+   maxit+1 values and receives the residual history; *nbite the number of
+   iterations. nthreads applies to Richardson and Jacobi (thread team). */
+int p1d_abi_solve_iter(int method, int la, const double *rhs, double *sol, double tol, int maxit,
+                       int nthreads, double *resvec, int *nbite);
+
+/* Cumulated counters of the solver entry points: number of calls, total and
+   last wall-clock time in seconds. Safe to call from any thread. */
+int p1d_abi_timing(int method, long long *ncalls, double *total_s, double *last_s);
+void p1d_abi_timing_reset(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
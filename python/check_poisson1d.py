@@ -0,0 +1,76 @@
+"""Checks of the poisson1d module: zero-copy outputs, accuracy against the
+analytical solution, concurrent solves with the GIL released, counters.
+Works with array.array when NumPy is not installed."""
+import array
+import sys
+import threading
+
+import poisson1d as p
+
+T0, T1 = -5.0, 5.0
+fail = 0
+
+
+def check(name, ok):
+    global fail
+    print("%-40s %s" % (name, "ok" if ok else "ECHEC"))
+    if not ok:
+        fail = 1
+
+
+def zeros(n):
+    return array.array("d", bytes(8 * n))
+
+
+la = 200
+x = p.grid(la)
+rhs = p.rhs_dirichlet(la, T0, T1)
+ex = p.exact_dirichlet(x, T0, T1)
+
+# Sortie fournie : même objet, rempli en place
+out = zeros(la)
+res = p.solve_direct(rhs, out=out)
+check("solve_direct, sortie en place", res is out)
+check("solve_direct, erreur", max(abs(a - b) for a, b in zip(out, ex)) < 1e-10)
+
+# Itératifs : historique des résidus et nombre d'itérations
+for name, m in (("richardson", p.RICHARDSON), ("jacobi", p.JACOBI),
+                ("gauss_seidel", p.GAUSS_SEIDEL)):
+    sol = zeros(la)
+    rv = zeros(100001)
+    s, hist, nbite = p.solve_iter(m, rhs, x=sol, tol=1e-6, maxit=100000, threads=2, resvec=rv)
+    check(name + ", sortie en place", s is sol)
+    check(name + ", convergence", 0 < nbite < 100000 and len(hist) == nbite + 1
+          and hist[-1] <= 1e-6 and rv[nbite] == hist[-1])
+
+# Résolutions concurrentes (GIL relâché) : résultats identiques au séquentiel
+ref = p.solve_iter(p.JACOBI, rhs, tol=1e-5, maxit=100000)[0]
+outs = [zeros(la) for _ in range(4)]
+ths = [threading.Thread(target=p.solve_iter, args=(p.JACOBI, rhs),
+                        kwargs=dict(x=o, tol=1e-5, maxit=100000)) for o in outs]
+for t in ths:
+    t.start()
+for t in ths:
+    t.join()
+check("threads, résultats identiques", all(list(o) == list(ref) for o in outs))
+
+# Erreurs : type et taille des tableaux
+try:
+    p.solve_direct(array.array("f", [1.0] * la))
+    check("float32 refusé", False)
+except TypeError:
+    check("float32 refusé", True)
+try:
+    p.solve_direct(rhs, out=zeros(la - 1))
+    check("taille de sortie vérifiée", False)
+except ValueError:
+    check("taille de sortie vérifiée", True)
+
+# Compteurs
+t = p.timing()
+check("compteurs", t["direct"]["calls"] == 1 and t["jacobi"]["calls"] == 6
+      and t["jacobi"]["total_s"] > 0.0)
+p.timing_reset()
+check("remise à zéro", all(v["calls"] == 0 for v in p.timing().values()))
+
+sys.exit(fail)
@@ -0,0 +1,287 @@
+/**********************************************/
+/* poisson1dmodule.c                          */
+/* Python extension over poisson1D_abi.h:     */
+/* arrays exchanged through the buffer        */
+/* protocol without copy, GIL released        */
+/* during the solves                          */
+/**********************************************/
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include <string.h>
+#include "poisson1D_abi.h"
+
+/* Tableau float64 contigu, écrivable ou non, vu sans copie */
+static int get_vec(PyObject *obj, Py_buffer *view, int writable, const char *name){
+  int flags = PyBUF_C_CONTIGUOUS | PyBUF_FORMAT | (writable ? PyBUF_WRITABLE : 0);
+  const char *f;
+  if (PyObject_GetBuffer(obj, view, flags) != 0) return -1;
+  f = view->format;
+  if (f != NULL && (f[0] == '<' || f[0] == '=' || f[0] == '@')) f++;
+  if (view->itemsize != sizeof(double) || f == NULL || strcmp(f, "d") != 0){
+    PyErr_Format(PyExc_TypeError, "%s: float64 contiguous buffer expected", name);
+    PyBuffer_Release(view);
+    return -1;
+  }
+  return 0;
+}
+
+/* Nouveau tableau de n float64 : numpy.empty si NumPy est installé,
+   array('d') sinon */
+static PyObject *new_vec(Py_ssize_t n){
+  PyObject *mod, *res = NULL;
+  mod = PyImport_ImportModule("numpy");
+  if (mod != NULL){
+    res = PyObject_CallMethod(mod, "empty", "n", n);
+    Py_DECREF(mod);
+    return res;
+  }
+  PyErr_Clear();
+  mod = PyImport_ImportModule("array");
+  if (mod == NULL) return NULL;
+  res = PyObject_CallMethod(mod, "array", "s", "d");
+  if (res != NULL && n > 0){
+    PyObject *zeros = PyBytes_FromStringAndSize(NULL, n*(Py_ssize_t) sizeof(double));
+    PyObject *r;
+    if (zeros == NULL){
+      Py_DECREF(res);
+      Py_DECREF(mod);
+      return NULL;
+    }
+    memset(PyBytes_AS_STRING(zeros), 0, n*sizeof(double));
+    r = PyObject_CallMethod(res, "frombytes", "O", zeros);
+    Py_DECREF(zeros);
+    if (r == NULL){
+      Py_CLEAR(res);
+    } else {
+      Py_DECREF(r);
+    }
+  }
+  Py_DECREF(mod);
+  return res;
+}
+
+/* out fourni : vérifié et renvoyé tel quel ; sinon alloué */
+static PyObject *out_vec(PyObject *out, Py_ssize_t n, Py_buffer *view){
+  PyObject *res;
+  if (out == NULL || out == Py_None){
+    res = new_vec(n);
+    if (res == NULL) return NULL;
+  } else {
+    res = out;
+    Py_INCREF(res);
+  }
+  if (get_vec(res, view, 1, "out") != 0){
+    Py_DECREF(res);
+    return NULL;
+  }
+  if (view->len/(Py_ssize_t) sizeof(double) != n){
+    PyErr_Format(PyExc_ValueError, "out: %zd values expected", n);
+    PyBuffer_Release(view);
+    Py_DECREF(res);
+    return NULL;
+  }
+  return res;
+}
+
+static PyObject *abi_error(int status){
+  if (status == P1D_ABI_ENOMEM) return PyErr_NoMemory();
+  if (status == P1D_ABI_EINVAL) PyErr_SetString(PyExc_ValueError, "invalid argument");
+  else PyErr_Format(PyExc_RuntimeError, "solver failed (status %d)", status);
+  return NULL;
+}
+
+static PyObject *py_grid(PyObject *self, PyObject *args, PyObject *kw){
+  static char *kwlist[] = {"la", "out", NULL};
+  Py_ssize_t la;
+  PyObject *out = NULL, *res;
+  Py_buffer v;
+  (void) self;
+  if (!PyArg_ParseTupleAndKeywords(args, kw, "n|O", kwlist, &la, &out)) return NULL;
+  if (la < 1 || la > INT_MAX) return abi_error(P1D_ABI_EINVAL);
+  if ((res = out_vec(out, la, &v)) == NULL) return NULL;
+  p1d_abi_grid((int) la, (double *) v.buf);
+  PyBuffer_Release(&v);
+  return res;
+}
+
+static PyObject *py_rhs_dirichlet(PyObject *self, PyObject *args, PyObject *kw){
+  static char *kwlist[] = {"la", "t0", "t1", "out", NULL};
+  Py_ssize_t la;
+  double t0, t1;
+  PyObject *out = NULL, *res;
+  Py_buffer v;
+  (void) self;
+  if (!PyArg_ParseTupleAndKeywords(args, kw, "ndd|O", kwlist, &la, &t0, &t1, &out)) return NULL;
+  if (la < 1 || la > INT_MAX) return abi_error(P1D_ABI_EINVAL);
+  if ((res = out_vec(out, la, &v)) == NULL) return NULL;
+  p1d_abi_rhs_dirichlet((int) la, t0, t1, (double *) v.buf);
+  PyBuffer_Release(&v);
+  return res;
+}
+
+static PyObject *py_exact_dirichlet(PyObject *self, PyObject *args, PyObject *kw){
+  static char *kwlist[] = {"x", "t0", "t1", "out", NULL};
+  double t0, t1;
+  PyObject *x, *out = NULL, *res;
+  Py_buffer vx, v;
+  Py_ssize_t n;
+  (void) self;
+  if (!PyArg_ParseTupleAndKeywords(args, kw, "Odd|O", kwlist, &x, &t0, &t1, &out)) return NULL;
+  if (get_vec(x, &vx, 0, "x") != 0) return NULL;
+  n = vx.len/(Py_ssize_t) sizeof(double);
+  if (n < 1 || n > INT_MAX || (res = out_vec(out, n, &v)) == NULL){
+    PyBuffer_Release(&vx);
+    return (n < 1 || n > INT_MAX) ? abi_error(P1D_ABI_EINVAL) : NULL;
+  }
+  p1d_abi_exact_dirichlet((int) n, t0, t1, (const double *) vx.buf, (double *) v.buf);
+  PyBuffer_Release(&v);
+  PyBuffer_Release(&vx);
+  return res;
+}
+
+static PyObject *py_solve_direct(PyObject *self, PyObject *args, PyObject *kw){
+  static char *kwlist[] = {"rhs", "out", NULL};
+  PyObject *rhs, *out = NULL, *res;
+  Py_buffer vb, v;
+  Py_ssize_t n;
+  int status;
+  (void) self;
+  if (!PyArg_ParseTupleAndKeywords(args, kw, "O|O", kwlist, &rhs, &out)) return NULL;
+  if (get_vec(rhs, &vb, 0, "rhs") != 0) return NULL;
+  n = vb.len/(Py_ssize_t) sizeof(double);
+  if (n < 1 || n > INT_MAX || (res = out_vec(out, n, &v)) == NULL){
+    PyBuffer_Release(&vb);
+    return (n < 1 || n > INT_MAX) ? abi_error(P1D_ABI_EINVAL) : NULL;
+  }
+  Py_BEGIN_ALLOW_THREADS
+  status = p1d_abi_solve_direct((int) n, (const double *) vb.buf, (double *) v.buf);
+  Py_END_ALLOW_THREADS
+  PyBuffer_Release(&v);
+  PyBuffer_Release(&vb);
+  if (status != 0){
+    Py_DECREF(res);
+    return abi_error(status);
+  }
+  return res;
+}
+
+/* solve_iter(method, rhs, x=None, tol=1e-3, maxit=1000, threads=1, resvec=None)
+   -> (x, resvec[:nbite+1], nbite) ; x est à la fois l'initialisation et le
+   résultat, modifié en place s'il est fourni */
+static PyObject *py_solve_iter(PyObject *self, PyObject *args, PyObject *kw){
+  static char *kwlist[] = {"method", "rhs", "x", "tol", "maxit", "threads", "resvec", NULL};
+  PyObject *rhs, *x = NULL, *rv = NULL, *xres, *rvres, *hist, *ret;
+  Py_buffer vb, vx, vr;
+  double tol = 1e-3;
+  int method, maxit = 1000, nthreads = 1, nbite = 0, status;
+  Py_ssize_t n;
+  (void) self;
+  if (!PyArg_ParseTupleAndKeywords(args, kw, "iO|OdiiO", kwlist, &method, &rhs, &x, &tol, &maxit, &nthreads, &rv)) return NULL;
+  if (maxit < 0 || nthreads < 1) return abi_error(P1D_ABI_EINVAL);
+  if (get_vec(rhs, &vb, 0, "rhs") != 0) return NULL;
+  n = vb.len/(Py_ssize_t) sizeof(double);
+  if (n < 1 || n > INT_MAX){
+    PyBuffer_Release(&vb);
+    return abi_error(P1D_ABI_EINVAL);
+  }
+  if ((xres = out_vec(x, n, &vx)) == NULL){
+    PyBuffer_Release(&vb);
+    return NULL;
+  }
+  if (x == NULL || x == Py_None) memset(vx.buf, 0, n*sizeof(double));
+  if ((rvres = out_vec(rv, (Py_ssize_t) maxit + 1, &vr)) == NULL){
+    PyBuffer_Release(&vx);
+    PyBuffer_Release(&vb);
+    Py_DECREF(xres);
+    return NULL;
+  }
+  Py_BEGIN_ALLOW_THREADS
+  status = p1d_abi_solve_iter(method, (int) n, (const double *) vb.buf, (double *) vx.buf, tol, maxit,
+                              nthreads, (double *) vr.buf, &nbite);
+  Py_END_ALLOW_THREADS
+  PyBuffer_Release(&vr);
+  PyBuffer_Release(&vx);
+  PyBuffer_Release(&vb);
+  if (status != 0){
+    Py_DECREF(xres);
+    Py_DECREF(rvres);
+    return abi_error(status);
+  }
+  // Vue sur l'historique utile (sans copie pour NumPy)
+  hist = PySequence_GetSlice(rvres, 0, (Py_ssize_t) nbite + 1);
+  Py_DECREF(rvres);
+  if (hist == NULL){
+    Py_DECREF(xres);
+    return NULL;
+  }
+  ret = Py_BuildValue("(NNi)", xres, hist, nbite);
+  return ret;
+}
+
+static PyObject *py_timing(PyObject *self, PyObject *noargs){
+  static const char *names[P1D_ABI_NSOLVER] = {"direct", "richardson", "jacobi", "gauss_seidel"};
+  PyObject *d = PyDict_New();
+  int m;
+  (void) self;
+  (void) noargs;
+  if (d == NULL) return NULL;
+  for (m=0;m<P1D_ABI_NSOLVER;m++){
+    long long nc;
+    double tot, last;
+    PyObject *t;
+    p1d_abi_timing(m, &nc, &tot, &last);
+    t = Py_BuildValue("{s:L,s:d,s:d}", "calls", nc, "total_s", tot, "last_s", last);
+    if (t == NULL || PyDict_SetItemString(d, names[m], t) != 0){
+      Py_XDECREF(t);
+      Py_DECREF(d);
+      return NULL;
+    }
+    Py_DECREF(t);
+  }
+  return d;
+}
+
+static PyObject *py_timing_reset(PyObject *self, PyObject *noargs){
+  (void) self;
+  (void) noargs;
+  p1d_abi_timing_reset();
+  Py_RETURN_NONE;
+}
+
+static PyMethodDef poisson1d_methods[] = {
+  {"grid", (PyCFunction)(void(*)(void)) py_grid, METH_VARARGS | METH_KEYWORDS,
+   "grid(la, out=None): interior grid points"},
+  {"rhs_dirichlet", (PyCFunction)(void(*)(void)) py_rhs_dirichlet, METH_VARARGS | METH_KEYWORDS,
+   "rhs_dirichlet(la, t0, t1, out=None): right-hand side of the Dirichlet problem"},
+  {"exact_dirichlet", (PyCFunction)(void(*)(void)) py_exact_dirichlet, METH_VARARGS | METH_KEYWORDS,
+   "exact_dirichlet(x, t0, t1, out=None): analytical solution on x"},
+  {"solve_direct", (PyCFunction)(void(*)(void)) py_solve_direct, METH_VARARGS | METH_KEYWORDS,
+   "solve_direct(rhs, out=None): dgbsv solve of the [-1 2 -1] system"},
+  {"solve_iter", (PyCFunction)(void(*)(void)) py_solve_iter, METH_VARARGS | METH_KEYWORDS,
+   "solve_iter(method, rhs, x=None, tol=1e-3, maxit=1000, threads=1, resvec=None)\n"
+   "-> (x, residual history, iterations); x is updated in place when given"},
+  {"timing", py_timing, METH_NOARGS, "timing(): calls and wall-clock time per solver"},
+  {"timing_reset", py_timing_reset, METH_NOARGS, "timing_reset(): zero the counters"},
+  {NULL, NULL, 0, NULL}
+};
+
+static struct PyModuleDef poisson1d_module = {
+  PyModuleDef_HEAD_INIT, "poisson1d",
+  "Zero-copy bindings of lib_poisson1D (C ABI of poisson1D_abi.h)", -1, poisson1d_methods,
+  NULL, NULL, NULL, NULL
+};
+
+PyMODINIT_FUNC PyInit_poisson1d(void){
+  PyObject *m = PyModule_Create(&poisson1d_module);
+  if (m == NULL) return NULL;
+  if (p1d_abi_version() != P1D_ABI_VERSION){
+    PyErr_SetString(PyExc_ImportError, "lib_poisson1D ABI version mismatch");
+    Py_DECREF(m);
+    return NULL;
+  }
+  PyModule_AddIntConstant(m, "ABI_VERSION", P1D_ABI_VERSION);
+  PyModule_AddIntConstant(m, "RICHARDSON", P1D_ABI_RICHARDSON);
+  PyModule_AddIntConstant(m, "JACOBI", P1D_ABI_JACOBI);
+  PyModule_AddIntConstant(m, "GAUSS_SEIDEL", P1D_ABI_GAUSS_SEIDEL);
+  return m;
+}
@@ -38,6 +38,21 @@ void set_GB_operator_colMajor_poisson1D(double* AB, int* lab, int* la, int* kv)
     }
 }
 
+void set_GB_operator_colMajor_poisson1D_quiet(double* AB, int *lab, int *la, int *kv){
+  int ii, jj, kk;
+  // Même opérateur que set_GB_operator_colMajor_poisson1D, sans affichage
+  // (utilisé pour les grandes tailles)
+  for (jj=0;jj<(*la);jj++){
+    kk = jj*(*lab);
+    for (ii=0;ii<(*lab);ii++){
+      AB[kk+ii]=0.0;
+    }
+    if (jj > 0) AB[kk+ *kv]=-1.0;
+    AB[kk+ *kv+1]=2.0;
+    if (jj < (*la)-1) AB[kk+ *kv+2]=-1.0;
+  }
+}
+
 void set_GB_operator_colMajor_poisson1D_DGBMV(double* AB, int *lab, int *la, int *kv){
   int ii, jj, kk;
   // Initialisation à 0
@@ -72,11 +87,12 @@ void set_GB_operator_colMajor_poisson1D_Id(double* AB, int *lab, int *la, int *k
 
 void set_dense_RHS_DBC_1D(double* RHS, int* la, double* BC0, double* BC1){
   int jj;
-  RHS[0]= *BC0;
-  RHS[(*la)-1]= *BC1;
-  for (jj=1;jj<(*la)-1;jj++){
+  for (jj=0;jj<(*la);jj++){
     RHS[jj]=0.0;
   }
+  // Cumul : pour la = 1, les deux conditions portent sur le même point
+  RHS[0] += *BC0;
+  RHS[(*la)-1] += *BC1;
 }  
 
 void set_analytical_solution_DBC_1D(double* EX_SOL, double* X, int* la, double* BC0, double* BC1){
@@ -98,21 +114,15 @@ void set_grid_points_1D(double* x, int* la){
 }
 
 double relative_forward_error(double* x, double* y, int* la){
-    double norm_diff = 0.0;
-    double norm_y = 0.0;
-    int i;
-    
-    // Calcul de ||x-y|| et ||y||
-    for(i = 0; i < *la; i++){
-        norm_diff += (x[i] - y[i]) * (x[i] - y[i]);
-        norm_y += y[i] * y[i];
-    }
+    // Calcul de ||x-y|| et ||y|| (réductions compensées reproductibles)
+    double norm_diff = nrm2_diff_repro(la, x, y);
+    double norm_y = nrm2_repro(la, y);
     
     // Éviter la division par zéro
-    if(norm_y < 1e-15) return 0.0;
+    if(norm_y * norm_y < 1e-15) return 0.0;
     
     // Calcul de l'erreur relative ||x-y|| / ||y||
-    return sqrt(norm_diff) / sqrt(norm_y);
+    return norm_diff / norm_y;
 }
 
 int indexABCol(int i, int j, int* lab) {
@@ -127,13 +137,6 @@ int dgbtrftridiag(int* la, int* n, int* kl, int* ku, double* AB, int* lab, int*
     int result_matrix_size = *n;
     int kv = 1; 
 
-    printf("\nDébut dgbtrftridiag:\n");
-    printf("nb_lines (lab) = %d\n", nb_lines);
-    printf("nb_cols (la) = %d\n", nb_cols);
-    printf("upper_diags (ku) = %d\n", upper_diags);
-    printf("lower_diags (kl) = %d\n", lower_diags);
-    printf("result_matrix_size (n) = %d\n", result_matrix_size);
-
     // Vérification des dimensions
     if (nb_lines != 4 || lower_diags != 1 || upper_diags != 1 || nb_cols < result_matrix_size) {
         printf("Erreur: dimensions incorrectes\n");
@@ -141,11 +144,13 @@ int dgbtrftridiag(int* la, int* n, int* kl, int* ku, double* AB, int* lab, int*
         return *info;
     }
 
-    // Pour une matrice tridiagonale au format bande:
-    // - ligne 0: zéros (non utilisé)
-    // - ligne 1: sous-diagonale (l)
-    // - ligne 2: diagonale (u)
-    // - ligne 3: sur-diagonale
+    // Pour une matrice tridiagonale au format bande LAPACK (kv = 1),
+    // A(i,j) = AB[j*lab + kv+ku+i-j] :
+    // - ligne 0: zéros (réservée au pivotage, non utilisée)
+    // - ligne 1: sur-diagonale A(j-1,j)
+    // - ligne 2: diagonale, puis U
+    // - ligne 3: sous-diagonale A(j+1,j), puis les multiplicateurs de L
+    //   (convention attendue par dgbtrs)
 
     // Factorisation LU
     for (int k = 0; k < result_matrix_size - 1; k++) {
@@ -158,11 +163,11 @@ int dgbtrftridiag(int* la, int* n, int* kl, int* ku, double* AB, int* lab, int*
         // Calcul du multiplicateur
         double l = AB[k * nb_lines + 3] / AB[k * nb_lines + 2];
         
-        // Stockage du multiplicateur dans la sous-diagonale
-        AB[(k+1) * nb_lines + 1] = l;
+        // Stockage du multiplicateur à la place de A(k+1,k)
+        AB[k * nb_lines + 3] = l;
         
-        // Mise à jour de la diagonale suivante
-        AB[(k+1) * nb_lines + 2] = AB[(k+1) * nb_lines + 2] - l * AB[k * nb_lines + 3];
+        // Mise à jour de la diagonale suivante : A(k+1,k+1) -= l * A(k,k+1)
+        AB[(k+1) * nb_lines + 2] = AB[(k+1) * nb_lines + 2] - l * AB[(k+1) * nb_lines + 1];
     }
 
     // Vérification du dernier pivot
@@ -292,9 +297,9 @@ int test_dgbtrftridiag(void) {
                         // Calcul de (LU)_{ij}
                         for(int k = 0; k <= i && k <= j; k++) {
                             double l_ik = (i == k) ? 1.0 : 
-                                        (i == k+1) ? AB[(k+1)*lab + kv] : 0.0;
+                                        (i == k+1) ? AB[k*lab + kv + 2] : 0.0;
                             double u_kj = (k == j) ? AB[k*lab + kv + 1] :
-                                        (k == j-1) ? AB[k*lab + kv + 2] : 0.0;
+                                        (k == j-1) ? AB[j*lab + kv] : 0.0;
                             sum += l_ik * u_kj;
                         }
                         // Comparaison avec la matrice originale
@@ -327,43 +332,41 @@ int test_dgbtrftridiag(void) {
     return valid;
 }
 
+double jacobi_tridiag_step(double *AB, double *RHS, double *X, double *X_new, int *lab, int *la) {
+    double resid;
+
+    // Mise à jour de X selon la méthode de Jacobi
+    for(int i = 0; i < *la; i++) {
+        double diag = AB[(*lab)*i + 1];
+        X_new[i] = RHS[i];
+        
+        // A(i,i-1) est stockée dans la colonne i-1, A(i,i+1) dans la colonne i+1
+        if(i > 0) X_new[i] -= AB[(*lab)*(i-1) + 2] * X[i-1];
+        if(i < *la-1) X_new[i] -= AB[(*lab)*(i+1) + 0] * X[i+1];
+        
+        X_new[i] /= diag;
+    }
+    
+    // Calcul du résidu
+    resid = nrm2_diff_repro(la, X_new, X);
+    
+    // Mise à jour de X pour la prochaine itération
+    for(int i = 0; i < *la; i++) {
+        X[i] = X_new[i];
+    }
+    return resid;
+}
+
 void jacobi_tridiag(double *AB, double *RHS, double *X, int *lab, int *la, int *ku, int *kl, double *tol, int *maxit, double *resvec, int *nbite) {
     // Allocation des vecteurs temporaires
     double *X_new = (double *)malloc(sizeof(double)*(*la));
-    double *AX = (double *)malloc(sizeof(double)*(*la));
-    int kv = 1;  
     
     int iter = 0;
     double resid = 1.0;
     resvec[0] = 1.0;
     
     while(iter < *maxit && resid > *tol) {
-        // Calcul de AX = AB*X
-        dgbmv_poisson1D(AB, X, AX, la, lab, ku, kl, &kv);
-        
-        // Mise à jour de X selon la méthode de Jacobi
-        for(int i = 0; i < *la; i++) {
-            double diag = AB[(*lab)*i + 1];
-            X_new[i] = RHS[i];
-            
-            if(i > 0) X_new[i] -= AB[(*lab)*i + 0] * X[i-1];
-            if(i < *la-1) X_new[i] -= AB[(*lab)*i + 2] * X[i+1];
-            
-            X_new[i] /= diag;
-        }
-        
-        // Calcul du résidu
-        resid = 0.0;
-        for(int i = 0; i < *la; i++) {
-            double diff = X_new[i] - X[i];
-            resid += diff * diff;
-        }
-        resid = sqrt(resid);
-        
-        // Mise à jour de X pour la prochaine itération
-        for(int i = 0; i < *la; i++) {
-            X[i] = X_new[i];
-        }
+        resid = jacobi_tridiag_step(AB, RHS, X, X_new, lab, la);
         
         iter++;
         resvec[iter] = resid;
@@ -377,48 +380,44 @@ void jacobi_tridiag(double *AB, double *RHS, double *X, int *lab, int *la, int *
     
     // Libération de la mémoire
     free(X_new);
-    free(AX);
+}
+
+double gauss_seidel_tridiag_step(double *AB, double *RHS, double *X, double *AX, int *lab, int *la, int *ku, int *kl) {
+    int kv = 1;
+
+    // Mise à jour de X selon Gauss-Seidel
+    for(int i = 0; i < *la; i++) {
+        double sum = RHS[i];  // bi
+        
+        // Soustraction des termes déjà calculés (partie E)
+        if(i > 0) {
+            sum -= AB[(*lab)*(i-1) + 2] * X[i-1];  
+        }
+        
+        // Soustraction des termes non encore calculés (partie F)
+        if(i < *la-1) {
+            sum -= AB[(*lab)*(i+1) + 0] * X[i+1];  
+        }
+        
+        // Division par l'élément diagonal
+        X[i] = sum / AB[(*lab)*i + 1];
+    }
+    
+    // Calcul du résidu
+    dgbmv_poisson1D(AB, X, AX, la, lab, ku, kl, &kv);
+    return nrm2_diff_repro(la, RHS, AX);
 }
 
 void gauss_seidel_tridiag(double *AB, double *RHS, double *X, int *lab, int *la, int *ku, int *kl, double *tol, int *maxit, double *resvec, int *nbite) {
     // Allocation des vecteurs temporaires
     double *AX = (double *)malloc(sizeof(double)*(*la));
-    int kv = 1;
     
     int iter = 0;
     double resid = 1.0;
     resvec[0] = 1.0;
     
     while(iter < *maxit && resid > *tol) {
-        // Calcul de AX = AB*X pour le résidu
-        dgbmv_poisson1D(AB, X, AX, la, lab, ku, kl, &kv);
-        
-        // Mise à jour de X selon Gauss-Seidel
-        for(int i = 0; i < *la; i++) {
-            double sum = RHS[i];  // bi
-            
-            // Soustraction des termes déjà calculés (partie E)
-            if(i > 0) {
-                sum -= AB[(*lab)*i + 0] * X[i-1];  
-            }
-            
-            // Soustraction des termes non encore calculés (partie F)
-            if(i < *la-1) {
-                sum -= AB[(*lab)*i + 2] * X[i+1];  
-            }
-            
-            // Division par l'élément diagonal
-            X[i] = sum / AB[(*lab)*i + 1];
-        }
-        
-        // Calcul du résidu
-        resid = 0.0;
-        dgbmv_poisson1D(AB, X, AX, la, lab, ku, kl, &kv);
-        for(int i = 0; i < *la; i++) {
-            double diff = RHS[i] - AX[i];
-            resid += diff * diff;
-        }
-        resid = sqrt(resid);
+        resid = gauss_seidel_tridiag_step(AB, RHS, X, AX, lab, la, ku, kl);
         
         iter++;
         resvec[iter] = resid;
@@ -0,0 +1,138 @@
+/**********************************************/
+/* lib_poisson1D_abi.c                        */
+/* Stable C ABI over the library: argument    */
+/* checks, no output, timing counters         */
+/**********************************************/
+#include "lib_poisson1D.h"
+#include "poisson1D_abi.h"
+#include <time.h>
+
+typedef struct {
+  long long ncalls;
+  double total;
+  double last;
+} abi_counter;
+
+static abi_counter counters[P1D_ABI_NSOLVER];
+static pthread_mutex_t counters_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static double abi_wtime(void){
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + 1e-9*ts.tv_nsec;
+}
+
+/* Les appels peuvent venir de plusieurs threads (GIL relâché côté Python) */
+static void abi_count(int method, double t){
+  pthread_mutex_lock(&counters_lock);
+  counters[method].ncalls++;
+  counters[method].total += t;
+  counters[method].last = t;
+  pthread_mutex_unlock(&counters_lock);
+}
+
+int p1d_abi_version(void){
+  return P1D_ABI_VERSION;
+}
+
+int p1d_abi_grid(int la, double *x){
+  if (la < 1 || x == NULL) return P1D_ABI_EINVAL;
+  set_grid_points_1D(x, &la);
+  return 0;
+}
+
+int p1d_abi_rhs_dirichlet(int la, double t0, double t1, double *rhs){
+  if (la < 1 || rhs == NULL) return P1D_ABI_EINVAL;
+  set_dense_RHS_DBC_1D(rhs, &la, &t0, &t1);
+  return 0;
+}
+
+int p1d_abi_exact_dirichlet(int la, double t0, double t1, const double *x, double *u){
+  if (la < 1 || x == NULL || u == NULL) return P1D_ABI_EINVAL;
+  set_analytical_solution_DBC_1D(u, (double *) x, &la, &t0, &t1);
+  return 0;
+}
+
+int p1d_abi_solve_direct(int la, const double *rhs, double *sol){
+  int lab = 4, kv = 1, kl = 1, ku = 1, nrhs = 1, info;
+  double *AB, t0;
+  int *ipiv;
+  if (la < 1 || rhs == NULL || sol == NULL) return P1D_ABI_EINVAL;
+  AB = (double *) malloc(sizeof(double)*lab*la);
+  ipiv = (int *) malloc(sizeof(int)*la);
+  if (AB == NULL || ipiv == NULL){
+    free(AB);
+    free(ipiv);
+    return P1D_ABI_ENOMEM;
+  }
+  t0 = abi_wtime();
+  set_GB_operator_colMajor_poisson1D_quiet(AB, &lab, &la, &kv);
+  if (sol != rhs) memcpy(sol, rhs, sizeof(double)*la);
+  dgbsv_(&la, &kl, &ku, &nrhs, AB, &lab, ipiv, sol, &la, &info);
+  abi_count(P1D_ABI_DIRECT, abi_wtime() - t0);
+  free(AB);
+  free(ipiv);
+  return (info == 0) ? 0 : P1D_ABI_ESOLVE;
+}
+
+int p1d_abi_solve_iter(int method, int la, const double *rhs, double *sol, double tol, int maxit,
+                       int nthreads, double *resvec, int *nbite){
+  int lab = 3, kv = 0, ku = 1, kl = 1, ret = 0;
+  double *AB, *AX = NULL, t0;
+  p1d_team team;
+
+  if (la < 1 || rhs == NULL || sol == NULL || resvec == NULL || nbite == NULL || maxit < 0) return P1D_ABI_EINVAL;
+  if (method != P1D_ABI_RICHARDSON && method != P1D_ABI_JACOBI && method != P1D_ABI_GAUSS_SEIDEL) return P1D_ABI_EINVAL;
+  AB = (double *) malloc(sizeof(double)*lab*la);
+  if (AB == NULL) return P1D_ABI_ENOMEM;
+  t0 = abi_wtime();
+  set_GB_operator_colMajor_poisson1D_quiet(AB, &lab, &la, &kv);
+  if (method == P1D_ABI_GAUSS_SEIDEL){
+    // Boucle de gauss_seidel_tridiag, sans les traces
+    int iter = 0;
+    double resid = 1.0;
+    AX = (double *) malloc(sizeof(double)*la);
+    if (AX == NULL){
+      ret = P1D_ABI_ENOMEM;
+    } else {
+      resvec[0] = 1.0;
+      while (iter < maxit && resid > tol){
+        resid = gauss_seidel_tridiag_step(AB, (double *) rhs, sol, AX, &lab, &la, &ku, &kl);
+        iter++;
+        resvec[iter] = resid;
+      }
+      *nbite = iter;
+    }
+  } else if (p1d_team_create(&team, nthreads, POISSON1D_PIN_NONE) != 0){
+    ret = P1D_ABI_ENOMEM;
+  } else {
+    if (method == P1D_ABI_RICHARDSON){
+      // alpha = 2/(lambda_min + lambda_max), sans l'affichage de richardson_alpha_opt
+      double alpha = 2.0/(eigmax_poisson1D(&la) + eigmin_poisson1D(&la));
+      richardson_alpha_team(&team, AB, (double *) rhs, sol, &alpha, &lab, &la, &tol, &maxit, resvec, nbite);
+    } else {
+      jacobi_tridiag_team(&team, AB, (double *) rhs, sol, &lab, &la, &tol, &maxit, resvec, nbite);
+    }
+    p1d_team_free(&team);
+  }
+  if (ret == 0) abi_count(method, abi_wtime() - t0);
+  free(AB);
+  free(AX);
+  return ret;
+}
+
+int p1d_abi_timing(int method, long long *ncalls, double *total_s, double *last_s){
+  if (method < 0 || method >= P1D_ABI_NSOLVER) return P1D_ABI_EINVAL;
+  pthread_mutex_lock(&counters_lock);
+  if (ncalls != NULL) *ncalls = counters[method].ncalls;
+  if (total_s != NULL) *total_s = counters[method].total;
+  if (last_s != NULL) *last_s = counters[method].last;
+  pthread_mutex_unlock(&counters_lock);
+  return 0;
+}
+
+void p1d_abi_timing_reset(void){
+  pthread_mutex_lock(&counters_lock);
+  memset(counters, 0, sizeof(counters));
+  pthread_mutex_unlock(&counters_lock);
+}
@@ -0,0 +1,381 @@
+/**********************************************/
+/* lib_poisson1D_autotune.c                   */
+/* Autotuning layer: benchmarks the solvers   */
+/* and dispatches through poisson1D_solve()   */
+/**********************************************/
+#include "lib_poisson1D.h"
+#include <time.h>
+#include <unistd.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#define AUTOTUNE_NBUCKET 32
+#define AUTOTUNE_NREP 3
+#define AUTOTUNE_PROBE_NRHS 8
+#define AUTOTUNE_ITER_MAXIT 1000
+
+static const char *method_names[POISSON1D_NMETHOD] = {
+  "dgbsv", "dgbtrftridiag", "dst", "mixed", "richardson_csr", "jacobi", "gauss_seidel"
+};
+
+/* Table en mémoire, indexée par classe de taille floor(log2(la)) */
+static poisson1D_config autotune_table[AUTOTUNE_NBUCKET];
+static int autotune_loaded = 0;
+/* Protège la table et le fichier de cache entre appels concurrents */
+static pthread_mutex_t autotune_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static double wtime(void){
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + 1e-9*ts.tv_nsec;
+}
+
+static int size_bucket(int la){
+  int b = 0;
+  while ((la >> (b+1)) > 0 && b < AUTOTUNE_NBUCKET-1) b++;
+  return b;
+}
+
+static int max_threads(void){
+#ifdef _OPENMP
+  return omp_get_max_threads();
+#else
+  return 1;
+#endif
+}
+
+static void set_threads(int nth){
+#ifdef _OPENMP
+  omp_set_num_threads(nth);
+#else
+  (void) nth;
+#endif
+}
+
+const char *poisson1D_method_name(int method){
+  if (method < 0 || method >= POISSON1D_NMETHOD) return "unknown";
+  return method_names[method];
+}
+
+static char *cache_filename(void){
+  char *env = getenv("POISSON1D_AUTOTUNE_CACHE");
+  return (env != NULL) ? env : "poisson1D_autotune.cache";
+}
+
+/* Signature de la machine : la configuration optimale en dépend */
+static void machine_signature(char *sig, int len){
+  char host[128];
+  if (gethostname(host, sizeof(host)) != 0) strcpy(host, "unknown");
+  host[sizeof(host)-1] = '\0';
+  snprintf(sig, len, "%s/%ldcpu/%dthr", host, sysconf(_SC_NPROCESSORS_ONLN), max_threads());
+}
+
+static void autotune_load(void){
+  FILE *file;
+  char line[256], sig[192], filesig[192];
+  poisson1D_config c;
+  int b;
+
+  autotune_loaded = 1;
+  for (b=0;b<AUTOTUNE_NBUCKET;b++) autotune_table[b].method = -1;
+
+  file = fopen(cache_filename(), "r");
+  if (file == NULL) return;
+  machine_signature(sig, sizeof(sig));
+  // Un cache produit sur une autre machine est ignoré
+  if (fgets(line, sizeof(line), file) == NULL
+      || sscanf(line, "# poisson1D autotune v1 %191s", filesig) != 1
+      || strcmp(sig, filesig) != 0){
+    fclose(file);
+    return;
+  }
+  while (fgets(line, sizeof(line), file) != NULL){
+    char name[32];
+    int m;
+    if (line[0] == '#') continue;
+    if (sscanf(line, "%d %31s %d %d %lf %lf", &b, name, &c.nthreads, &c.tile, &c.tol, &c.time) != 6) continue;
+    if (b < 0 || b >= AUTOTUNE_NBUCKET) continue;
+    c.method = -1;
+    for (m=0;m<POISSON1D_NMETHOD;m++){
+      if (strcmp(name, method_names[m]) == 0) c.method = m;
+    }
+    if (c.method >= 0) autotune_table[b] = c;
+  }
+  fclose(file);
+}
+
+static int autotune_save(void){
+  FILE *file;
+  char sig[192], tmpname[512];
+  int b;
+  // Écriture dans un fichier temporaire puis renommage atomique
+  snprintf(tmpname, sizeof(tmpname), "%s.%d.tmp", cache_filename(), (int) getpid());
+  file = fopen(tmpname, "w");
+  if (file == NULL){
+    perror(tmpname);
+    return -1;
+  }
+  machine_signature(sig, sizeof(sig));
+  fprintf(file, "# poisson1D autotune v1 %s\n", sig);
+  fprintf(file, "# bucket\tmethod\tthreads\ttile\ttol\ttime_s\n");
+  for (b=0;b<AUTOTUNE_NBUCKET;b++){
+    poisson1D_config *c = &autotune_table[b];
+    if (c->method < 0) continue;
+    fprintf(file, "%d\t%s\t%d\t%d\t%e\t%e\n", b, method_names[c->method],
+            c->nthreads, c->tile, c->tol, c->time);
+  }
+  fclose(file);
+  if (rename(tmpname, cache_filename()) != 0){
+    perror(cache_filename());
+    return -1;
+  }
+  return 0;
+}
+
+/* Thomas en simple précision, raffiné en double précision */
+static int solve_mixed(double *RHS, int la, double tol){
+  float *c = (float *) malloc(sizeof(float)*la);
+  float *d = (float *) malloc(sizeof(float)*la);
+  double *r = (double *) malloc(sizeof(double)*la);
+  double *x = (double *) calloc(la, sizeof(double));
+  double nb = 0.0, nr, nx;
+  int i, it, info = 0;
+
+  for (i=0;i<la;i++) nb = fmax(nb, fabs(RHS[i]));
+  // Factorisation : d_i = 2 - 1/d_{i-1}, c_i = -1/d_i
+  d[0] = 2.0f;
+  for (i=1;i<la;i++) d[i] = 2.0f - 1.0f/d[i-1];
+  for (i=0;i<la;i++) c[i] = -1.0f/d[i];
+
+  memcpy(r, RHS, sizeof(double)*la);
+  for (it=0;it<30;it++){
+    float prev = 0.0f;
+    // Descente puis remontée sur la correction, en simple précision
+    for (i=0;i<la;i++){
+      prev = ((float) r[i] + prev) / d[i];
+      r[i] = prev;
+    }
+    for (i=la-2;i>=0;i--) r[i] -= c[i]*r[i+1];
+    for (i=0;i<la;i++) x[i] += r[i];
+    // Résidu en double précision, arrêt sur l'erreur inverse normwise
+    nr = 0.0;
+    nx = 0.0;
+    for (i=0;i<la;i++){
+      double ax = 2.0*x[i] - (i > 0 ? x[i-1] : 0.0) - (i < la-1 ? x[i+1] : 0.0);
+      r[i] = RHS[i] - ax;
+      nr = fmax(nr, fabs(r[i]));
+      nx = fmax(nx, fabs(x[i]));
+    }
+    if (nr <= tol*(4.0*nx + nb)) break;
+  }
+  if (it == 30) info = 1;
+  memcpy(RHS, x, sizeof(double)*la);
+  free(c); free(d); free(r); free(x);
+  return info;
+}
+
+/* Résolution de nrhs systèmes par la méthode décrite par cfg */
+static int solve_with(poisson1D_config *cfg, double *RHS, int la, int nrhs, double tol){
+  int kv = 1, ku = 1, kl = 1, lab = 4, info = 0, r, nb;
+  int prev_threads = max_threads();
+  double *AB;
+  int *ipiv;
+
+  set_threads(cfg->nthreads);
+  switch (cfg->method){
+  case POISSON1D_DGBSV:
+  case POISSON1D_DGBTRFTRIDIAG:
+    AB = (double *) malloc(sizeof(double)*lab*la);
+    ipiv = (int *) malloc(sizeof(int)*la);
+    set_GB_operator_colMajor_poisson1D_quiet(AB, &lab, &la, &kv);
+    if (cfg->method == POISSON1D_DGBSV){
+      dgbtrf_(&la, &la, &kl, &ku, AB, &lab, ipiv, &info);
+    } else {
+      dgbtrftridiag(&la, &la, &kl, &ku, AB, &lab, ipiv, &info);
+    }
+    // Descente-remontée par paquets de tile seconds membres
+    for (r=0;r<nrhs && info==0;r+=cfg->tile){
+      nb = (nrhs - r < cfg->tile) ? nrhs - r : cfg->tile;
+      dgbtrs_("N", &la, &kl, &ku, &nb, AB, &lab, ipiv, RHS + (long) r*la, &la, &info);
+    }
+    free(AB);
+    free(ipiv);
+    break;
+  case POISSON1D_DST: {
+    dst_plan plan;
+    info = dst_plan_create(&plan, &la);
+    for (r=0;r<nrhs && info==0;r+=cfg->tile){
+      nb = (nrhs - r < cfg->tile) ? nrhs - r : cfg->tile;
+      poisson1D_dst_solve(&plan, RHS + (long) r*la, &nb, &la, NULL, NULL);
+    }
+    dst_plan_free(&plan);
+    break;
+  }
+  case POISSON1D_MIXED:
+    for (r=0;r<nrhs;r++){
+      info |= solve_mixed(RHS + (long) r*la, la, tol);
+    }
+    break;
+  default: {
+    // Méthodes itératives : budget d'itérations borné, convergence vérifiée ensuite
+    int maxit = AUTOTUNE_ITER_MAXIT, nbite, lab3 = 3, kv0 = 0;
+    // 2/(lmax + lmin) sans les impressions de richardson_alpha_opt
+    double alpha = 2.0/(eigmax_poisson1D(&la) + eigmin_poisson1D(&la));
+    double *X = (double *) malloc(sizeof(double)*la);
+    double *resvec = (double *) calloc(maxit+1, sizeof(double));
+    csr_matrix A;
+    AB = (double *) malloc(sizeof(double)*lab3*la);
+    set_GB_operator_colMajor_poisson1D_quiet(AB, &lab3, &la, &kv0);
+    GB2CSR_operator_colMajor(AB, &lab3, &la, &ku, &kl, &kv0, &A);
+    for (r=0;r<nrhs;r++){
+      double *b = RHS + (long) r*la;
+      memset(X, 0, sizeof(double)*la);
+      if (cfg->method == POISSON1D_RICHARDSON){
+        richardson_alpha_csr(&A, b, X, &alpha, &tol, &maxit, resvec, &nbite);
+      } else if (cfg->method == POISSON1D_JACOBI){
+        jacobi_tridiag(AB, b, X, &lab3, &la, &ku, &kl, &tol, &maxit, resvec, &nbite);
+      } else {
+        gauss_seidel_tridiag(AB, b, X, &lab3, &la, &ku, &kl, &tol, &maxit, resvec, &nbite);
+      }
+      // Budget épuisé sans atteindre la tolérance : échec, comme solve_mixed
+      // (richardson_alpha_csr range le dernier résidu en nbite-1, Jacobi et
+      // Gauss-Seidel en nbite)
+      if (nbite >= maxit){
+        double last = (cfg->method == POISSON1D_RICHARDSON) ? resvec[nbite-1] : resvec[nbite];
+        if (!(last <= tol)) info = 1;
+      }
+      memcpy(b, X, sizeof(double)*la);
+    }
+    csr_free(&A);
+    free(AB);
+    free(X);
+    free(resvec);
+    break;
+  }
+  }
+  set_threads(prev_threads);
+  return info;
+}
+
+/* Erreur inverse normwise max sur les nrhs systèmes (opérateur [-1 2 -1]) :
+   ||b - Au||_inf / (||A||_inf ||u||_inf + ||b||_inf), avec ||A||_inf = 4 */
+static double max_backward_error(double *B, double *U, int la, int nrhs){
+  double worst = 0.0;
+  int r, i;
+  for (r=0;r<nrhs;r++){
+    double *b = B + (long) r*la, *u = U + (long) r*la;
+    double nr = 0.0, nu = 0.0, nb = 0.0, eta;
+    for (i=0;i<la;i++){
+      double ax = 2.0*u[i] - (i > 0 ? u[i-1] : 0.0) - (i < la-1 ? u[i+1] : 0.0);
+      nr = fmax(nr, fabs(b[i] - ax));
+      nu = fmax(nu, fabs(u[i]));
+      nb = fmax(nb, fabs(b[i]));
+    }
+    eta = (nb > 0.0) ? nr / (4.0*nu + nb) : 0.0;
+    if (!(eta <= worst)) worst = eta;
+  }
+  return worst;
+}
+
+int poisson1D_autotune(int *la, double *tol, poisson1D_config *best){
+  int nrhs = AUTOTUNE_PROBE_NRHS, n = *la, m, t, k, rep;
+  int tiles[3] = {1, 4, AUTOTUNE_PROBE_NRHS};
+  int maxth = max_threads();
+  double *B = (double *) malloc(sizeof(double)*n*nrhs);
+  double *U = (double *) malloc(sizeof(double)*n*nrhs);
+  double T0 = 5.0, T1 = 20.0;
+  poisson1D_config cfg;
+
+  best->method = -1;
+  best->time = INFINITY;
+  for (k=0;k<nrhs;k++){
+    set_dense_RHS_DBC_1D(B + (long) k*n, la, &T0, &T1);
+    B[(long) k*n + n/2] += k;
+  }
+
+  printf("\nAutotuning pour la = %d (%d seconds membres, %d threads max)\n", n, nrhs, maxth);
+  for (m=0;m<POISSON1D_NMETHOD;m++){
+    // Les méthodes itératives ne sont essayées que sur de petites tailles
+    if (m >= POISSON1D_RICHARDSON && n > 256) continue;
+    for (t=1;t<=maxth;t*=2){
+      for (k=0;k<3;k++){
+        double tmin = INFINITY, res;
+        int info = 0;
+        cfg.method = m;
+        cfg.nthreads = t;
+        cfg.tile = tiles[k];
+        cfg.tol = *tol;
+        for (rep=0;rep<AUTOTUNE_NREP;rep++){
+          double t0;
+          memcpy(U, B, sizeof(double)*n*nrhs);
+          t0 = wtime();
+          info = solve_with(&cfg, U, n, nrhs, *tol);
+          t0 = wtime() - t0;
+          if (t0 < tmin) tmin = t0;
+        }
+        res = max_backward_error(B, U, n, nrhs);
+        // Un candidat inexact est écarté quel que soit son temps
+        if (info != 0 || !(res <= *tol)){
+          printf("  %-15s threads=%-3d tile=%-3d rejeté (info = %d, erreur inverse = %e)\n",
+                 method_names[m], t, cfg.tile, info, res);
+          break;
+        }
+        cfg.time = tmin / nrhs;
+        printf("  %-15s threads=%-3d tile=%-3d %e s/solve\n", method_names[m], t, cfg.tile, cfg.time);
+        if (cfg.time < best->time) *best = cfg;
+        // La taille de paquet n'a de sens que pour les méthodes directes factorisées
+        if (m != POISSON1D_DGBSV && m != POISSON1D_DGBTRFTRIDIAG && m != POISSON1D_DST) break;
+      }
+      // Seules les méthodes parallèles dépendent du nombre de threads
+      if (m != POISSON1D_DST && m != POISSON1D_RICHARDSON) break;
+    }
+  }
+  free(B);
+  free(U);
+  if (best->method < 0){
+    printf("Erreur: aucun solveur n'atteint la tolérance %e\n", *tol);
+    return -1;
+  }
+  printf("Choix : %s, threads=%d, tile=%d\n", method_names[best->method], best->nthreads, best->tile);
+  return 0;
+}
+
+int poisson1D_solve(double *RHS, int *la, int *nrhs, double *tol){
+  poisson1D_config cfg;
+  double *B;
+  int b, info;
+
+  if (*la < 1 || *nrhs < 1) return -1;
+  pthread_mutex_lock(&autotune_lock);
+  if (!autotune_loaded) autotune_load();
+  b = size_bucket(*la);
+  // Pas de configuration assez précise pour cette classe : on la mesure,
+  // sous le verrou pour qu'un seul appelant le fasse
+  if (autotune_table[b].method < 0 || autotune_table[b].tol > *tol){
+    if (poisson1D_autotune(la, tol, &autotune_table[b]) != 0){
+      autotune_table[b].method = -1;
+      pthread_mutex_unlock(&autotune_lock);
+      return -1;
+    }
+    autotune_save();
+  }
+  cfg = autotune_table[b];
+  pthread_mutex_unlock(&autotune_lock);
+
+  // La configuration a été validée à une seule taille de la classe : la
+  // solution est vérifiée, et recalculée par dgbsv si elle n'est pas assez précise
+  B = (double *) malloc(sizeof(double)*(size_t) (*la)*(*nrhs));
+  if (B == NULL) return -1;
+  memcpy(B, RHS, sizeof(double)*(size_t) (*la)*(*nrhs));
+  info = solve_with(&cfg, RHS, *la, *nrhs, *tol);
+  if (info != 0 || !(max_backward_error(B, RHS, *la, *nrhs) <= *tol)){
+    cfg.method = POISSON1D_DGBSV;
+    cfg.tile = *nrhs;
+    memcpy(RHS, B, sizeof(double)*(size_t) (*la)*(*nrhs));
+    info = solve_with(&cfg, RHS, *la, *nrhs, *tol);
+    if (info == 0 && !(max_backward_error(B, RHS, *la, *nrhs) <= *tol)) info = 1;
+  }
+  free(B);
+  return info;
+}
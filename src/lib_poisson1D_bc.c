@@ -0,0 +1,257 @@
+/**********************************************/
+/* lib_poisson1D_bc.c                         */
+/* Neumann, Robin and periodic boundary       */
+/* conditions: operator, RHS, cyclic and      */
+/* singular O(n) solvers                      */
+/**********************************************/
+#include "lib_poisson1D.h"
+
+static int bc_check(int *la, poisson1D_bc *left, poisson1D_bc *right){
+  int n = *la;
+  if ((left->type == BC_PERIODIC) != (right->type == BC_PERIODIC)){
+    printf("Erreur: condition périodique imposée d'un seul côté\n");
+    return -1;
+  }
+  if ((left->type == BC_DIRICHLET && left->alpha == 0.0) || (right->type == BC_DIRICHLET && right->alpha == 0.0)){
+    printf("Erreur: condition de Dirichlet avec alpha = 0\n");
+    return -1;
+  }
+  if ((left->type == BC_NEUMANN || left->type == BC_ROBIN) && left->beta == 0.0){
+    printf("Erreur: condition de Neumann/Robin avec beta = 0 (utiliser Dirichlet)\n");
+    return -1;
+  }
+  if ((right->type == BC_NEUMANN || right->type == BC_ROBIN) && right->beta == 0.0){
+    printf("Erreur: condition de Neumann/Robin avec beta = 0 (utiliser Dirichlet)\n");
+    return -1;
+  }
+  if ((left->type == BC_PERIODIC && n < 3) || n < 1 || (left->type != BC_DIRICHLET && right->type != BC_DIRICHLET && n < 2)){
+    printf("Erreur: %d inconnues insuffisantes pour ces conditions aux limites\n", n);
+    return -1;
+  }
+  return 0;
+}
+
+/* Nombre d'intervalles de [0,1] : les noeuds de Dirichlet ne sont pas des
+   inconnues, le noeud x=1 périodique est identifié à x=0 */
+static int bc_intervals(int *la, poisson1D_bc *left, poisson1D_bc *right){
+  if (left->type == BC_PERIODIC) return *la;
+  return (*la) - 1 + (left->type == BC_DIRICHLET) + (right->type == BC_DIRICHLET);
+}
+
+/* Les lignes de bord Neumann/Robin sont divisées par 2 : l'opérateur reste
+   symétrique et le poids de quadrature de ces noeuds vaut 1/2 */
+static double bc_weight(int i, int n, poisson1D_bc *left, poisson1D_bc *right){
+  if (i == 0 && (left->type == BC_NEUMANN || left->type == BC_ROBIN)) return 0.5;
+  if (i == n-1 && (right->type == BC_NEUMANN || right->type == BC_ROBIN)) return 0.5;
+  return 1.0;
+}
+
+int set_grid_points_bc_1D(double* x, int* la, poisson1D_bc *left, poisson1D_bc *right){
+  int jj, off;
+  double h;
+  if (bc_check(la, left, right) != 0) return -1;
+  h = 1.0/(1.0*bc_intervals(la, left, right));
+  off = (left->type == BC_DIRICHLET);
+  for (jj=0;jj<(*la);jj++){
+    x[jj] = (jj + off)*h;
+  }
+  return 0;
+}
+
+/* -u'' + sigma u, multiplié par h^2. Ligne de Neumann/Robin au noeud de bord
+   par point fantôme : alpha u + beta du/dn = g, avec du/dn dérivée normale
+   sortante, donne (1 + h alpha/beta + sigma h^2/2) u_0 - u_1 */
+int set_GB_operator_colMajor_bc(double* AB, int *lab, int *la, int *kv, double *sigma,
+                                poisson1D_bc *left, poisson1D_bc *right, double *corner){
+  int ii, jj, kk, n = *la;
+  double h, s;
+  if (bc_check(la, left, right) != 0) return -1;
+  h = 1.0/(1.0*bc_intervals(la, left, right));
+  s = (*sigma)*h*h;
+  for (jj=0;jj<n;jj++){
+    kk = jj*(*lab);
+    for (ii=0;ii<(*lab);ii++){
+      AB[kk+ii]=0.0;
+    }
+    if (jj > 0) AB[kk+ *kv]=-1.0;
+    AB[kk+ *kv+1]=2.0+s;
+    if (jj < n-1) AB[kk+ *kv+2]=-1.0;
+  }
+  if (left->type == BC_NEUMANN || left->type == BC_ROBIN){
+    AB[*kv+1] = 1.0 + h*left->alpha/left->beta + 0.5*s;
+  }
+  if (right->type == BC_NEUMANN || right->type == BC_ROBIN){
+    AB[(n-1)*(*lab) + *kv+1] = 1.0 + h*right->alpha/right->beta + 0.5*s;
+  }
+  // Coins A(0,n-1), A(n-1,0) hors de la bande
+  corner[0] = (left->type == BC_PERIODIC) ? -1.0 : 0.0;
+  corner[1] = corner[0];
+  return 0;
+}
+
+int set_dense_RHS_bc_1D(double* RHS, int* la, poisson1D_source f, void *ctx,
+                        poisson1D_bc *left, poisson1D_bc *right){
+  int jj, n = *la, off;
+  double h, h2;
+  if (bc_check(la, left, right) != 0) return -1;
+  h = 1.0/(1.0*bc_intervals(la, left, right));
+  h2 = h*h;
+  off = (left->type == BC_DIRICHLET);
+  for (jj=0;jj<n;jj++){
+    RHS[jj] = (f != NULL) ? h2*f((jj + off)*h, ctx) : 0.0;
+  }
+  if (left->type == BC_NEUMANN || left->type == BC_ROBIN){
+    RHS[0] = 0.5*RHS[0] + h*left->g/left->beta;
+  }
+  if (right->type == BC_NEUMANN || right->type == BC_ROBIN){
+    RHS[n-1] = 0.5*RHS[n-1] + h*right->g/right->beta;
+  }
+  // Dirichlet après la mise à l'échelle : couplage -1 dans les deux cas
+  if (left->type == BC_DIRICHLET) RHS[0] += left->g/left->alpha;
+  if (right->type == BC_DIRICHLET) RHS[n-1] += right->g/right->alpha;
+  return 0;
+}
+
+/* Thomas sur les n premières lignes de la bande, diagonales de bord
+   corrigées de d0 et dn ; cp = du/m, ip = 1/m */
+static int tri_factor(double *AB, int lab, int kv, int n, double d0, double dn, double *cp, double *ip){
+  int i;
+  double m, cprev = 0.0;
+  for (i=0;i<n;i++){
+    m = AB[i*lab + kv+1];
+    if (i == 0) m += d0;
+    if (i == n-1) m += dn;
+    if (i > 0) m -= AB[(i-1)*lab + kv+2]*cprev;
+    if (m == 0.0){
+      printf("Erreur: pivot nul à la ligne %d\n", i);
+      return i+1;
+    }
+    ip[i] = 1.0/m;
+    cprev = (i < n-1) ? AB[(i+1)*lab + kv]*ip[i] : 0.0;
+    cp[i] = cprev;
+  }
+  return 0;
+}
+
+static void tri_solve(double *AB, int lab, int kv, int n, double *cp, double *ip, double *x){
+  int i;
+  x[0] *= ip[0];
+  for (i=1;i<n;i++){
+    x[i] = (x[i] - AB[(i-1)*lab + kv+2]*x[i-1])*ip[i];
+  }
+  for (i=n-2;i>=0;i--){
+    x[i] -= cp[i]*x[i+1];
+  }
+}
+
+/* Sherman-Morrison : A = T' + u v^T avec u = (gamma, 0, ..., alpha),
+   v = (1, 0, ..., beta/gamma), T' tridiagonale ; deux descentes-remontées
+   sur la même factorisation */
+int cyclic_tridiag_solve(double *AB, int *lab, int *la, int *kv, double *corner, double *RHS){
+  int n = *la, i, info;
+  double beta = corner[0], alpha = corner[1], gamma, fact, den;
+  double *cp, *ip, *z;
+  if (n < 3){
+    printf("Erreur: système cyclique de taille %d < 3\n", n);
+    return -1;
+  }
+  gamma = -AB[*kv+1];
+  if (gamma == 0.0) gamma = 1.0;
+  cp = (double *) malloc(sizeof(double)*n);
+  ip = (double *) malloc(sizeof(double)*n);
+  z = (double *) calloc(n, sizeof(double));
+  info = tri_factor(AB, *lab, *kv, n, -gamma, -alpha*beta/gamma, cp, ip);
+  if (info == 0){
+    tri_solve(AB, *lab, *kv, n, cp, ip, RHS);
+    z[0] = gamma;
+    z[n-1] = alpha;
+    tri_solve(AB, *lab, *kv, n, cp, ip, z);
+    den = 1.0 + z[0] + beta*z[n-1]/gamma;
+    if (den == 0.0){
+      printf("Erreur: système cyclique singulier\n");
+      info = n+1;
+    } else {
+      fact = (RHS[0] + beta*RHS[n-1]/gamma)/den;
+      for (i=0;i<n;i++){
+        RHS[i] -= fact*z[i];
+      }
+    }
+  }
+  free(cp);
+  free(ip);
+  free(z);
+  return info;
+}
+
+/* Noyau des constantes : toutes les sommes de lignes (coins compris) nulles */
+static int bc_is_singular(double *AB, int lab, int kv, int n, double *corner){
+  int i;
+  for (i=0;i<n;i++){
+    double s = AB[i*lab + kv+1];
+    if (i > 0) s += AB[(i-1)*lab + kv+2];
+    if (i < n-1) s += AB[(i+1)*lab + kv];
+    if (i == 0) s += corner[0];
+    if (i == n-1) s += corner[1];
+    if (fabs(s) > 64.0*DBL_EPSILON*fabs(AB[i*lab + kv+1])) return 0;
+  }
+  return 1;
+}
+
+/* Neumann pur ou périodique sans terme sigma : projection du second membre
+   sur l'image (on retire la composante constante de f, poids w de
+   quadrature), inconnue u_{n-1} fixée à 0 -- ce qui supprime aussi les
+   coins -- puis jauge de moyenne pondérée nulle */
+static int singular_solve(double *AB, int lab, int kv, int n, poisson1D_bc *left, poisson1D_bc *right,
+                          double *RHS, double *mean){
+  int i, info;
+  double sw = 0.0, sb = 0.0, c, *cp, *ip;
+  for (i=0;i<n;i++){
+    double w = bc_weight(i, n, left, right);
+    sw += w;
+    sb += RHS[i];
+  }
+  c = sb/sw;
+  for (i=0;i<n;i++){
+    RHS[i] -= c*bc_weight(i, n, left, right);
+  }
+  if (mean != NULL) *mean = c;
+  cp = (double *) malloc(sizeof(double)*n);
+  ip = (double *) malloc(sizeof(double)*n);
+  info = tri_factor(AB, lab, kv, n-1, 0.0, 0.0, cp, ip);
+  if (info == 0){
+    tri_solve(AB, lab, kv, n-1, cp, ip, RHS);
+    RHS[n-1] = 0.0;
+    sb = 0.0;
+    for (i=0;i<n;i++){
+      sb += bc_weight(i, n, left, right)*RHS[i];
+    }
+    c = sb/sw;
+    for (i=0;i<n;i++){
+      RHS[i] -= c;
+    }
+  }
+  free(cp);
+  free(ip);
+  return info;
+}
+
+int poisson1D_bc_solve(double *AB, int *lab, int *la, int *kv, double *corner,
+                       poisson1D_bc *left, poisson1D_bc *right, double *RHS, double *mean){
+  int n = *la, info;
+  double *cp, *ip;
+  if (mean != NULL) *mean = 0.0;
+  if (bc_check(la, left, right) != 0) return -1;
+  if (bc_is_singular(AB, *lab, *kv, n, corner)){
+    return singular_solve(AB, *lab, *kv, n, left, right, RHS, mean);
+  }
+  if (left->type == BC_PERIODIC){
+    return cyclic_tridiag_solve(AB, lab, la, kv, corner, RHS);
+  }
+  cp = (double *) malloc(sizeof(double)*n);
+  ip = (double *) malloc(sizeof(double)*n);
+  info = tri_factor(AB, *lab, *kv, n, 0.0, 0.0, cp, ip);
+  if (info == 0) tri_solve(AB, *lab, *kv, n, cp, ip, RHS);
+  free(cp);
+  free(ip);
+  return info;
+}
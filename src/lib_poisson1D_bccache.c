@@ -0,0 +1,170 @@
+/**********************************************/
+/* lib_poisson1D_bccache.c                    */
+/* Superposition cache: solution for any      */
+/* Dirichlet values (T0, T1) in one axpy      */
+/**********************************************/
+#include "lib_poisson1D.h"
+
+void bc_cache_init(bc_cache *cache, size_t max_bytes){
+  cache->head = NULL;
+  cache->tail = NULL;
+  cache->bytes = 0;
+  cache->max_bytes = max_bytes;
+  cache->nentries = 0;
+  cache->nsolves = 0;
+  pthread_mutex_init(&cache->lock, NULL);
+}
+
+static void bc_unlink(bc_cache *cache, bc_entry *e){
+  if (e->prev != NULL) e->prev->next = e->next; else cache->head = e->next;
+  if (e->next != NULL) e->next->prev = e->prev; else cache->tail = e->prev;
+  e->prev = e->next = NULL;
+}
+
+static void bc_push_front(bc_cache *cache, bc_entry *e){
+  e->prev = NULL;
+  e->next = cache->head;
+  if (cache->head != NULL) cache->head->prev = e;
+  cache->head = e;
+  if (cache->tail == NULL) cache->tail = e;
+}
+
+/* Éviction LRU des entrées inutilisées jusqu'à respecter la borne mémoire */
+static void bc_evict(bc_cache *cache){
+  bc_entry *e = cache->tail;
+  while (cache->max_bytes > 0 && cache->bytes > cache->max_bytes && e != NULL){
+    bc_entry *prev = e->prev;
+    if (e->refcount == 0){
+      bc_unlink(cache, e);
+      cache->bytes -= e->bytes;
+      cache->nentries--;
+      free(e->B);
+      free(e);
+    }
+    e = prev;
+  }
+}
+
+/* Solutions de base u0 (T0=1, T1=0) et u1 (T0=0, T1=1), entrelacées */
+static int bc_basis(int la, double *B){
+  int kv = 1, ku = 1, kl = 1, lab = 4, NRHS = 2, info, jj;
+  double *AB = (double *) malloc(sizeof(double)*lab*la);
+  double *U = (double *) calloc(2*(size_t)la, sizeof(double));
+  int *ipiv = (int *) malloc(sizeof(int)*la);
+
+  if (AB == NULL || U == NULL || ipiv == NULL){
+    free(AB);
+    free(U);
+    free(ipiv);
+    return -1;
+  }
+  set_GB_operator_colMajor_poisson1D_quiet(AB, &lab, &la, &kv);
+  U[0] = 1.0;
+  U[la + la-1] += 1.0;
+  dgbtrf_(&la, &la, &kl, &ku, AB, &lab, ipiv, &info);
+  if (info == 0){
+    dgbtrs_("N", &la, &kl, &ku, &NRHS, AB, &lab, ipiv, U, &la, &info);
+  }
+  // Entrelacement : une seule passe mémoire pour la combinaison
+  for (jj=0;jj<la;jj++){
+    B[2*jj] = U[jj];
+    B[2*jj+1] = U[la+jj];
+  }
+  free(AB);
+  free(U);
+  free(ipiv);
+  return info;
+}
+
+static bc_entry *bc_acquire(bc_cache *cache, int la){
+  bc_entry *e;
+  pthread_mutex_lock(&cache->lock);
+  for (e=cache->head;e!=NULL;e=e->next){
+    if (e->la == la) break;
+  }
+  if (e != NULL){
+    bc_unlink(cache, e);
+    bc_push_front(cache, e);
+    e->refcount++;
+    e->hits++;
+    pthread_mutex_unlock(&cache->lock);
+    return e;
+  }
+  pthread_mutex_unlock(&cache->lock);
+
+  // Absent : calcul des deux solutions de base hors verrou
+  e = (bc_entry *) calloc(1, sizeof(bc_entry));
+  if (e == NULL) return NULL;
+  e->la = la;
+  e->bytes = sizeof(double)*2*(size_t)la;
+  e->B = (double *) malloc(e->bytes);
+  if (e->B == NULL || bc_basis(la, e->B) != 0){
+    printf("Erreur: solutions de base impossibles pour la = %d\n", la);
+    free(e->B);
+    free(e);
+    return NULL;
+  }
+
+  pthread_mutex_lock(&cache->lock);
+  cache->nsolves++;
+  // Un autre thread a pu insérer la même taille entre-temps
+  bc_entry *other;
+  for (other=cache->head;other!=NULL;other=other->next){
+    if (other->la == la) break;
+  }
+  if (other != NULL){
+    other->refcount++;
+    other->hits++;
+    pthread_mutex_unlock(&cache->lock);
+    free(e->B);
+    free(e);
+    return other;
+  }
+  e->refcount = 1;
+  bc_push_front(cache, e);
+  cache->bytes += e->bytes;
+  cache->nentries++;
+  bc_evict(cache);
+  pthread_mutex_unlock(&cache->lock);
+  return e;
+}
+
+static void bc_release(bc_cache *cache, bc_entry *e){
+  pthread_mutex_lock(&cache->lock);
+  e->refcount--;
+  bc_evict(cache);
+  pthread_mutex_unlock(&cache->lock);
+}
+
+int bc_cache_solve(bc_cache *cache, int *la, double *BC0, double *BC1, double *X){
+  bc_entry *e;
+  const double *B;
+  double t0 = *BC0, t1 = *BC1;
+  int jj;
+
+  if (*la < 1) return -1;
+  e = bc_acquire(cache, *la);
+  if (e == NULL) return -1;
+  B = e->B;
+  // X = T0*u0 + T1*u1 (axpy fusionné)
+  #pragma omp parallel for schedule(static) if(*la > 100000)
+  for (jj=0;jj<(*la);jj++){
+    X[jj] = t0*B[2*jj] + t1*B[2*jj+1];
+  }
+  bc_release(cache, e);
+  return 0;
+}
+
+void bc_cache_free(bc_cache *cache){
+  bc_entry *e = cache->head;
+  while (e != NULL){
+    bc_entry *next = e->next;
+    free(e->B);
+    free(e);
+    e = next;
+  }
+  cache->head = cache->tail = NULL;
+  cache->bytes = 0;
+  cache->nentries = 0;
+  pthread_mutex_destroy(&cache->lock);
+}
@@ -0,0 +1,205 @@
+/**********************************************/
+/* lib_poisson1D_checkpoint.c                 */
+/* Checkpoint/restart of the iterative        */
+/* solvers (Richardson, Jacobi, Gauss-Seidel) */
+/**********************************************/
+#include "lib_poisson1D.h"
+#include <unistd.h>
+#include <fcntl.h>
+
+#define CKPT_MAGIC "P1DCKPT"
+#define CKPT_VERSION 1
+
+static unsigned long long fnv1a(unsigned long long h, const void *buf, size_t len){
+  const unsigned char *p = (const unsigned char *) buf;
+  size_t k;
+  for (k=0;k<len;k++){
+    h ^= p[k];
+    h *= 1099511628211ULL;
+  }
+  return h;
+}
+
+void ckpt_init(ckpt_ctx *ctx, char *filename, int every){
+  memset(ctx, 0, sizeof(ckpt_ctx));
+  ctx->filename = filename;
+  ctx->every = every;
+}
+
+static int write_all(int fd, const void *buf, size_t len){
+  const char *p = (const char *) buf;
+  while (len > 0){
+    ssize_t w = write(fd, p, len);
+    if (w < 0) return -1;
+    p += w;
+    len -= w;
+  }
+  return 0;
+}
+
+/* Écriture dans filename.tmp, fsync, puis renommage atomique */
+static void *ckpt_writer(void *arg){
+  ckpt_ctx *ctx = (ckpt_ctx *) arg;
+  char tmpname[512];
+  int fd;
+
+  snprintf(tmpname, sizeof(tmpname), "%s.tmp", ctx->filename);
+  ctx->status = -1;
+  fd = open(tmpname, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0){
+    perror(tmpname);
+    return NULL;
+  }
+  if (write_all(fd, &ctx->hdr, sizeof(ckpt_header)) != 0
+      || write_all(fd, ctx->buf, ctx->buflen) != 0
+      || fsync(fd) != 0){
+    perror(tmpname);
+    close(fd);
+    return NULL;
+  }
+  close(fd);
+  if (rename(tmpname, ctx->filename) != 0){
+    perror(ctx->filename);
+    return NULL;
+  }
+  ctx->status = 0;
+  return NULL;
+}
+
+int ckpt_wait(ckpt_ctx *ctx){
+  if (ctx->pending){
+    pthread_join(ctx->thread, NULL);
+    ctx->pending = 0;
+    return ctx->status;
+  }
+  return 0;
+}
+
+int ckpt_save(ckpt_ctx *ctx, int solver, int *la, int iter, int *maxit, double *tol, double *alpha, double *X, double *resvec){
+  ckpt_header *h;
+  size_t len = sizeof(double)*((size_t)(*la) + iter + 1);
+
+  // Une seule écriture en vol : la précédente est terminée avant de recopier
+  ckpt_wait(ctx);
+  if (len > ctx->bufcap){
+    free(ctx->buf);
+    ctx->buf = (double *) malloc(len);
+    ctx->bufcap = (ctx->buf != NULL) ? len : 0;
+    if (ctx->buf == NULL) return -1;
+  }
+  // Instantané de l'état : le solveur peut continuer pendant l'écriture
+  memcpy(ctx->buf, X, sizeof(double)*(*la));
+  memcpy(ctx->buf + *la, resvec, sizeof(double)*(iter + 1));
+  ctx->buflen = len;
+
+  h = &ctx->hdr;
+  memset(h, 0, sizeof(ckpt_header));
+  memcpy(h->magic, CKPT_MAGIC, 8);
+  h->version = CKPT_VERSION;
+  h->solver = solver;
+  h->la = *la;
+  h->iter = iter;
+  h->maxit = *maxit;
+  h->tol = *tol;
+  h->alpha = (alpha != NULL) ? *alpha : 0.0;
+  h->checksum = fnv1a(14695981039346656037ULL, ctx->buf, len);
+
+  if (pthread_create(&ctx->thread, NULL, ckpt_writer, ctx) != 0){
+    // Pas de thread disponible : écriture synchrone
+    ckpt_writer(ctx);
+    return ctx->status;
+  }
+  ctx->pending = 1;
+  return 0;
+}
+
+int ckpt_load(ckpt_ctx *ctx, int solver, int *la, int *maxit, double *tol, double *alpha, double *X, double *resvec, int *iter){
+  FILE *file;
+  ckpt_header h;
+  double *buf;
+  size_t len;
+
+  file = fopen(ctx->filename, "rb");
+  if (file == NULL) return 1;  // pas de point de reprise : démarrage à froid
+  if (fread(&h, sizeof(ckpt_header), 1, file) != 1
+      || memcmp(h.magic, CKPT_MAGIC, 8) != 0 || h.version != CKPT_VERSION){
+    printf("Erreur: %s n'est pas un point de reprise valide\n", ctx->filename);
+    fclose(file);
+    return -1;
+  }
+  // Les paramètres doivent être identiques pour une reprise bit à bit
+  if (h.solver != solver || h.la != *la || h.maxit != *maxit || h.tol != *tol
+      || h.alpha != ((alpha != NULL) ? *alpha : 0.0) || h.iter < 0 || h.iter > *maxit){
+    printf("Erreur: %s a été produit avec d'autres paramètres de solveur\n", ctx->filename);
+    fclose(file);
+    return -1;
+  }
+  len = sizeof(double)*((size_t)(*la) + h.iter + 1);
+  buf = (double *) malloc(len);
+  if (buf == NULL || fread(buf, 1, len, file) != len
+      || fnv1a(14695981039346656037ULL, buf, len) != h.checksum){
+    printf("Erreur: %s est tronqué ou corrompu\n", ctx->filename);
+    free(buf);
+    fclose(file);
+    return -1;
+  }
+  fclose(file);
+  memcpy(X, buf, sizeof(double)*(*la));
+  memcpy(resvec, buf + *la, sizeof(double)*(h.iter + 1));
+  *iter = h.iter;
+  free(buf);
+  printf("Reprise depuis %s à l'itération %d\n", ctx->filename, h.iter);
+  return 0;
+}
+
+void ckpt_free(ckpt_ctx *ctx){
+  ckpt_wait(ctx);
+  free(ctx->buf);
+  ctx->buf = NULL;
+  ctx->bufcap = ctx->buflen = 0;
+}
+
+void iterative_solve_ckpt(int solver, double *AB, double *RHS, double *X, double *alpha_rich, int *lab, int *la, int *ku, int *kl, double *tol, int *maxit, double *resvec, int *nbite, ckpt_ctx *ctx){
+  double *W1 = (double *) malloc(sizeof(double)*(*la));
+  double *W2 = (double *) malloc(sizeof(double)*(*la));
+  double *alpha = (solver == CKPT_RICHARDSON) ? alpha_rich : NULL;
+  double resid = 1.0;
+  int iter = 0, first;
+
+  // Convention de resvec de chaque solveur (cf. richardson_alpha, jacobi_tridiag)
+  if (solver != CKPT_RICHARDSON) resvec[0] = 1.0;
+  if (ckpt_load(ctx, solver, la, maxit, tol, alpha, X, resvec, &iter) < 0){
+    printf("Démarrage à froid\n");
+    iter = 0;
+  }
+  if (iter > 0) resid = (solver == CKPT_RICHARDSON) ? resvec[iter-1] : resvec[iter];
+
+  // Richardson teste le résidu après l'itération (boucle do-while)
+  first = (solver == CKPT_RICHARDSON && iter == 0);
+  while (iter < *maxit && (first || resid > *tol)){
+    first = 0;
+    switch (solver){
+    case CKPT_RICHARDSON:
+      resid = richardson_alpha_step(AB, RHS, X, W1, W2, alpha_rich, lab, la, ku, kl);
+      resvec[iter] = resid;
+      break;
+    case CKPT_JACOBI:
+      resid = jacobi_tridiag_step(AB, RHS, X, W1, lab, la);
+      resvec[iter+1] = resid;
+      break;
+    default:
+      resid = gauss_seidel_tridiag_step(AB, RHS, X, W1, lab, la, ku, kl);
+      resvec[iter+1] = resid;
+      break;
+    }
+    iter++;
+    if (ctx->every > 0 && iter % ctx->every == 0){
+      ckpt_save(ctx, solver, la, iter, maxit, tol, alpha, X, resvec);
+    }
+  }
+  ckpt_wait(ctx);
+
+  *nbite = iter;
+  free(W1);
+  free(W2);
+}
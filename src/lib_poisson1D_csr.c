@@ -0,0 +1,447 @@
+/**********************************************/
+/* lib_poisson1D_csr.c                        */
+/* Sparse storage (CSR, SELL-C-sigma) for the */
+/* Poisson 1D operators and iterative solvers */
+/**********************************************/
+#include "lib_poisson1D.h"
+
+int csr_alloc(csr_matrix *A, int n, int m, int nnz){
+  A->n = n;
+  A->m = m;
+  A->nnz = nnz;
+  A->rowptr = (int *) calloc(n+1, sizeof(int));
+  A->colind = (int *) malloc(sizeof(int)*(nnz > 0 ? nnz : 1));
+  A->val = (double *) malloc(sizeof(double)*(nnz > 0 ? nnz : 1));
+  if (A->rowptr == NULL || A->colind == NULL || A->val == NULL){
+    csr_free(A);
+    return -1;
+  }
+  return 0;
+}
+
+void csr_free(csr_matrix *A){
+  free(A->rowptr);
+  free(A->colind);
+  free(A->val);
+  A->rowptr = NULL;
+  A->colind = NULL;
+  A->val = NULL;
+  A->n = A->m = A->nnz = 0;
+}
+
+int GB2CSR_operator_colMajor(double *AB, int *lab, int *la, int *ku, int *kl, int *kv, csr_matrix *A){
+  int ii, jj, jmin, jmax, k;
+  double aij;
+
+  // Premier passage : comptage des coefficients non nuls
+  // Rk: A(i,j) est stocké en AB[j*lab + kv+ku+i-j] (convention LAPACK)
+  k = 0;
+  for (ii=0;ii<(*la);ii++){
+    jmin = (ii - *kl > 0) ? ii - *kl : 0;
+    jmax = (ii + *ku < *la-1) ? ii + *ku : *la-1;
+    for (jj=jmin;jj<=jmax;jj++){
+      if (AB[jj*(*lab) + *kv + *ku + ii - jj] != 0.0) k++;
+    }
+  }
+
+  if (csr_alloc(A, *la, *la, k) != 0){
+    printf("Erreur: allocation CSR impossible (nnz = %d)\n", k);
+    return -1;
+  }
+
+  // Second passage : remplissage ligne par ligne
+  k = 0;
+  for (ii=0;ii<(*la);ii++){
+    A->rowptr[ii] = k;
+    jmin = (ii - *kl > 0) ? ii - *kl : 0;
+    jmax = (ii + *ku < *la-1) ? ii + *ku : *la-1;
+    for (jj=jmin;jj<=jmax;jj++){
+      aij = AB[jj*(*lab) + *kv + *ku + ii - jj];
+      if (aij != 0.0){
+        A->colind[k] = jj;
+        A->val[k] = aij;
+        k++;
+      }
+    }
+  }
+  A->rowptr[*la] = k;
+  return 0;
+}
+
+/* Tri des triplets (ligne, colonne) pour l'assemblage */
+typedef struct {
+  int i;
+  int j;
+  double v;
+} aij_triplet;
+
+static int cmp_triplet(const void *a, const void *b){
+  const aij_triplet *ta = (const aij_triplet *) a;
+  const aij_triplet *tb = (const aij_triplet *) b;
+  if (ta->i != tb->i) return (ta->i < tb->i) ? -1 : 1;
+  if (ta->j != tb->j) return (ta->j < tb->j) ? -1 : 1;
+  return 0;
+}
+
+int read_AIJ_operator(char *filename, int *la, csr_matrix *A){
+  FILE *file;
+  aij_triplet *trip, *tmp;
+  int ntrip, cap, nrow, ncol, ii, jj, k, nnz;
+  double v;
+
+  file = fopen(filename, "r");
+  if (file == NULL){
+    perror(filename);
+    return -1;
+  }
+
+  // Lecture des triplets "i j v" (numérotation de 1 à la)
+  cap = 1024;
+  ntrip = 0;
+  nrow = 0;
+  ncol = 0;
+  trip = (aij_triplet *) malloc(sizeof(aij_triplet)*cap);
+  if (trip == NULL){
+    printf("Erreur: allocation des triplets impossible (%s)\n", filename);
+    fclose(file);
+    return -1;
+  }
+  while (fscanf(file, "%d %d %lf", &ii, &jj, &v) == 3){
+    if (ii < 1 || jj < 1){
+      printf("Erreur: indice invalide (%d,%d) dans %s\n", ii, jj, filename);
+      free(trip);
+      fclose(file);
+      return -1;
+    }
+    if (ntrip == cap){
+      // Pointeur temporaire : trip reste valide (et libéré) en cas d'échec
+      tmp = (aij_triplet *) realloc(trip, sizeof(aij_triplet)*2*cap);
+      if (tmp == NULL){
+        printf("Erreur: allocation de %d triplets impossible (%s)\n", 2*cap, filename);
+        free(trip);
+        fclose(file);
+        return -1;
+      }
+      trip = tmp;
+      cap *= 2;
+    }
+    trip[ntrip].i = ii-1;
+    trip[ntrip].j = jj-1;
+    trip[ntrip].v = v;
+    if (ii > nrow) nrow = ii;
+    if (jj > ncol) ncol = jj;
+    ntrip++;
+  }
+  fclose(file);
+
+  // La taille imposée par l'appelant prime si elle est fournie
+  if (*la > 0){
+    if (nrow > *la || ncol > *la){
+      printf("Erreur: %s contient des indices hors de [1,%d]\n", filename, *la);
+      free(trip);
+      return -1;
+    }
+    nrow = ncol = *la;
+  } else {
+    if (ncol > nrow) nrow = ncol;
+    ncol = nrow;
+    *la = nrow;
+  }
+
+  qsort(trip, ntrip, sizeof(aij_triplet), cmp_triplet);
+
+  // Fusion des doublons (sommés, comme en assemblage éléments finis)
+  nnz = 0;
+  for (k=0;k<ntrip;k++){
+    if (nnz > 0 && trip[nnz-1].i == trip[k].i && trip[nnz-1].j == trip[k].j){
+      trip[nnz-1].v += trip[k].v;
+    } else {
+      trip[nnz++] = trip[k];
+    }
+  }
+
+  if (csr_alloc(A, nrow, ncol, nnz) != 0){
+    free(trip);
+    return -1;
+  }
+  for (k=0;k<nnz;k++){
+    A->rowptr[trip[k].i+1]++;
+    A->colind[k] = trip[k].j;
+    A->val[k] = trip[k].v;
+  }
+  for (ii=0;ii<nrow;ii++){
+    A->rowptr[ii+1] += A->rowptr[ii];
+  }
+  free(trip);
+  return 0;
+}
+
+void csr_spmv(csr_matrix *A, double *x, double *y){
+  int ii, k;
+  #pragma omp parallel for private(k) schedule(static)
+  for (ii=0;ii<A->n;ii++){
+    double sum = 0.0;
+    for (k=A->rowptr[ii];k<A->rowptr[ii+1];k++){
+      sum += A->val[k] * x[A->colind[k]];
+    }
+    y[ii] = sum;
+  }
+}
+
+/* Clé de tri pour la fenêtre sigma : longueur de ligne décroissante */
+typedef struct {
+  int row;
+  int len;
+} sell_rowlen;
+
+static int cmp_rowlen(const void *a, const void *b){
+  const sell_rowlen *ra = (const sell_rowlen *) a;
+  const sell_rowlen *rb = (const sell_rowlen *) b;
+  if (ra->len != rb->len) return (ra->len > rb->len) ? -1 : 1;
+  return (ra->row < rb->row) ? -1 : (ra->row > rb->row);
+}
+
+int CSR2SELL(csr_matrix *A, int C, int sigma, sell_matrix *S){
+  int ii, jj, c, k, w, row, nchunks, off;
+  sell_rowlen *rl;
+
+  if (C < 1 || C > SELL_MAX_C || sigma < 1){
+    printf("Erreur: CSR2SELL attend 1 <= C <= %d et sigma >= 1\n", SELL_MAX_C);
+    return -1;
+  }
+  // sigma est arrondi au multiple de C supérieur
+  sigma = ((sigma + C - 1) / C) * C;
+
+  nchunks = (A->n + C - 1) / C;
+  S->n = A->n;
+  S->C = C;
+  S->sigma = sigma;
+  S->nchunks = nchunks;
+  S->perm = (int *) malloc(sizeof(int)*(nchunks*C));
+  S->chunkptr = (int *) malloc(sizeof(int)*(nchunks+1));
+  S->chunklen = (int *) malloc(sizeof(int)*(nchunks > 0 ? nchunks : 1));
+  S->colind = NULL;
+  S->val = NULL;
+
+  // Tri local des lignes par longueur dans chaque fenêtre de sigma lignes
+  rl = (sell_rowlen *) malloc(sizeof(sell_rowlen)*(A->n > 0 ? A->n : 1));
+  if (S->perm == NULL || S->chunkptr == NULL || S->chunklen == NULL || rl == NULL){
+    printf("Erreur: allocation SELL impossible (n = %d)\n", A->n);
+    free(rl);
+    sell_free(S);
+    return -1;
+  }
+  for (ii=0;ii<A->n;ii++){
+    rl[ii].row = ii;
+    rl[ii].len = A->rowptr[ii+1] - A->rowptr[ii];
+  }
+  for (ii=0;ii<A->n;ii+=sigma){
+    int len = (ii + sigma <= A->n) ? sigma : A->n - ii;
+    qsort(rl + ii, len, sizeof(sell_rowlen), cmp_rowlen);
+  }
+  for (ii=0;ii<nchunks*C;ii++){
+    S->perm[ii] = (ii < A->n) ? rl[ii].row : -1;
+  }
+
+  // Largeur de chaque chunk = plus longue ligne du chunk
+  off = 0;
+  for (c=0;c<nchunks;c++){
+    w = 0;
+    for (k=0;k<C;k++){
+      ii = c*C + k;
+      if (ii < A->n && rl[ii].len > w) w = rl[ii].len;
+    }
+    S->chunkptr[c] = off;
+    S->chunklen[c] = w;
+    off += w*C;
+  }
+  S->chunkptr[nchunks] = off;
+  free(rl);
+
+  S->colind = (int *) malloc(sizeof(int)*(off > 0 ? off : 1));
+  S->val = (double *) malloc(sizeof(double)*(off > 0 ? off : 1));
+  if (S->colind == NULL || S->val == NULL){
+    printf("Erreur: allocation SELL impossible (%d coefficients)\n", off);
+    sell_free(S);
+    return -1;
+  }
+
+  // Remplissage colonne par colonne dans le chunk (lignes contiguës)
+  // Le remplissage pointe sur la colonne 0 avec une valeur nulle
+  for (c=0;c<nchunks;c++){
+    for (jj=0;jj<S->chunklen[c];jj++){
+      for (k=0;k<C;k++){
+        int pos = S->chunkptr[c] + jj*C + k;
+        row = S->perm[c*C + k];
+        if (row >= 0 && jj < A->rowptr[row+1] - A->rowptr[row]){
+          S->colind[pos] = A->colind[A->rowptr[row] + jj];
+          S->val[pos] = A->val[A->rowptr[row] + jj];
+        } else {
+          S->colind[pos] = 0;
+          S->val[pos] = 0.0;
+        }
+      }
+    }
+  }
+  return 0;
+}
+
+void sell_free(sell_matrix *S){
+  free(S->perm);
+  free(S->chunkptr);
+  free(S->chunklen);
+  free(S->colind);
+  free(S->val);
+  S->perm = S->chunkptr = S->chunklen = S->colind = NULL;
+  S->val = NULL;
+  S->n = S->nchunks = 0;
+}
+
+void sell_spmv(sell_matrix *S, double *x, double *y){
+  int c;
+  #pragma omp parallel for schedule(static)
+  for (c=0;c<S->nchunks;c++){
+    double acc[SELL_MAX_C];
+    int jj, k;
+    int C = S->C;
+    const int *ci = S->colind + S->chunkptr[c];
+    const double *va = S->val + S->chunkptr[c];
+    for (k=0;k<C;k++) acc[k] = 0.0;
+    for (jj=0;jj<S->chunklen[c];jj++){
+      // Les C lignes du chunk sont traitées ensemble : boucle vectorisable
+      #pragma omp simd
+      for (k=0;k<C;k++){
+        acc[k] += va[jj*C + k] * x[ci[jj*C + k]];
+      }
+    }
+    for (k=0;k<C;k++){
+      int row = S->perm[c*C + k];
+      if (row >= 0) y[row] = acc[k];
+    }
+  }
+}
+
+void richardson_alpha_csr(csr_matrix *A, double *RHS, double *X, double *alpha_rich, double *tol, int *maxit, double *resvec, int *nbite){
+  int i;
+  int n = A->n;
+  double *R = (double *) malloc(sizeof(double)*n);
+  double norm_rhs = dot_repro(&n, RHS, RHS);
+
+  if (norm_rhs == 0.0) norm_rhs = 1.0;
+
+  *nbite = 0;
+  do {
+    csr_spmv(A, X, R);
+
+    #pragma omp parallel for schedule(static)
+    for (i=0;i<n;i++){
+      R[i] = RHS[i] - R[i];
+    }
+    // Norme par réduction déterministe, puis X = X + alpha * (RHS - AX)
+    resvec[*nbite] = sqrt(dot_repro(&n, R, R)/norm_rhs);
+    #pragma omp parallel for schedule(static)
+    for (i=0;i<n;i++){
+      X[i] += (*alpha_rich) * R[i];
+    }
+    (*nbite)++;
+  } while (*nbite < *maxit && resvec[*nbite-1] > *tol);
+
+  free(R);
+}
+
+/* Extraction de la diagonale, commune à Jacobi et Gauss-Seidel */
+static int csr_diag(csr_matrix *A, double *D){
+  int ii, k;
+  for (ii=0;ii<A->n;ii++){
+    D[ii] = 0.0;
+    for (k=A->rowptr[ii];k<A->rowptr[ii+1];k++){
+      if (A->colind[k] == ii) D[ii] = A->val[k];
+    }
+    if (D[ii] == 0.0){
+      printf("Erreur: diagonale nulle à la ligne %d\n", ii);
+      return ii+1;
+    }
+  }
+  return 0;
+}
+
+void jacobi_csr(csr_matrix *A, double *RHS, double *X, double *tol, int *maxit, double *resvec, int *nbite){
+  int n = A->n;
+  double *X_buf = (double *) malloc(sizeof(double)*n);
+  double *D = (double *) malloc(sizeof(double)*n);
+  double *X_cur = X;
+  double *X_new = X_buf;
+  double resid = 1.0;
+  int iter = 0;
+
+  resvec[0] = 1.0;
+  if (csr_diag(A, D) != 0){
+    *nbite = 0;
+    free(X_buf);
+    free(D);
+    return;
+  }
+
+  while (iter < *maxit && resid > *tol){
+    int ii;
+    double *tmp;
+    #pragma omp parallel for schedule(static)
+    for (ii=0;ii<n;ii++){
+      int k;
+      double sum = RHS[ii];
+      for (k=A->rowptr[ii];k<A->rowptr[ii+1];k++){
+        if (A->colind[k] != ii) sum -= A->val[k] * X_cur[A->colind[k]];
+      }
+      X_new[ii] = sum / D[ii];
+    }
+    resid = nrm2_diff_repro(&n, X_new, X_cur);
+    // Échange des pointeurs plutôt que recopie
+    tmp = X_cur; X_cur = X_new; X_new = tmp;
+    iter++;
+    resvec[iter] = resid;
+  }
+
+  // Le dernier itéré doit se trouver dans le tableau de l'appelant
+  if (X_cur != X){
+    memcpy(X, X_cur, sizeof(double)*n);
+  }
+  *nbite = iter;
+  free(X_buf);
+  free(D);
+}
+
+void gauss_seidel_csr(csr_matrix *A, double *RHS, double *X, double *tol, int *maxit, double *resvec, int *nbite){
+  int n = A->n;
+  double *AX = (double *) malloc(sizeof(double)*n);
+  double *D = (double *) malloc(sizeof(double)*n);
+  double resid = 1.0;
+  int iter = 0;
+
+  resvec[0] = 1.0;
+  if (csr_diag(A, D) != 0){
+    *nbite = 0;
+    free(AX);
+    free(D);
+    return;
+  }
+
+  while (iter < *maxit && resid > *tol){
+    int ii, k;
+    // Balayage séquentiel : la récurrence interdit le parallélisme direct
+    for (ii=0;ii<n;ii++){
+      double sum = RHS[ii];
+      for (k=A->rowptr[ii];k<A->rowptr[ii+1];k++){
+        if (A->colind[k] != ii) sum -= A->val[k] * X[A->colind[k]];
+      }
+      X[ii] = sum / D[ii];
+    }
+    csr_spmv(A, X, AX);
+    resid = nrm2_diff_repro(&n, RHS, AX);
+    iter++;
+    resvec[iter] = resid;
+  }
+
+  *nbite = iter;
+  free(AX);
+  free(D);
+}
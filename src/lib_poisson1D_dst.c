@@ -0,0 +1,383 @@
+/**********************************************/
+/* lib_poisson1D_dst.c                        */
+/* Fast spectral solver for the Poisson 1D    */
+/* operator: in-house mixed-radix FFT, DST-I  */
+/**********************************************/
+#include "lib_poisson1D.h"
+#include <omp.h>
+
+/* En dessous, un seul second membre est transformé par un seul thread */
+#define DST_PAR_MIN 4096
+
+/* Décomposition de N en facteurs, 4 en priorité puis 2, 3, 5, ... */
+static int fft_factorize(int N, int *fact){
+  int nf = 0, p = 4;
+  while (N > 1){
+    while (N % p != 0){
+      switch (p){
+      case 4: p = 2; break;
+      case 2: p = 3; break;
+      default: p += 2; break;
+      }
+      if (p*p > N) p = N;
+    }
+    N /= p;
+    fact[2*nf] = p;
+    fact[2*nf+1] = N;
+    nf++;
+  }
+  return nf;
+}
+
+/* Papillons : Fout contient p sous-transformées de taille m ; seuls les
+   indices k de [k0, k1) sont traités, indépendants entre eux */
+static void bfly2(double *Fout, const double *tw, int fstride, int m, int k0, int k1){
+  int k;
+  for (k=k0;k<k1;k++){
+    double *a = Fout + 2*k, *b = Fout + 2*(k+m);
+    double wr = tw[2*k*fstride], wi = tw[2*k*fstride+1];
+    double tr = b[0]*wr - b[1]*wi;
+    double ti = b[0]*wi + b[1]*wr;
+    b[0] = a[0] - tr; b[1] = a[1] - ti;
+    a[0] += tr;       a[1] += ti;
+  }
+}
+
+static void bfly4(double *Fout, const double *tw, int fstride, int m, int k0, int k1){
+  int k;
+  for (k=k0;k<k1;k++){
+    double *f0 = Fout + 2*k, *f1 = Fout + 2*(k+m);
+    double *f2 = Fout + 2*(k+2*m), *f3 = Fout + 2*(k+3*m);
+    const double *w1 = tw + 2*k*fstride, *w2 = tw + 4*k*fstride, *w3 = tw + 6*k*fstride;
+    double s0r = f1[0]*w1[0] - f1[1]*w1[1], s0i = f1[0]*w1[1] + f1[1]*w1[0];
+    double s1r = f2[0]*w2[0] - f2[1]*w2[1], s1i = f2[0]*w2[1] + f2[1]*w2[0];
+    double s2r = f3[0]*w3[0] - f3[1]*w3[1], s2i = f3[0]*w3[1] + f3[1]*w3[0];
+    double s5r = f0[0] - s1r, s5i = f0[1] - s1i;
+    double s3r = s0r + s2r, s3i = s0i + s2i;
+    double s4r = s0r - s2r, s4i = s0i - s2i;
+    f0[0] += s1r;        f0[1] += s1i;
+    f2[0] = f0[0] - s3r; f2[1] = f0[1] - s3i;
+    f0[0] += s3r;        f0[1] += s3i;
+    // Rotation de -i pour la transformée directe
+    f1[0] = s5r + s4i;   f1[1] = s5i - s4r;
+    f3[0] = s5r - s4i;   f3[1] = s5i + s4r;
+  }
+}
+
+static void bfly_generic(double *Fout, const double *tw, int fstride, int m, int p, int N, int k0, int k1){
+  int u, q1, q, k, twidx;
+  double stack_scratch[2*32];
+  double *scratch = (p <= 32) ? stack_scratch : (double *) malloc(sizeof(double)*2*p);
+  for (u=k0;u<k1;u++){
+    for (q1=0;q1<p;q1++){
+      scratch[2*q1] = Fout[2*(u+q1*m)];
+      scratch[2*q1+1] = Fout[2*(u+q1*m)+1];
+    }
+    for (q1=0;q1<p;q1++){
+      k = u + q1*m;
+      double sr = scratch[0], si = scratch[1];
+      twidx = 0;
+      for (q=1;q<p;q++){
+        twidx += fstride*k;
+        if (twidx >= N) twidx -= N*(twidx/N);
+        sr += scratch[2*q]*tw[2*twidx] - scratch[2*q+1]*tw[2*twidx+1];
+        si += scratch[2*q]*tw[2*twidx+1] + scratch[2*q+1]*tw[2*twidx];
+      }
+      Fout[2*k] = sr;
+      Fout[2*k+1] = si;
+    }
+  }
+  if (scratch != stack_scratch) free(scratch);
+}
+
+static void fft_bfly(const dst_plan *plan, double *Fout, int fstride, int m, int p, int k0, int k1){
+  switch (p){
+  case 2: bfly2(Fout, plan->tw, fstride, m, k0, k1); break;
+  case 4: bfly4(Fout, plan->tw, fstride, m, k0, k1); break;
+  default: bfly_generic(Fout, plan->tw, fstride, m, p, plan->L, k0, k1); break;
+  }
+}
+
+/* FFT récursive par décimation temporelle (entrée strided, sortie contiguë) */
+static void fft_work(const dst_plan *plan, double *Fout, const double *f, int fstride, const int *fact){
+  int p = fact[0], m = fact[1], q;
+  double *Fbeg = Fout;
+  if (m == 1){
+    for (q=0;q<p;q++){
+      Fout[2*q] = f[2*q*fstride];
+      Fout[2*q+1] = f[2*q*fstride+1];
+    }
+  } else {
+    for (q=0;q<p;q++){
+      fft_work(plan, Fout + 2*q*m, f + 2*q*fstride, fstride*p, fact+2);
+    }
+  }
+  Fout = Fbeg;
+  fft_bfly(plan, Fout, fstride, m, p, 0, m);
+}
+
+/* Intervalle [lo, hi) de [0, n) du thread courant (tout [0, n) hors équipe) */
+static void team_range(int n, int par, int *lo, int *hi){
+  if (par){
+    poisson1D_partition(&n, omp_get_num_threads(), omp_get_thread_num(), lo, hi);
+  } else {
+    *lo = 0;
+    *hi = n;
+  }
+}
+
+/* FFT de taille L par toute l'équipe : les p*p2 sous-transformées des deux
+   premiers niveaux de la récursion sont réparties entre les threads, puis
+   les papillons de ces deux niveaux, indice k par indice k */
+static void fft_work_team(const dst_plan *plan, double *Fout, const double *f, int par){
+  int p = plan->fact[0], m = plan->fact[1], p2, m2, q, q1, lo, hi;
+  if (!par || plan->nfact < 3){
+    if (par){
+      #pragma omp single
+      fft_work(plan, Fout, f, 1, plan->fact);
+    } else {
+      fft_work(plan, Fout, f, 1, plan->fact);
+    }
+    return;
+  }
+  p2 = plan->fact[2];
+  m2 = plan->fact[3];
+  team_range(p*p2, par, &lo, &hi);
+  for (q=lo;q<hi;q++){
+    q1 = q / p2;
+    fft_work(plan, Fout + 2*(q1*m + (q % p2)*m2), f + 2*(q1 + (q % p2)*p), p*p2, plan->fact+4);
+  }
+  #pragma omp barrier
+  // Second niveau : p groupes de m2 papillons indépendants
+  team_range(p*m2, par, &lo, &hi);
+  for (q1=lo/m2;q1<p && q1*m2<hi;q1++){
+    int k0 = (lo > q1*m2) ? lo - q1*m2 : 0, k1 = (hi < (q1+1)*m2) ? hi - q1*m2 : m2;
+    fft_bfly(plan, Fout + 2*q1*m, p, m2, p2, k0, k1);
+  }
+  #pragma omp barrier
+  team_range(m, par, &lo, &hi);
+  fft_bfly(plan, Fout, 1, m, p, lo, hi);
+  #pragma omp barrier
+}
+
+/* FFT de taille M : directe, ou par Bluestein (convolution de taille L) ;
+   avec par, appelée par toute l'équipe sur Z, z et work partagés */
+static void fft_apply(const dst_plan *plan, double *Z, const double *z, double *work, int par){
+  int M = plan->M, L = plan->L, k, lo, hi;
+  double *a, *A;
+  if (L == M){
+    fft_work_team(plan, Z, z, par);
+    return;
+  }
+  a = work;
+  A = work + 2*L;
+  // a_j = z_j c_j, complété par des zéros
+  team_range(L, par, &lo, &hi);
+  for (k=lo;k<hi;k++){
+    if (k < M){
+      a[2*k] = z[2*k]*plan->chirp[2*k] - z[2*k+1]*plan->chirp[2*k+1];
+      a[2*k+1] = z[2*k]*plan->chirp[2*k+1] + z[2*k+1]*plan->chirp[2*k];
+    } else {
+      a[2*k] = a[2*k+1] = 0.0;
+    }
+  }
+  if (par){
+    #pragma omp barrier
+  }
+  fft_work_team(plan, A, a, par);
+  // Produit par la transformée du noyau, conjugué pour la FFT inverse
+  for (k=lo;k<hi;k++){
+    double re = A[2*k]*plan->bfft[2*k] - A[2*k+1]*plan->bfft[2*k+1];
+    double im = A[2*k]*plan->bfft[2*k+1] + A[2*k+1]*plan->bfft[2*k];
+    A[2*k] = re;
+    A[2*k+1] = -im;
+  }
+  if (par){
+    #pragma omp barrier
+  }
+  fft_work_team(plan, a, A, par);
+  // X_k = c_k conj(a_k)/L
+  team_range(M, par, &lo, &hi);
+  for (k=lo;k<hi;k++){
+    double re = a[2*k]/L, im = -a[2*k+1]/L;
+    Z[2*k] = re*plan->chirp[2*k] - im*plan->chirp[2*k+1];
+    Z[2*k+1] = re*plan->chirp[2*k+1] + im*plan->chirp[2*k];
+  }
+  if (par){
+    #pragma omp barrier
+  }
+}
+
+int dst_plan_create(dst_plan *plan, int *la){
+  int k, M, L, maxp;
+  if (*la < 1){
+    printf("Erreur: dst_plan_create attend la >= 1\n");
+    return -1;
+  }
+  M = *la + 1;
+  plan->n = *la;
+  plan->M = M;
+  plan->nfact = fft_factorize(M, plan->fact);
+  plan->chirp = NULL;
+  plan->bfft = NULL;
+
+  // Un grand facteur premier rendrait le papillon générique en O(M p) :
+  // on passe alors par l'algorithme de Bluestein sur une FFT de taille 2^q
+  maxp = 1;
+  for (k=0;k<plan->nfact;k++){
+    if (plan->fact[2*k] > maxp) maxp = plan->fact[2*k];
+  }
+  plan->L = M;
+  if (maxp > DST_MAX_RADIX){
+    L = 1;
+    while (L < 2*M-1) L *= 2;
+    plan->L = L;
+    plan->nfact = fft_factorize(L, plan->fact);
+  }
+
+  plan->tw = (double *) malloc(sizeof(double)*2*plan->L);
+  plan->twr = (double *) malloc(sizeof(double)*2*M);
+  plan->eig = (double *) malloc(sizeof(double)*(*la));
+  if (plan->L != M){
+    plan->chirp = (double *) malloc(sizeof(double)*2*M);
+    plan->bfft = (double *) malloc(sizeof(double)*2*plan->L);
+  }
+  if (plan->tw == NULL || plan->twr == NULL || plan->eig == NULL
+      || (plan->L != M && (plan->chirp == NULL || plan->bfft == NULL))){
+    dst_plan_free(plan);
+    return -1;
+  }
+  // Facteurs de phase de la FFT complexe de taille L : exp(-2i pi k/L)
+  for (k=0;k<plan->L;k++){
+    plan->tw[2*k] = cos(2.0*M_PI*k/plan->L);
+    plan->tw[2*k+1] = -sin(2.0*M_PI*k/plan->L);
+  }
+  // Facteurs du post-traitement réel de taille 2M : exp(-i pi k/M)
+  for (k=0;k<M;k++){
+    plan->twr[2*k] = cos(M_PI*k/M);
+    plan->twr[2*k+1] = -sin(M_PI*k/M);
+  }
+  if (plan->L != M){
+    // Chirp c_k = exp(-i pi k^2/M), k^2 réduit modulo 2M pour la précision
+    for (k=0;k<M;k++){
+      long long k2 = ((long long) k * k) % (2LL*M);
+      plan->chirp[2*k] = cos(M_PI*k2/M);
+      plan->chirp[2*k+1] = -sin(M_PI*k2/M);
+    }
+    // Transformée du noyau de convolution b_m = conj(c_|m|)
+    double *b = (double *) calloc(2*plan->L, sizeof(double));
+    for (k=0;k<M;k++){
+      b[2*k] = plan->chirp[2*k];
+      b[2*k+1] = -plan->chirp[2*k+1];
+      if (k > 0){
+        b[2*(plan->L-k)] = plan->chirp[2*k];
+        b[2*(plan->L-k)+1] = -plan->chirp[2*k+1];
+      }
+    }
+    fft_work(plan, plan->bfft, b, 1, plan->fact);
+    free(b);
+  }
+  eig_poisson1D(plan->eig, la);
+  return 0;
+}
+
+void dst_plan_free(dst_plan *plan){
+  free(plan->tw);
+  free(plan->twr);
+  free(plan->eig);
+  free(plan->chirp);
+  free(plan->bfft);
+  plan->tw = plan->twr = plan->eig = plan->chirp = plan->bfft = NULL;
+  plan->n = plan->M = plan->L = plan->nfact = 0;
+}
+
+int dst_plan_worksize(const dst_plan *plan){
+  return 4*plan->M + 4*plan->L;
+}
+
+
+/* DST-I de x ; avec par, toute l'équipe transforme le même x (work partagé) */
+static void dst1_apply_team(const dst_plan *plan, double *x, double *work, int par){
+  int M = plan->M, j, k, lo, hi;
+  double *z = work;          // M complexes : signal pair/impair entrelacé
+  double *Z = work + 2*M;    // M complexes : transformée de z
+
+  // Prolongement impair v (taille 2M) replié en z_j = v_2j + i v_2j+1
+  // avec v_0 = v_M = 0, v_j = x_j et v_{2M-j} = -x_j (x indicé de 1 à n)
+  team_range(M, par, &lo, &hi);
+  for (j=lo;j<hi;j++){
+    int e = 2*j, o = 2*j+1;
+    z[2*j] = (e == 0 || e == M) ? 0.0 : (e < M ? x[e-1] : -x[2*M-e-1]);
+    z[2*j+1] = (o == M) ? 0.0 : (o < M ? x[o-1] : -x[2*M-o-1]);
+  }
+  if (par){
+    #pragma omp barrier
+  }
+  fft_apply(plan, Z, z, work + 4*M, par);
+
+  // Post-traitement réel : V_k = (Z_k + conj(Z_{M-k}))/2 - i/2 w^k (Z_k - conj(Z_{M-k}))
+  // puis y_k = -Im(V_k)/2 pour k = 1..n
+  team_range(M-1, par, &lo, &hi);
+  for (k=lo+1;k<hi+1;k++){
+    double ar = Z[2*k],       ai = Z[2*k+1];
+    double br = Z[2*(M-k)],   bi = -Z[2*(M-k)+1];
+    double ei = 0.5*(ai + bi);
+    double dr = 0.5*(ar - br), di = 0.5*(ai - bi);
+    double wr = plan->twr[2*k], wi = plan->twr[2*k+1];
+    // -i * w * d
+    double ti = -(wr*dr - wi*di);
+    x[k-1] = -0.5*(ei + ti);
+  }
+  if (par){
+    #pragma omp barrier
+  }
+}
+
+void dst1_apply(const dst_plan *plan, double *x, double *work){
+  dst1_apply_team(plan, x, work, 0);
+}
+
+void poisson1D_dst_solve(dst_plan *plan, double *RHS, int *nrhs, int *ldrhs, double *diag, double *offdiag){
+  int n = plan->n, r, k;
+  double scale = 2.0/(plan->n + 1);
+  double *lambda = plan->eig;
+
+  // Valeurs propres de tridiag(offdiag, diag, offdiag), une fois par appel
+  if (diag != NULL){
+    lambda = (double *) malloc(sizeof(double)*n);
+    for (k=0;k<n;k++){
+      lambda[k] = *diag + 2.0*(*offdiag)*cos((k+1)*M_PI/(n+1));
+    }
+  }
+
+  // A = S diag(lambda) S * 2/(n+1) : u = S (S b / lambda) * 2/(n+1)
+  if (*nrhs > 1){
+    // Un second membre par thread
+    #pragma omp parallel private(k)
+    {
+      double *work = (double *) malloc(sizeof(double)*dst_plan_worksize(plan));
+      #pragma omp for schedule(static)
+      for (r=0;r<*nrhs;r++){
+        double *b = RHS + (long) r * (*ldrhs);
+        dst1_apply_team(plan, b, work, 0);
+        for (k=0;k<n;k++) b[k] *= scale / lambda[k];
+        dst1_apply_team(plan, b, work, 0);
+      }
+      free(work);
+    }
+  } else if (*nrhs == 1){
+    // Un seul second membre : toute l'équipe dans chaque transformée
+    double *work = (double *) malloc(sizeof(double)*dst_plan_worksize(plan));
+    #pragma omp parallel if(n >= DST_PAR_MIN)
+    {
+      int lo, hi, kk;
+      dst1_apply_team(plan, RHS, work, 1);
+      team_range(n, 1, &lo, &hi);
+      for (kk=lo;kk<hi;kk++) RHS[kk] *= scale / lambda[kk];
+      #pragma omp barrier
+      dst1_apply_team(plan, RHS, work, 1);
+    }
+    free(work);
+  }
+  if (diag != NULL) free(lambda);
+}
@@ -0,0 +1,218 @@
+/**********************************************/
+/* lib_poisson1D_grid.c                       */
+/* Non-uniform grids: variable-spacing        */
+/* operator and error-driven refinement       */
+/**********************************************/
+#include "lib_poisson1D.h"
+
+/* Grille resserrée aux deux bords : x(s) = (1 - tanh(beta(1-2s))/tanh(beta))/2 */
+void set_grid_points_stretched_1D(double* x, int* la, double* beta){
+  double tb = tanh(*beta);
+  int jj;
+  // beta -> 0 : la grille tend vers la grille uniforme (écart en O(beta^2)),
+  // et le quotient 0/0 donnerait NaN en beta = 0
+  if (fabs(*beta) < 1e-8){
+    set_grid_points_1D(x, la);
+    return;
+  }
+  for (jj=0;jj<(*la);jj++){
+    double s = (jj+1)/(1.0*((*la)+1));
+    x[jj] = 0.5*(1.0 - tanh((*beta)*(1.0 - 2.0*s))/tb);
+  }
+}
+
+/* Grille géométrique depuis x=0 : h_i = h_0 r^i, la+1 intervalles */
+void set_grid_points_graded_1D(double* x, int* la, double* ratio){
+  int n = (*la) + 1, jj;
+  double r = *ratio, h, s = 0.0;
+  h = (fabs(r - 1.0) < 1e-14) ? 1.0/n : (r - 1.0)/(pow(r, n) - 1.0);
+  for (jj=0;jj<(*la);jj++){
+    s += h;
+    x[jj] = s;
+    h *= r;
+  }
+}
+
+/* Une grille fournie par l'utilisateur doit être strictement croissante dans ]0,1[ */
+int check_grid_points_1D(double* x, int* la){
+  int jj;
+  for (jj=0;jj<(*la);jj++){
+    double prev = (jj > 0) ? x[jj-1] : 0.0;
+    if (!(x[jj] > prev) || !(x[jj] < 1.0)) return jj+1;
+  }
+  return 0;
+}
+
+/* Opérateur à pas variable, forme symétrique (volumes finis) :
+   ligne i = [-1/h_{i-1}, 1/h_{i-1} + 1/h_i, -1/h_i], h_i = x_{i+1} - x_i,
+   x_{-1} = 0 et x_la = 1. Sur une grille uniforme : [-1 2 -1]/h */
+void set_GB_operator_colMajor_poisson1D_nonuniform(double* AB, int *lab, int *la, double *x, int *kv){
+  int ii, jj, kk;
+  for (jj=0;jj<(*la);jj++){
+    double xl = (jj > 0) ? x[jj-1] : 0.0;
+    double xr = (jj < (*la)-1) ? x[jj+1] : 1.0;
+    double il = 1.0/(x[jj] - xl), ir = 1.0/(xr - x[jj]);
+    kk = jj*(*lab);
+    for (ii=0;ii<(*lab);ii++){
+      AB[kk+ii]=0.0;
+    }
+    if (jj > 0) AB[kk+ *kv]=-il;
+    AB[kk+ *kv+1]=il + ir;
+    if (jj < (*la)-1) AB[kk+ *kv+2]=-ir;
+  }
+}
+
+/* Second membre associé : (h_{i-1} + h_i)/2 f(x_i), plus les conditions de Dirichlet.
+   f peut être NULL (équation de la chaleur sans source) */
+void set_dense_RHS_nonuniform_1D(double* RHS, int* la, double *x, poisson1D_source f, void *ctx, double* BC0, double* BC1){
+  int jj;
+  for (jj=0;jj<(*la);jj++){
+    double xl = (jj > 0) ? x[jj-1] : 0.0;
+    double xr = (jj < (*la)-1) ? x[jj+1] : 1.0;
+    RHS[jj] = (f != NULL) ? 0.5*(xr - xl)*f(x[jj], ctx) : 0.0;
+  }
+  RHS[0] += (*BC0)/x[0];
+  RHS[(*la)-1] += (*BC1)/(1.0 - x[(*la)-1]);
+}
+
+/* Résolution par dgbsv en correction : X contient une estimation initiale
+   (solution précédente interpolée), on résout A e = b - A X puis X += e.
+   La correction étant petite, l'erreur d'arrondi l'est aussi sur les grilles
+   très étirées ; une étape de raffinement itératif suit. */
+static int solve_defect(double *AB, double *LU, double *RHS, double *X, double *R, int *ipiv, int la){
+  int lab = 4, kv = 1, ku = 1, kl = 1, NRHS = 1, info = 0, it, jj;
+  double one = 1.0, mone = -1.0;
+  int inc = 1;
+  memcpy(LU, AB, sizeof(double)*lab*la);
+  dgbtrf_(&la, &la, &kl, &ku, LU, &lab, ipiv, &info);
+  if (info != 0) return info;
+  for (it=0;it<2;it++){
+    for (jj=0;jj<la;jj++) R[jj] = RHS[jj];
+    cblas_dgbmv(CblasColMajor, CblasNoTrans, la, la, kl, ku, mone, AB + kv, lab, X, inc, one, R, inc);
+    dgbtrs_("N", &la, &kl, &ku, &NRHS, LU, &lab, ipiv, R, &la, &info);
+    for (jj=0;jj<la;jj++) X[jj] += R[jj];
+  }
+  return info;
+}
+
+/* Indicateur d'erreur de l'intervalle [x_k, x_{k+1}] (k = 0..la, bords compris) :
+   erreur d'interpolation h^2 |u''| / 8, u'' estimée par différences divisées
+   de la solution discrète et par -f (aux extrémités et au milieu), qui seule
+   détecte une couche limite que la grille courante ne résout pas */
+static double d2u(double *xg, double *ug, int i){
+  double hl = xg[i] - xg[i-1], hr = xg[i+1] - xg[i];
+  return 2.0*((ug[i+1] - ug[i])/hr - (ug[i] - ug[i-1])/hl)/(hl + hr);
+}
+
+int poisson1D_adaptive(poisson1D_source f, void *ctx, double *BC0, double *BC1, double *tol,
+                       int la0, int maxla, int maxlevel, double **xout, double **uout, int *laout, int *nlevel){
+  int la = la0, level, jj, k, info = 0;
+  double *x = (double *) malloc(sizeof(double)*la);
+  double *u = (double *) calloc(la, sizeof(double));
+  double *xg, *ug, *eta;
+
+  *xout = NULL;
+  *uout = NULL;
+  *laout = 0;
+  *nlevel = 0;
+  if (x == NULL || u == NULL){
+    printf("Erreur: allocation de la grille adaptative impossible (la = %d)\n", la);
+    free(x); free(u);
+    return -1;
+  }
+  set_grid_points_1D(x, &la);
+  // Premier niveau : départ à froid depuis l'interpolé linéaire des conditions aux limites
+  for (jj=0;jj<la;jj++) u[jj] = (*BC0) + x[jj]*((*BC1) - (*BC0));
+
+  for (level=0;level<maxlevel;level++){
+    int lab = 4, kv = 1, nref = 0, lanew;
+    double *AB = (double *) malloc(sizeof(double)*lab*la);
+    double *LU = (double *) malloc(sizeof(double)*lab*la);
+    double *RHS = (double *) malloc(sizeof(double)*la);
+    double *R = (double *) malloc(sizeof(double)*la);
+    int *ipiv = (int *) malloc(sizeof(int)*la);
+    double *xn, *un;
+
+    if (AB == NULL || LU == NULL || RHS == NULL || R == NULL || ipiv == NULL){
+      printf("Erreur: allocation du niveau %d impossible (la = %d)\n", level, la);
+      free(AB); free(LU); free(RHS); free(R); free(ipiv);
+      info = -1;
+      break;
+    }
+    set_GB_operator_colMajor_poisson1D_nonuniform(AB, &lab, &la, x, &kv);
+    set_dense_RHS_nonuniform_1D(RHS, &la, x, f, ctx, BC0, BC1);
+    info = solve_defect(AB, LU, RHS, u, R, ipiv, la);
+    free(AB); free(LU); free(RHS); free(R); free(ipiv);
+    if (info != 0) break;
+
+    // Grille étendue aux bords : xg[0] = 0, xg[la+1] = 1
+    xg = (double *) malloc(sizeof(double)*(la+2));
+    ug = (double *) malloc(sizeof(double)*(la+2));
+    eta = (double *) malloc(sizeof(double)*(la+1));
+    if (xg == NULL || ug == NULL || eta == NULL){
+      printf("Erreur: allocation de l'estimateur impossible (la = %d)\n", la);
+      free(xg); free(ug); free(eta);
+      info = -1;
+      break;
+    }
+    xg[0] = 0.0; ug[0] = *BC0;
+    xg[la+1] = 1.0; ug[la+1] = *BC1;
+    memcpy(xg+1, x, sizeof(double)*la);
+    memcpy(ug+1, u, sizeof(double)*la);
+    for (k=0;k<=la;k++){
+      double h = xg[k+1] - xg[k];
+      double c = 0.0;
+      if (k > 0) c = fabs(d2u(xg, ug, k));
+      if (k < la) c = fmax(c, fabs(d2u(xg, ug, k+1)));
+      if (f != NULL){
+        c = fmax(c, fabs(f(xg[k], ctx)));
+        c = fmax(c, fabs(f(0.5*(xg[k] + xg[k+1]), ctx)));
+        c = fmax(c, fabs(f(xg[k+1], ctx)));
+      }
+      eta[k] = h*h*c/8.0;
+      if (eta[k] > *tol) nref++;
+    }
+    // Dernier niveau : u est la solution discrète sur x, on ne raffine plus
+    // (les nœuds ajoutés ne seraient qu'interpolés, jamais résolus)
+    if (nref == 0 || la + nref > maxla || level == maxlevel-1){
+      free(xg); free(ug); free(eta);
+      level++;
+      break;
+    }
+
+    // Bisection des intervalles marqués ; solution précédente interpolée
+    // linéairement aux nouveaux nœuds (départ à chaud du niveau suivant)
+    lanew = la + nref;
+    xn = (double *) malloc(sizeof(double)*lanew);
+    un = (double *) malloc(sizeof(double)*lanew);
+    if (xn == NULL || un == NULL){
+      printf("Erreur: allocation du niveau %d impossible (la = %d)\n", level+1, lanew);
+      free(xn); free(un); free(xg); free(ug); free(eta);
+      info = -1;
+      break;
+    }
+    jj = 0;
+    for (k=0;k<=la;k++){
+      if (eta[k] > *tol){
+        xn[jj] = 0.5*(xg[k] + xg[k+1]);
+        un[jj] = 0.5*(ug[k] + ug[k+1]);
+        jj++;
+      }
+      if (k < la){
+        xn[jj] = xg[k+1];
+        un[jj] = ug[k+1];
+        jj++;
+      }
+    }
+    free(x); free(u); free(xg); free(ug); free(eta);
+    x = xn;
+    u = un;
+    la = lanew;
+  }
+
+  *xout = x;
+  *uout = u;
+  *laout = la;
+  *nlevel = level;
+  return info;
+}
@@ -0,0 +1,349 @@
+/**********************************************/
+/* lib_poisson1D_krylov.c                     */
+/* Convection-diffusion operator, GMRES(m)    */
+/* and BiCGStab with fused tridiagonal        */
+/* kernels and a preallocated workspace       */
+/**********************************************/
+#include "lib_poisson1D.h"
+
+/* Mêmes blocs fixes que lib_poisson1D_reduce.c : produits scalaires
+   reproductibles quel que soit le nombre de threads */
+#define KRY_BLOCK 2048
+
+/* -u'' + v u' = f, discrétisé sur la grille uniforme et multiplié par h^2
+   comme [-1 2 -1] : Pe = v h / 2 est le nombre de Péclet de maille.
+   Centré : [-1-Pe, 2, -1+Pe] ; décentré amont (v > 0) : [-1-2Pe, 2+2Pe, -1] */
+static void convdiff_stencil(int *la, double *v, int scheme, double *lo, double *di, double *up){
+  double h = 1.0/(1.0*((*la)+1));
+  double pe = 0.5*(*v)*h;
+  if (scheme == CONVDIFF_UPWIND){
+    if (pe >= 0.0){
+      *lo = -1.0 - 2.0*pe; *di = 2.0 + 2.0*pe; *up = -1.0;
+    } else {
+      *lo = -1.0; *di = 2.0 - 2.0*pe; *up = -1.0 + 2.0*pe;
+    }
+  } else {
+    *lo = -1.0 - pe; *di = 2.0; *up = -1.0 + pe;
+  }
+}
+
+void set_GB_operator_colMajor_convdiff(double* AB, int *lab, int *la, int *kv, double *v, int scheme){
+  double lo, di, up;
+  int ii, jj, kk;
+  convdiff_stencil(la, v, scheme, &lo, &di, &up);
+  for (jj=0;jj<(*la);jj++){
+    kk = jj*(*lab);
+    for (ii=0;ii<(*lab);ii++){
+      AB[kk+ii]=0.0;
+    }
+    if (jj > 0) AB[kk+ *kv]=up;           // A(j-1,j)
+    AB[kk+ *kv+1]=di;
+    if (jj < (*la)-1) AB[kk+ *kv+2]=lo;   // A(j+1,j)
+  }
+}
+
+void set_dense_RHS_DBC_convdiff(double* RHS, int* la, double *v, int scheme, double* BC0, double* BC1){
+  double lo, di, up;
+  int jj;
+  convdiff_stencil(la, v, scheme, &lo, &di, &up);
+  for (jj=0;jj<(*la);jj++){
+    RHS[jj]=0.0;
+  }
+  RHS[0] -= lo*(*BC0);
+  RHS[(*la)-1] -= up*(*BC1);
+}
+
+/* u(x) = T0 + (T1-T0) (e^{vx} - 1)/(e^v - 1), forme stable pour v grand */
+void set_analytical_solution_convdiff(double* EX_SOL, double* X, int* la, double *v, double* BC0, double* BC1){
+  double dt = (*BC1) - (*BC0), w = *v;
+  int jj;
+  for (jj=0;jj<(*la);jj++){
+    double s;
+    if (fabs(w) < 1e-12) s = X[jj];
+    else if (w > 0.0) s = exp(w*(X[jj] - 1.0))*expm1(-w*X[jj])/expm1(-w);
+    else s = expm1(w*X[jj])/expm1(w);
+    EX_SOL[jj] = (*BC0) + dt*s;
+  }
+}
+
+/* Diagonales contiguës : le balayage lit trois flux séquentiels */
+int krylov_ws_init(krylov_ws *ws, double *AB, int *lab, int *la, int *kv, int *m, int prec){
+  int n = *la, i, mm = (*m > 0) ? *m : 30;
+  int nb = (n + KRY_BLOCK - 1)/KRY_BLOCK;
+  memset(ws, 0, sizeof(krylov_ws));
+  ws->n = n;
+  ws->m = mm;
+  ws->prec = prec;
+  ws->dl = (double *) calloc(n, sizeof(double));
+  ws->d = (double *) malloc(sizeof(double)*n);
+  ws->du = (double *) calloc(n, sizeof(double));
+  ws->pl = (double *) calloc(n, sizeof(double));
+  ws->pu = (double *) malloc(sizeof(double)*n);
+  ws->V = (double *) malloc(sizeof(double)*(size_t) n*(mm+1));
+  ws->Z = (double *) malloc(sizeof(double)*(size_t) n*8);
+  ws->H = (double *) calloc((size_t) (mm+1)*mm, sizeof(double));
+  ws->hv = (double *) malloc(sizeof(double)*4*(mm+1));
+  ws->partial = (double *) malloc(sizeof(double)*(size_t) nb*((mm+1 > 4) ? mm+1 : 4));
+  if (ws->dl == NULL || ws->d == NULL || ws->du == NULL || ws->pl == NULL || ws->pu == NULL
+      || ws->V == NULL || ws->Z == NULL || ws->H == NULL || ws->hv == NULL || ws->partial == NULL){
+    krylov_ws_free(ws);
+    return -1;
+  }
+  for (i=0;i<n;i++){
+    if (i > 0) ws->dl[i] = AB[(i-1)*(*lab) + *kv+2];
+    ws->d[i] = AB[i*(*lab) + *kv+1];
+    if (i < n-1) ws->du[i] = AB[(i+1)*(*lab) + *kv];
+  }
+  // ILU(0) d'une tridiagonale : pas de remplissage, c'est la factorisation LU
+  // exacte ; pl = multiplicateurs de L, pu = 1/pivots de U
+  if (prec == KRYLOV_PREC_ILU0){
+    double piv = ws->d[0];
+    for (i=0;i<n;i++){
+      if (i > 0){
+        ws->pl[i] = ws->dl[i]/piv;
+        piv = ws->d[i] - ws->pl[i]*ws->du[i-1];
+      }
+      if (piv == 0.0){
+        printf("Erreur: pivot nul dans ILU(0) à la ligne %d\n", i);
+        krylov_ws_free(ws);
+        return i+1;
+      }
+      ws->pu[i] = 1.0/piv;
+    }
+  } else {
+    for (i=0;i<n;i++) ws->pu[i] = (prec == KRYLOV_PREC_JACOBI) ? 1.0/ws->d[i] : 1.0;
+  }
+  return 0;
+}
+
+void krylov_ws_free(krylov_ws *ws){
+  free(ws->dl); free(ws->d); free(ws->du);
+  free(ws->pl); free(ws->pu);
+  free(ws->V); free(ws->Z); free(ws->H); free(ws->hv); free(ws->partial);
+  memset(ws, 0, sizeof(krylov_ws));
+}
+
+/* z = M^-1 r */
+static void prec_apply(krylov_ws *ws, const double *r, double *z){
+  int n = ws->n, i;
+  if (ws->prec == KRYLOV_PREC_ILU0){
+    z[0] = r[0];
+    for (i=1;i<n;i++) z[i] = r[i] - ws->pl[i]*z[i-1];
+    z[n-1] *= ws->pu[n-1];
+    for (i=n-2;i>=0;i--) z[i] = (z[i] - ws->du[i]*z[i+1])*ws->pu[i];
+  } else if (ws->prec == KRYLOV_PREC_JACOBI){
+    #pragma omp parallel for schedule(static) if(n > 100000)
+    for (i=0;i<n;i++) z[i] = r[i]*ws->pu[i];
+  } else if (z != r){
+    memcpy(z, r, sizeof(double)*n);
+  }
+}
+
+static double pairwise(double *p, int nb, int stride){
+  int s, k;
+  for (s=1;s<nb;s*=2){
+    for (k=0;k+s<nb;k+=2*s) p[k*stride] += p[(k+s)*stride];
+  }
+  return (nb > 0) ? p[0] : 0.0;
+}
+
+/* y = A x, et en même passe ndot produits (y, w_k) ; w = NULL : (y, y) */
+static void matvec_dots(krylov_ws *ws, const double *x, double *y, int ndot, double **w, double *dots){
+  int n = ws->n, nb = (n + KRY_BLOCK - 1)/KRY_BLOCK, b, k;
+  double *part = ws->partial;
+  #pragma omp parallel for schedule(static) if(nb >= 8)
+  for (b=0;b<nb;b++){
+    int lo = b*KRY_BLOCK, hi = (lo + KRY_BLOCK < n) ? lo + KRY_BLOCK : n, i, q;
+    double acc[4] = {0.0, 0.0, 0.0, 0.0};
+    for (i=lo;i<hi;i++){
+      double v = ws->d[i]*x[i];
+      if (i > 0) v += ws->dl[i]*x[i-1];
+      if (i < n-1) v += ws->du[i]*x[i+1];
+      y[i] = v;
+      for (q=0;q<ndot;q++) acc[q] += v*((w[q] != NULL) ? w[q][i] : v);
+    }
+    for (q=0;q<ndot;q++) part[b*4 + q] = acc[q];
+  }
+  for (k=0;k<ndot;k++) dots[k] = pairwise(part + k, nb, 4);
+}
+
+/* h_k = (V_k, w) pour k = 0..nv-1, en une seule passe sur w */
+static void multi_dot(krylov_ws *ws, int nv, const double *w, double *h){
+  int n = ws->n, nb = (n + KRY_BLOCK - 1)/KRY_BLOCK, b, k, stride = ws->m + 1;
+  double *part = ws->partial;
+  #pragma omp parallel for schedule(static) if(nb >= 8)
+  for (b=0;b<nb;b++){
+    int lo = b*KRY_BLOCK, hi = (lo + KRY_BLOCK < n) ? lo + KRY_BLOCK : n, i, q;
+    for (q=0;q<nv;q++){
+      const double *v = ws->V + (size_t) q*n;
+      double s = 0.0;
+      for (i=lo;i<hi;i++) s += v[i]*w[i];
+      part[b*stride + q] = s;
+    }
+  }
+  for (k=0;k<nv;k++) h[k] = pairwise(part + k, nb, stride);
+}
+
+/* w -= V h, puis renvoie ||w||^2, en une passe */
+static double multi_axpy_nrm(krylov_ws *ws, int nv, double *w, const double *h){
+  int n = ws->n, nb = (n + KRY_BLOCK - 1)/KRY_BLOCK, b, stride = ws->m + 1;
+  double *part = ws->partial;
+  #pragma omp parallel for schedule(static) if(nb >= 8)
+  for (b=0;b<nb;b++){
+    int lo = b*KRY_BLOCK, hi = (lo + KRY_BLOCK < n) ? lo + KRY_BLOCK : n, i, q;
+    double s = 0.0;
+    for (i=lo;i<hi;i++){
+      double v = w[i];
+      for (q=0;q<nv;q++) v -= h[q]*ws->V[(size_t) q*n + i];
+      w[i] = v;
+      s += v*v;
+    }
+    part[b*stride] = s;
+  }
+  return pairwise(part, nb, stride);
+}
+
+void gmres_tridiag(krylov_ws *ws, double *RHS, double *X, double *tol, int *maxit, double *resvec, int *nbite){
+  int n = ws->n, m = ws->m, iter = 0, i, j, k;
+  double *V = ws->V, *H = ws->H, *z = ws->Z, *r = ws->Z + n;
+  double *g = ws->hv, *cs = ws->hv + (m+1), *sn = ws->hv + 2*(m+1), *h2 = ws->hv + 3*(m+1);
+  double bnorm, beta, resid;
+  double *wd[1] = {NULL};
+
+  bnorm = nrm2_repro(&n, RHS);
+  if (bnorm == 0.0) bnorm = 1.0;
+  matvec_dots(ws, X, r, 0, wd, NULL);
+  for (i=0;i<n;i++) r[i] = RHS[i] - r[i];
+  beta = nrm2_repro(&n, r);
+  resid = beta/bnorm;
+  resvec[0] = resid;
+
+  while (iter < *maxit && resid > *tol){
+    int jmax = 0;
+    for (i=0;i<n;i++) V[i] = r[i]/beta;
+    memset(g, 0, sizeof(double)*(m+1));
+    g[0] = beta;
+
+    for (j=0;j<m && iter < *maxit;j++){
+      double *w = V + (size_t) (j+1)*n, hn;
+      // Préconditionnement à droite : w = A M^-1 v_j
+      prec_apply(ws, V + (size_t) j*n, z);
+      matvec_dots(ws, z, w, 0, wd, NULL);
+      // Gram-Schmidt classique réorthogonalisé (CGS2) : produits et mises à
+      // jour fusionnés sur les j+1 vecteurs de base
+      multi_dot(ws, j+1, w, H + (size_t) j*(m+1));
+      multi_axpy_nrm(ws, j+1, w, H + (size_t) j*(m+1));
+      multi_dot(ws, j+1, w, h2);
+      hn = sqrt(multi_axpy_nrm(ws, j+1, w, h2));
+      for (k=0;k<=j;k++) H[(size_t) j*(m+1) + k] += h2[k];
+      H[(size_t) j*(m+1) + j+1] = hn;
+      if (hn != 0.0){
+        double inv = 1.0/hn;
+        for (i=0;i<n;i++) w[i] *= inv;
+      }
+      // Rotations de Givens sur la colonne j
+      for (k=0;k<j;k++){
+        double a = H[(size_t) j*(m+1) + k], b = H[(size_t) j*(m+1) + k+1];
+        H[(size_t) j*(m+1) + k] = cs[k]*a + sn[k]*b;
+        H[(size_t) j*(m+1) + k+1] = -sn[k]*a + cs[k]*b;
+      }
+      {
+        double a = H[(size_t) j*(m+1) + j], b = H[(size_t) j*(m+1) + j+1];
+        double rr = hypot(a, b);
+        cs[j] = (rr != 0.0) ? a/rr : 1.0;
+        sn[j] = (rr != 0.0) ? b/rr : 0.0;
+        H[(size_t) j*(m+1) + j] = rr;
+        H[(size_t) j*(m+1) + j+1] = 0.0;
+        g[j+1] = -sn[j]*g[j];
+        g[j] = cs[j]*g[j];
+      }
+      iter++;
+      resid = fabs(g[j+1])/bnorm;
+      resvec[iter] = resid;
+      jmax = j+1;
+      if (resid <= *tol || hn == 0.0) break;
+    }
+
+    // y = H^-1 g (triangulaire), puis x += M^-1 V y
+    for (k=jmax-1;k>=0;k--){
+      double s = g[k];
+      for (j=k+1;j<jmax;j++) s -= H[(size_t) j*(m+1) + k]*g[j];
+      g[k] = s/H[(size_t) k*(m+1) + k];
+    }
+    for (i=0;i<n;i++){
+      double s = 0.0;
+      for (k=0;k<jmax;k++) s += g[k]*V[(size_t) k*n + i];
+      r[i] = s;
+    }
+    prec_apply(ws, r, z);
+    for (i=0;i<n;i++) X[i] += z[i];
+
+    // Résidu vrai au redémarrage
+    matvec_dots(ws, X, r, 0, wd, NULL);
+    for (i=0;i<n;i++) r[i] = RHS[i] - r[i];
+    beta = nrm2_repro(&n, r);
+    resid = beta/bnorm;
+    resvec[iter] = resid;
+  }
+  *nbite = iter;
+}
+
+void bicgstab_tridiag(krylov_ws *ws, double *RHS, double *X, double *tol, int *maxit, double *resvec, int *nbite){
+  int n = ws->n, iter = 0, i;
+  double *r = ws->Z, *r0 = ws->Z + n, *p = ws->Z + 2*n, *v = ws->Z + 3*n;
+  double *ph = ws->Z + 4*n, *s = ws->Z + 5*n, *sh = ws->Z + 6*n, *t = ws->Z + 7*n;
+  double rho = 1.0, alpha = 1.0, omega = 1.0, bnorm, resid, d[2];
+  double *wd[2];
+
+  bnorm = nrm2_repro(&n, RHS);
+  if (bnorm == 0.0) bnorm = 1.0;
+  wd[0] = NULL;
+  matvec_dots(ws, X, r, 0, wd, NULL);
+  for (i=0;i<n;i++){
+    r[i] = RHS[i] - r[i];
+    r0[i] = r[i];
+    p[i] = 0.0;
+    v[i] = 0.0;
+  }
+  resid = nrm2_repro(&n, r)/bnorm;
+  resvec[0] = resid;
+
+  while (iter < *maxit && resid > *tol){
+    double rho_new = dot_repro(&n, r0, r), beta, ss;
+    if (rho_new == 0.0) break;   // rupture : r orthogonal à r0
+    beta = (rho_new/rho)*(alpha/omega);
+    rho = rho_new;
+    for (i=0;i<n;i++) p[i] = r[i] + beta*(p[i] - omega*v[i]);
+
+    // v = A M^-1 p fusionné avec (r0, v)
+    prec_apply(ws, p, ph);
+    wd[0] = r0;
+    matvec_dots(ws, ph, v, 1, wd, d);
+    alpha = rho/d[0];
+    for (i=0;i<n;i++) s[i] = r[i] - alpha*v[i];
+    ss = nrm2_repro(&n, s);
+    if (ss/bnorm <= *tol){
+      for (i=0;i<n;i++) X[i] += alpha*ph[i];
+      iter++;
+      resid = ss/bnorm;
+      resvec[iter] = resid;
+      break;
+    }
+
+    // t = A M^-1 s fusionné avec (t, s) et (t, t)
+    prec_apply(ws, s, sh);
+    wd[0] = s;
+    wd[1] = NULL;
+    matvec_dots(ws, sh, t, 2, wd, d);
+    omega = (d[1] != 0.0) ? d[0]/d[1] : 0.0;
+    for (i=0;i<n;i++){
+      X[i] += alpha*ph[i] + omega*sh[i];
+      r[i] = s[i] - omega*t[i];
+    }
+    iter++;
+    resid = nrm2_repro(&n, r)/bnorm;
+    resvec[iter] = resid;
+    if (omega == 0.0) break;
+  }
+  *nbite = iter;
+}
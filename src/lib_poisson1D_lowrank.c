@@ -0,0 +1,161 @@
+/**********************************************/
+/* lib_poisson1D_lowrank.c                    */
+/* Re-solve after a few coefficient changes:  */
+/* Sherman-Morrison-Woodbury on a cached      */
+/* band factorization                         */
+/**********************************************/
+#include "lib_poisson1D.h"
+
+/* -(kappa u')' mise à l'échelle h^2, kappa[e] sur l'arête e entre les noeuds
+   e-1 et e (kappa[0] et kappa[la] touchent les bords) */
+void set_GB_operator_colMajor_conductivity(double* AB, int *lab, int *la, int *kv, double *kappa){
+  int ii, jj, kk;
+  for (jj=0;jj<(*la);jj++){
+    kk = jj*(*lab);
+    for (ii=0;ii<*kv;ii++){
+      AB[kk+ii] = 0.0;
+    }
+    AB[kk+*kv] = (jj > 0) ? -kappa[jj] : 0.0;
+    AB[kk+*kv+1] = kappa[jj] + kappa[jj+1];
+    AB[kk+*kv+2] = (jj < *la-1) ? -kappa[jj+1] : 0.0;
+  }
+}
+
+void set_dense_RHS_DBC_conductivity(double* RHS, int* la, double *kappa, double* BC0, double* BC1){
+  int jj;
+  for (jj=0;jj<(*la);jj++){
+    RHS[jj] = 0.0;
+  }
+  RHS[0] = kappa[0]*(*BC0);
+  RHS[(*la)-1] += kappa[*la]*(*BC1);
+}
+
+int p1d_lowrank_init(p1d_lowrank *lr, double *AB, int *lab, int *la, int *kv, int *kmax){
+  int n = *la, K = (*kmax > 0) ? *kmax : P1D_LOWRANK_KMAX, jj, ii;
+  memset(lr, 0, sizeof(p1d_lowrank));
+  lr->la = n;
+  lr->kmax = K;
+  lr->AB = (double *) malloc(sizeof(double)*4*n);
+  lr->LU = (double *) malloc(sizeof(double)*4*n);
+  lr->ipiv = (int *) malloc(sizeof(int)*n);
+  lr->wi = (int *) malloc(sizeof(int)*2*K);
+  lr->d = (double *) malloc(sizeof(double)*K);
+  lr->Z = (double *) malloc(sizeof(double)*(size_t) n*K);
+  lr->C = (double *) malloc(sizeof(double)*K*K);
+  lr->cpiv = (int *) malloc(sizeof(int)*K);
+  lr->work = (double *) malloc(sizeof(double)*K);
+  if (lr->AB == NULL || lr->LU == NULL || lr->ipiv == NULL || lr->wi == NULL || lr->d == NULL
+      || lr->Z == NULL || lr->C == NULL || lr->cpiv == NULL || lr->work == NULL){
+    perror("p1d_lowrank_init");
+    p1d_lowrank_free(lr);
+    return -1;
+  }
+  // Copie au format de dgbtrf (lab = 4, kv = 1) quel que soit le format d'entrée
+  for (jj=0;jj<n;jj++){
+    lr->AB[4*jj] = 0.0;
+    for (ii=0;ii<3;ii++) lr->AB[4*jj+1+ii] = AB[jj*(*lab) + *kv + ii];
+  }
+  return p1d_lowrank_refactor(lr);
+}
+
+void p1d_lowrank_free(p1d_lowrank *lr){
+  free(lr->AB); free(lr->LU); free(lr->ipiv);
+  free(lr->wi); free(lr->d); free(lr->Z);
+  free(lr->C); free(lr->cpiv); free(lr->work);
+  memset(lr, 0, sizeof(p1d_lowrank));
+}
+
+/* Factorisation complète de l'opérateur courant ; la mise à jour repart de 0 */
+int p1d_lowrank_refactor(p1d_lowrank *lr){
+  int la = lr->la, kl = 1, ku = 1, lab = 4, info;
+  memcpy(lr->LU, lr->AB, sizeof(double)*4*la);
+  dgbtrf_(&la, &la, &kl, &ku, lr->LU, &lab, lr->ipiv, &info);
+  lr->k = 0;
+  lr->nrefactor++;
+  if (info != 0) printf("Erreur: p1d_lowrank_refactor, info = %d\n", info);
+  return info;
+}
+
+/* w_a^T z pour w_a = e_i0 - e_i1 (ou e_i0) */
+static double lr_wdot(p1d_lowrank *lr, int a, double *z){
+  int i1 = lr->wi[2*a+1];
+  return z[lr->wi[2*a]] - ((i1 >= 0) ? z[i1] : 0.0);
+}
+
+/* Capacité C = I + D W^T Z (k x k), factorisée par dgetrf */
+static int lr_capacitance(p1d_lowrank *lr){
+  int k = lr->k, a, b, info = 0;
+  for (b=0;b<k;b++){
+    for (a=0;a<k;a++){
+      lr->C[b*k+a] = (a == b) + lr->d[a]*lr_wdot(lr, a, lr->Z + (size_t) b*lr->la);
+    }
+  }
+  if (k > 0) dgetrf_(&k, &k, lr->C, &k, lr->cpiv, &info);
+  return info;
+}
+
+/* A += delta w w^T, w = e_i0 - e_i1 (i1 < 0 : w = e_i0) */
+static int lr_rank1(p1d_lowrank *lr, int i0, int i1, double delta){
+  int la = lr->la, kl = 1, ku = 1, lab = 4, NRHS = 1, info, a;
+  double *z;
+  // Opérateur courant, gardé à jour pour les refactorisations
+  lr->AB[4*i0 + 2] += delta;
+  if (i1 >= 0){
+    lr->AB[4*i1 + 2] += delta;
+    lr->AB[4*i1 + 2 + i0 - i1] -= delta;
+    lr->AB[4*i0 + 2 + i1 - i0] -= delta;
+  }
+  lr->nupdate++;
+  // Même support qu'une mise à jour en cours : seul le poids change
+  for (a=0;a<lr->k;a++){
+    if (lr->wi[2*a] == i0 && lr->wi[2*a+1] == i1) break;
+  }
+  if (a == lr->k){
+    // Au-delà de kmax colonnes, chaque résolution coûte plus que la
+    // refactorisation (O(n) pour une matrice tridiagonale)
+    if (lr->k == lr->kmax) return p1d_lowrank_refactor(lr);
+    z = lr->Z + (size_t) a*la;
+    memset(z, 0, sizeof(double)*la);
+    z[i0] = 1.0;
+    if (i1 >= 0) z[i1] = -1.0;
+    dgbtrs_("N", &la, &kl, &ku, &NRHS, lr->LU, &lab, lr->ipiv, z, &la, &info);
+    lr->wi[2*a] = i0;
+    lr->wi[2*a+1] = i1;
+    lr->d[a] = 0.0;
+    lr->k++;
+  }
+  lr->d[a] += delta;
+  // Capacité singulière ou mal conditionnée : on repart de l'opérateur courant
+  if (lr_capacitance(lr) != 0) return p1d_lowrank_refactor(lr);
+  return 0;
+}
+
+int p1d_lowrank_update_edge(p1d_lowrank *lr, int *edge, double *dkappa){
+  int e = *edge, la = lr->la;
+  if (e < 0 || e > la) return -1;
+  if (e == 0) return lr_rank1(lr, 0, -1, *dkappa);
+  if (e == la) return lr_rank1(lr, la-1, -1, *dkappa);
+  return lr_rank1(lr, e-1, e, *dkappa);
+}
+
+int p1d_lowrank_update_diag(p1d_lowrank *lr, int *i, double *dsigma){
+  if (*i < 0 || *i >= lr->la) return -1;
+  return lr_rank1(lr, *i, -1, *dsigma);
+}
+
+/* x = y - Z C^-1 D W^T y, y = A0^-1 b */
+int p1d_lowrank_solve(p1d_lowrank *lr, double *RHS, int *nrhs){
+  int la = lr->la, kl = 1, ku = 1, lab = 4, k = lr->k, NRHS = 1, info, r, a, jj;
+  dgbtrs_("N", &la, &kl, &ku, nrhs, lr->LU, &lab, lr->ipiv, RHS, &la, &info);
+  if (info != 0 || k == 0) return info;
+  for (r=0;r<*nrhs;r++){
+    double *y = RHS + (size_t) r*la, *c = lr->work;
+    for (a=0;a<k;a++) c[a] = lr->d[a]*lr_wdot(lr, a, y);
+    dgetrs_("N", &k, &NRHS, lr->C, &k, lr->cpiv, c, &k, &info);
+    for (a=0;a<k;a++){
+      double *z = lr->Z + (size_t) a*la, ca = c[a];
+      for (jj=0;jj<la;jj++) y[jj] -= ca*z[jj];
+    }
+  }
+  return info;
+}
@@ -0,0 +1,220 @@
+/**********************************************/
+/* lib_poisson1D_nd.c                         */
+/* 2D/3D Dirichlet Poisson by fast            */
+/* diagonalization: DST-I on all axes but     */
+/* the last, batched tridiagonal solves on it */
+/**********************************************/
+#include "lib_poisson1D.h"
+#include <omp.h>
+
+#define ND_TILE 32
+
+/* Transposition par tuiles : dst (cols x rows) = src (rows x cols)^T,
+   les deux tuiles ND_TILE x ND_TILE restent en cache */
+static void transpose_blocked(const double *src, double *dst, int rows, int cols){
+  int ib, jb, i, j;
+  for (ib=0;ib<rows;ib+=ND_TILE){
+    int ie = (ib + ND_TILE < rows) ? ib + ND_TILE : rows;
+    for (jb=0;jb<cols;jb+=ND_TILE){
+      int je = (jb + ND_TILE < cols) ? jb + ND_TILE : cols;
+      for (i=ib;i<ie;i++){
+        for (j=jb;j<je;j++){
+          dst[(long) j*rows + i] = src[(long) i*cols + j];
+        }
+      }
+    }
+  }
+}
+
+static int nd_create(poisson_nd_plan *plan, int dim, int *n){
+  int d, p, l;
+  long P = 1;
+  double bl, bl2;
+
+  memset(plan, 0, sizeof(poisson_nd_plan));
+  plan->dim = dim;
+  for (d=0;d<dim;d++){
+    if (n[d] < 1){
+      printf("Erreur: dimension %d de la grille invalide (%d)\n", d, n[d]);
+      return -1;
+    }
+    plan->n[d] = n[d];
+    plan->h[d] = 1.0/(n[d] + 1);
+  }
+  // Axes transformés : tous sauf le dernier
+  for (d=0;d<dim-1;d++){
+    if (dst_plan_create(&plan->dst[d], &n[d]) != 0){
+      poisson_nd_plan_free(plan);
+      return -1;
+    }
+    P *= n[d];
+  }
+  plan->P = P;
+  plan->nlast = n[dim-1];
+  plan->invm = (double *) malloc(sizeof(double)*P*plan->nlast);
+  plan->lambda = (double *) malloc(sizeof(double)*P);
+  if (plan->invm == NULL || plan->lambda == NULL){
+    poisson_nd_plan_free(plan);
+    return -1;
+  }
+
+  // Valeur propre transverse du mode p, plus la diagonale du dernier axe
+  bl = 1.0/(plan->h[dim-1]*plan->h[dim-1]);
+  bl2 = bl*bl;
+  for (p=0;p<P;p++){
+    int i = p % n[0];
+    double lam = plan->dst[0].eig[i]/(plan->h[0]*plan->h[0]);
+    if (dim == 3){
+      int j = p / n[0];
+      lam += plan->dst[1].eig[j]/(plan->h[1]*plan->h[1]);
+    }
+    plan->lambda[p] = lam + 2.0*bl;
+  }
+  // Pivots de Thomas 1/m_{p,l}, m_{p,0} = d_p, m_{p,l} = d_p - b^2/m_{p,l-1}
+  #pragma omp parallel for schedule(static)
+  for (p=0;p<P;p++){
+    double m = plan->lambda[p];
+    plan->invm[p] = 1.0/m;
+    for (l=1;l<plan->nlast;l++){
+      m = plan->lambda[p] - bl2/m;
+      plan->invm[p + P*l] = 1.0/m;
+    }
+  }
+  return 0;
+}
+
+int poisson2D_plan_create(poisson_nd_plan *plan, int *nx, int *ny){
+  int n[2] = {*nx, *ny};
+  return nd_create(plan, 2, n);
+}
+
+int poisson3D_plan_create(poisson_nd_plan *plan, int *nx, int *ny, int *nz){
+  int n[3] = {*nx, *ny, *nz};
+  return nd_create(plan, 3, n);
+}
+
+void poisson_nd_plan_free(poisson_nd_plan *plan){
+  int d;
+  for (d=0;d<plan->dim-1;d++){
+    if (plan->dst[d].n > 0) dst_plan_free(&plan->dst[d]);
+  }
+  free(plan->invm);
+  free(plan->lambda);
+  plan->invm = NULL;
+  plan->lambda = NULL;
+}
+
+/* DST-I d'un plan l (taille P) le long des axes transformés.
+   En 3D, l'axe y passe par une transposition par tuiles pour que
+   chaque ligne transformée soit contiguë */
+static void transform_plane(poisson_nd_plan *plan, double *plane, double *tbuf, double *work){
+  int nx = plan->n[0], j;
+  if (plan->dim == 2){
+    dst1_apply(&plan->dst[0], plane, work);
+    return;
+  }
+  int ny = plan->n[1];
+  for (j=0;j<ny;j++){
+    dst1_apply(&plan->dst[0], plane + (long) j*nx, work);
+  }
+  transpose_blocked(plane, tbuf, ny, nx);
+  for (j=0;j<nx;j++){
+    dst1_apply(&plan->dst[1], tbuf + (long) j*ny, work);
+  }
+  transpose_blocked(tbuf, plane, nx, ny);
+}
+
+static void transform_all(poisson_nd_plan *plan, double *U){
+  long P = plan->P;
+  int l;
+  #pragma omp parallel
+  {
+    int d, ws = 0;
+    double *work, *tbuf = NULL;
+    for (d=0;d<plan->dim-1;d++){
+      int w = dst_plan_worksize(&plan->dst[d]);
+      if (w > ws) ws = w;
+    }
+    work = (double *) malloc(sizeof(double)*ws);
+    if (plan->dim == 3) tbuf = (double *) malloc(sizeof(double)*P);
+    #pragma omp for schedule(static)
+    for (l=0;l<plan->nlast;l++){
+      transform_plane(plan, U + P*l, tbuf, work);
+    }
+    free(work);
+    free(tbuf);
+  }
+}
+
+/* Résolution en place : U contient f plus les termes de bord (cf.
+   set_dense_RHS_DBC_nd), ordonné x le plus rapide, et reçoit la solution */
+void poisson_nd_solve(poisson_nd_plan *plan, double *U){
+  long P = plan->P;
+  int nl = plan->nlast, d;
+  double b = -1.0/(plan->h[plan->dim-1]*plan->h[plan->dim-1]);
+  double scale = 1.0;
+
+  for (d=0;d<plan->dim-1;d++) scale *= 2.0/(plan->n[d] + 1);
+
+  transform_all(plan, U);
+
+  // Systèmes tridiagonaux le long du dernier axe, un par mode p : la boucle
+  // interne parcourt les modes contigus (vectorisée), chaque thread en traite
+  // une tranche avec le même découpage statique que l'assemblage
+  #pragma omp parallel
+  {
+    int nth = omp_get_num_threads(), tid = omp_get_thread_num();
+    int lo, hi, Pi = (int) P, l, p;
+    poisson1D_partition(&Pi, nth, tid, &lo, &hi);
+    for (p=lo;p<hi;p++) U[p] *= scale*plan->invm[p];
+    for (l=1;l<nl;l++){
+      double *u = U + P*l, *up = U + P*(l-1), *im = plan->invm + P*l;
+      #pragma omp simd
+      for (p=lo;p<hi;p++){
+        u[p] = (scale*u[p] - b*up[p])*im[p];
+      }
+    }
+    for (l=nl-2;l>=0;l--){
+      double *u = U + P*l, *un = U + P*(l+1), *im = plan->invm + P*l;
+      #pragma omp simd
+      for (p=lo;p<hi;p++){
+        u[p] -= b*im[p]*un[p];
+      }
+    }
+  }
+
+  transform_all(plan, U);
+}
+
+/* Second membre f(x,y,z) + conditions de Dirichlet g sur le bord du cube unité
+   (termes g/h^2 des voisins hors domaine), sur la grille du plan. La dimension
+   vient du plan : un plan 3D avec nz = 1 garde ses termes de bord en z.
+   En 2D, z vaut 0 */
+void set_dense_RHS_DBC_nd(double *RHS, poisson_nd_plan *plan, poisson_nd_func f, poisson_nd_func g, void *ctx){
+  int dim = plan->dim;
+  int nx = plan->n[0], ny = plan->n[1], nz = (dim == 3) ? plan->n[2] : 1;
+  double hx = plan->h[0], hy = plan->h[1], hz = (dim == 3) ? plan->h[2] : 0.0;
+  double ix = 1.0/(hx*hx), iy = 1.0/(hy*hy), iz = (dim == 3) ? 1.0/(hz*hz) : 0.0;
+  int l;
+  #pragma omp parallel for schedule(static)
+  for (l=0;l<nz;l++){
+    int i, j;
+    double z = (dim == 3) ? (l+1)*hz : 0.0;
+    for (j=0;j<ny;j++){
+      double y = (j+1)*hy;
+      for (i=0;i<nx;i++){
+        double x = (i+1)*hx;
+        double r = (f != NULL) ? f(x, y, z, ctx) : 0.0;
+        if (g != NULL){
+          if (i == 0) r += ix*g(0.0, y, z, ctx);
+          if (i == nx-1) r += ix*g(1.0, y, z, ctx);
+          if (j == 0) r += iy*g(x, 0.0, z, ctx);
+          if (j == ny-1) r += iy*g(x, 1.0, z, ctx);
+          if (dim == 3 && l == 0) r += iz*g(x, y, 0.0, ctx);
+          if (dim == 3 && l == nz-1) r += iz*g(x, y, 1.0, ctx);
+        }
+        RHS[i + (long) nx*(j + (long) ny*l)] = r;
+      }
+    }
+  }
+}
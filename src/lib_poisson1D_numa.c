@@ -0,0 +1,151 @@
+/**********************************************/
+/* lib_poisson1D_numa.c                       */
+/* Parallel first-touch assembly and thread   */
+/* pinning policies                           */
+/**********************************************/
+#define _GNU_SOURCE
+#include "lib_poisson1D.h"
+#include <sched.h>
+#include <omp.h>
+
+/* Découpage statique [lo, hi) du thread tid parmi nthreads : identique à
+   schedule(static) sans taille de bloc (les q+1 premiers blocs d'abord) */
+void poisson1D_partition(int *la, int nthreads, int tid, int *lo, int *hi){
+  int q = (*la) / nthreads, r = (*la) % nthreads;
+  *lo = tid*q + ((tid < r) ? tid : r);
+  *hi = *lo + q + ((tid < r) ? 1 : 0);
+}
+
+/* Les boucles ci-dessous utilisent schedule(static) sur [0, la), comme les
+   solveurs OpenMP : chaque page est touchée en premier par le thread qui
+   l'utilisera, donc allouée sur son nœud NUMA */
+void set_GB_operator_colMajor_poisson1D_par(double* AB, int *lab, int *la, int *kv){
+  int jj;
+  #pragma omp parallel for schedule(static)
+  for (jj=0;jj<(*la);jj++){
+    int ii, kk = jj*(*lab);
+    for (ii=0;ii<(*lab);ii++){
+      AB[kk+ii]=0.0;
+    }
+    if (jj > 0) AB[kk+ *kv]=-1.0;
+    AB[kk+ *kv+1]=2.0;
+    if (jj < (*la)-1) AB[kk+ *kv+2]=-1.0;
+  }
+}
+
+void set_dense_RHS_DBC_1D_par(double* RHS, int* la, double* BC0, double* BC1){
+  int jj;
+  #pragma omp parallel for schedule(static)
+  for (jj=0;jj<(*la);jj++){
+    RHS[jj]=0.0;
+  }
+  RHS[0] += *BC0;
+  RHS[(*la)-1] += *BC1;
+}
+
+void set_analytical_solution_DBC_1D_par(double* EX_SOL, double* X, int* la, double* BC0, double* BC1){
+  double DELTA_T=(*BC1)-(*BC0);
+  int jj;
+  #pragma omp parallel for schedule(static)
+  for (jj=0;jj<(*la);jj++){
+    EX_SOL[jj] = (*BC0) + X[jj]*DELTA_T;
+  }
+}
+
+void set_grid_points_1D_par(double* x, int* la){
+  double h=1.0/(1.0*((*la)+1));
+  int jj;
+  #pragma omp parallel for schedule(static)
+  for (jj=0;jj<(*la);jj++){
+    x[jj]=(jj+1)*h;
+  }
+}
+
+int poisson1D_pin_policy(char *name){
+  if (name == NULL) return POISSON1D_PIN_NONE;
+  if (strcmp(name, "compact") == 0 || strcmp(name, "close") == 0) return POISSON1D_PIN_COMPACT;
+  if (strcmp(name, "spread") == 0) return POISSON1D_PIN_SPREAD;
+  return POISSON1D_PIN_NONE;
+}
+
+static int cpu_package(int cpu){
+  char path[128];
+  FILE *file;
+  int pkg = 0;
+  snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/topology/physical_package_id", cpu);
+  file = fopen(path, "r");
+  if (file != NULL){
+    if (fscanf(file, "%d", &pkg) != 1) pkg = 0;
+    fclose(file);
+  }
+  return pkg;
+}
+
+/* Ordre des cœurs autorisés : compact = socket par socket,
+   spread = tour à tour sur les sockets */
+static int pin_order(int policy, int *order){
+  cpu_set_t set;
+  int cpus[CPU_SETSIZE], pkg[CPU_SETSIZE], used[CPU_SETSIZE];
+  int n = 0, npkg = 0, c, k, p;
+
+  if (sched_getaffinity(0, sizeof(set), &set) != 0) return 0;
+  for (c=0;c<CPU_SETSIZE;c++){
+    if (CPU_ISSET(c, &set)){
+      cpus[n] = c;
+      pkg[n] = cpu_package(c);
+      if (pkg[n] + 1 > npkg) npkg = pkg[n] + 1;
+      used[n] = 0;
+      n++;
+    }
+  }
+  k = 0;
+  if (policy == POISSON1D_PIN_SPREAD){
+    while (k < n){
+      for (p=0;p<npkg;p++){
+        for (c=0;c<n;c++){
+          if (!used[c] && pkg[c] == p){
+            used[c] = 1;
+            order[k++] = cpus[c];
+            break;
+          }
+        }
+      }
+    }
+  } else {
+    for (p=0;p<npkg;p++){
+      for (c=0;c<n;c++){
+        if (pkg[c] == p) order[k++] = cpus[c];
+      }
+    }
+  }
+  return n;
+}
+
+/* Cœur du thread tid pour la politique donnée, -1 sans épinglage */
+int poisson1D_pin_cpu(int policy, int tid){
+  int order[CPU_SETSIZE];
+  int n;
+  if (policy == POISSON1D_PIN_NONE) return -1;
+  n = pin_order(policy, order);
+  return (n > 0) ? order[tid % n] : -1;
+}
+
+/* Épingle chaque thread de l'équipe OpenMP ; à appeler avant l'assemblage
+   pour que le premier accès et les solveurs voient le même placement.
+   Retourne le nombre de threads épinglés. */
+int poisson1D_pin_threads(int policy){
+  int order[CPU_SETSIZE];
+  int n, npinned = 0;
+
+  if (policy == POISSON1D_PIN_NONE) return 0;
+  n = pin_order(policy, order);
+  if (n == 0) return 0;
+  #pragma omp parallel reduction(+:npinned)
+  {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(order[omp_get_thread_num() % n], &set);
+    if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0) npinned++;
+  }
+  return npinned;
+}
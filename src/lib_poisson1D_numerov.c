@@ -0,0 +1,45 @@
+/**********************************************/
+/* lib_poisson1D_numerov.c                    */
+/* Source term -u'' = f: second-order and     */
+/* fourth-order compact (Numerov) RHS,        */
+/* Richardson extrapolation across grids      */
+/**********************************************/
+#include "lib_poisson1D.h"
+
+/* Schéma d'ordre 2 : (-u_{i-1} + 2u_i - u_{i+1}) = h^2 f_i,
+   même opérateur [-1 2 -1] que set_GB_operator_colMajor_poisson1D */
+void set_dense_RHS_source_1D(double* RHS, int* la, poisson1D_source f, void *ctx, double* BC0, double* BC1){
+  double h = 1.0/(1.0*((*la)+1)), h2 = h*h;
+  int jj;
+  #pragma omp parallel for schedule(static)
+  for (jj=0;jj<(*la);jj++){
+    RHS[jj] = h2*f((jj+1)*h, ctx);
+  }
+  RHS[0] += *BC0;
+  RHS[(*la)-1] += *BC1;
+}
+
+/* Schéma compact d'ordre 4 (Numerov) : même opérateur,
+   second membre h^2/12 (f_{i-1} + 10 f_i + f_{i+1}), f pris aussi en x=0 et x=1 */
+void set_dense_RHS_numerov_1D(double* RHS, int* la, poisson1D_source f, void *ctx, double* BC0, double* BC1){
+  double h = 1.0/(1.0*((*la)+1)), c = h*h/12.0;
+  int jj;
+  #pragma omp parallel for schedule(static)
+  for (jj=0;jj<(*la);jj++){
+    RHS[jj] = c*(f(jj*h, ctx) + 10.0*f((jj+1)*h, ctx) + f((jj+2)*h, ctx));
+  }
+  RHS[0] += *BC0;
+  RHS[(*la)-1] += *BC1;
+}
+
+/* Extrapolation de Richardson entre la grille h (lac points) et h/2
+   (2*lac+1 points) : le point grossier j coïncide avec le point fin 2j+1.
+   U = (2^p Uf - Uc) / (2^p - 1) gagne deux ordres pour un schéma symétrique d'ordre p */
+void richardson_extrapolate_1D(double *Uc, double *Uf, int *lac, int *p, double *U){
+  double w = (double) (1 << *p);
+  int jj;
+  #pragma omp parallel for schedule(static)
+  for (jj=0;jj<(*lac);jj++){
+    U[jj] = (w*Uf[2*jj+1] - Uc[jj])/(w - 1.0);
+  }
+}
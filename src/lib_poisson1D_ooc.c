@@ -0,0 +1,152 @@
+/**********************************************/
+/* lib_poisson1D_ooc.c                        */
+/* Out-of-core tridiagonal solver: operator,  */
+/* RHS and solution in memory-mapped files    */
+/**********************************************/
+#include "lib_poisson1D.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+static int ooc_map(ooc_vec *v, char *filename, long long n, int create){
+  int flags = create ? (O_RDWR | O_CREAT | O_TRUNC) : O_RDWR;
+  struct stat st;
+
+  v->map = NULL;
+  v->n = n;
+  v->len = sizeof(double)*(size_t) n;
+  v->fd = open(filename, flags, 0644);
+  if (v->fd < 0){
+    perror(filename);
+    return -1;
+  }
+  if (create){
+    if (ftruncate(v->fd, (off_t) v->len) != 0){
+      perror(filename);
+      close(v->fd);
+      return -1;
+    }
+  } else {
+    if (fstat(v->fd, &st) != 0 || (size_t) st.st_size < v->len){
+      printf("Erreur: %s contient moins de %lld valeurs\n", filename, n);
+      close(v->fd);
+      return -1;
+    }
+  }
+  v->map = (double *) mmap(NULL, v->len, PROT_READ | PROT_WRITE, MAP_SHARED, v->fd, 0);
+  if (v->map == MAP_FAILED){
+    perror(filename);
+    close(v->fd);
+    v->map = NULL;
+    return -1;
+  }
+  // Accès strictement séquentiel : lecture anticipée agressive
+  madvise(v->map, v->len, MADV_SEQUENTIAL);
+  return 0;
+}
+
+int ooc_vec_create(ooc_vec *v, char *filename, long long n){
+  return ooc_map(v, filename, n, 1);
+}
+
+int ooc_vec_open(ooc_vec *v, char *filename, long long n){
+  return ooc_map(v, filename, n, 0);
+}
+
+void ooc_vec_close(ooc_vec *v){
+  if (v->map != NULL){
+    msync(v->map, v->len, MS_SYNC);
+    munmap(v->map, v->len);
+  }
+  if (v->fd >= 0) close(v->fd);
+  v->map = NULL;
+  v->fd = -1;
+}
+
+/* Alignement des bornes de chunk sur les pages pour madvise */
+static void ooc_advise(ooc_vec *v, long long lo, long long hi, int advice){
+  size_t page = (size_t) sysconf(_SC_PAGESIZE);
+  size_t a, b;
+  if (v == NULL || v->map == NULL) return;
+  if (lo < 0) lo = 0;
+  if (hi > v->n) hi = v->n;
+  if (hi <= lo) return;
+  a = (sizeof(double)*(size_t) lo) & ~(page - 1);
+  b = sizeof(double)*(size_t) hi;
+  if (advice == MADV_DONTNEED){
+    // Pages modifiées : écriture différée lancée avant l'abandon
+    msync((char *) v->map + a, b - a, MS_ASYNC);
+  }
+  madvise((char *) v->map + a, b - a, advice);
+}
+
+static void ooc_advise_all(ooc_vec **vs, int nv, long long lo, long long hi, int advice){
+  int k;
+  for (k=0;k<nv;k++) ooc_advise(vs[k], lo, hi, advice);
+}
+
+int ooc_set_dense_RHS_DBC_1D(ooc_vec *RHS, double *BC0, double *BC1){
+  long long jj;
+  for (jj=0;jj<RHS->n;jj++){
+    RHS->map[jj] = 0.0;
+  }
+  RHS->map[0] += *BC0;
+  RHS->map[RHS->n-1] += *BC1;
+  return 0;
+}
+
+long long ooc_tridiag_solve(ooc_vec *DL, ooc_vec *D, ooc_vec *DU, ooc_vec *RHS, ooc_vec *SOL, ooc_vec *SPILL, long long chunk){
+  long long n = RHS->n, lo, hi, i;
+  ooc_vec *fwd[5] = {DL, D, DU, RHS, SPILL};
+  double cprev = 0.0, dprev = 0.0, xnext = 0.0;
+  double *F = SPILL->map;     // facteur (c'_i, d'_i) entrelacé, taille 2n
+
+  if (chunk < 1024) chunk = 1024;
+  if (SPILL->n < 2*n || SOL->n < n){
+    printf("Erreur: fichiers de facteur ou de solution trop petits\n");
+    return -1;
+  }
+
+  // Élimination avant (Thomas) : c'_i = du_i / m_i, d'_i = (r_i - dl_i d'_{i-1}) / m_i
+  // avec m_i = d_i - dl_i c'_{i-1}. DL, D, DU à NULL : opérateur [-1 2 -1]
+  for (lo=0;lo<n;lo+=chunk){
+    hi = (lo + chunk < n) ? lo + chunk : n;
+    // Lecture anticipée du chunk suivant pendant le calcul de celui-ci
+    ooc_advise_all(fwd, 4, hi, hi + chunk, MADV_WILLNEED);
+    ooc_advise(SPILL, 2*hi, 2*(hi + chunk), MADV_WILLNEED);
+    for (i=lo;i<hi;i++){
+      double dl = (DL != NULL) ? DL->map[i] : -1.0;
+      double d = (D != NULL) ? D->map[i] : 2.0;
+      double du = (DU != NULL) ? DU->map[i] : -1.0;
+      double lc = (i > 0) ? dl*cprev : 0.0;
+      double m = d - lc;
+      // Pivot relatif : m est négligeable devant les termes qui le forment
+      if (!(fabs(m) > 1e-10*(fabs(d) + fabs(lc)))){
+        printf("Erreur: pivot nul à la ligne %lld\n", i);
+        return i + 1;
+      }
+      cprev = (i < n-1) ? du / m : 0.0;
+      dprev = (RHS->map[i] - ((i > 0) ? dl*dprev : 0.0)) / m;
+      F[2*i] = cprev;
+      F[2*i+1] = dprev;
+    }
+    // Le chunk traité n'est plus utile en mémoire
+    ooc_advise_all(fwd, 4, lo, hi, MADV_DONTNEED);
+    ooc_advise(SPILL, 2*lo, 2*hi, MADV_DONTNEED);
+  }
+
+  // Remontée en flux inverse : x_i = d'_i - c'_i x_{i+1}
+  for (hi=n;hi>0;hi-=chunk){
+    lo = (hi - chunk > 0) ? hi - chunk : 0;
+    ooc_advise(SPILL, 2*(lo - chunk), 2*lo, MADV_WILLNEED);
+    ooc_advise(SOL, lo - chunk, lo, MADV_WILLNEED);
+    for (i=hi-1;i>=lo;i--){
+      xnext = F[2*i+1] - F[2*i]*xnext;
+      SOL->map[i] = xnext;
+    }
+    ooc_advise(SPILL, 2*lo, 2*hi, MADV_DONTNEED);
+    ooc_advise(SOL, lo, hi, MADV_DONTNEED);
+  }
+  return 0;
+}
@@ -0,0 +1,111 @@
+/**********************************************/
+/* lib_poisson1D_parareal.c                   */
+/* Heat equation u_t = u_xx, implicit Euler:  */
+/* sequential stepping and Parareal over      */
+/* time slices                                */
+/**********************************************/
+#include "lib_poisson1D.h"
+
+int heat_ie_plan_create(heat_ie_plan *p, int *la, double *dt, double *T0, double *T1){
+  int lab = 4, kv = 1, kl = 1, ku = 1, info, jj;
+  double h = 1.0/(*la + 1);
+  p->la = *la;
+  p->dt = *dt;
+  p->r = (*dt)/(h*h);
+  p->bc[0] = p->r*(*T0);
+  p->bc[1] = p->r*(*T1);
+  p->LU = (double *) malloc(sizeof(double)*lab*(*la));
+  p->ipiv = (int *) malloc(sizeof(int)*(*la));
+  if (p->LU == NULL || p->ipiv == NULL){
+    perror("heat_ie_plan_create");
+    heat_ie_plan_free(p);
+    return -1;
+  }
+  // I + r A, A = [-1 2 -1], factorisée une fois pour tous les pas
+  set_GB_operator_colMajor_poisson1D_quiet(p->LU, &lab, la, &kv);
+  for (jj=0;jj<lab*(*la);jj++) p->LU[jj] *= p->r;
+  for (jj=0;jj<*la;jj++) p->LU[jj*lab + kv + ku] += 1.0;
+  dgbtrftridiag(la, la, &kl, &ku, p->LU, &lab, p->ipiv, &info);
+  if (info != 0){
+    printf("Erreur: factorisation de I + r A, info = %d\n", info);
+    heat_ie_plan_free(p);
+    return info;
+  }
+  return 0;
+}
+
+void heat_ie_plan_free(heat_ie_plan *p){
+  free(p->LU);
+  free(p->ipiv);
+  p->LU = NULL;
+  p->ipiv = NULL;
+}
+
+/* (I + r A) U^{n+1} = U^n + r (T0 e_1 + T1 e_la), nsteps fois */
+void heat_ie_step(heat_ie_plan *p, double *U, int *nsteps){
+  int lab = 4, kl = 1, ku = 1, NRHS = 1, la = p->la, info, k;
+  for (k=0;k<*nsteps;k++){
+    U[0] += p->bc[0];
+    U[la-1] += p->bc[1];
+    dgbtrs_("N", &la, &kl, &ku, &NRHS, p->LU, &lab, p->ipiv, U, &la, &info);
+  }
+}
+
+int heat_parareal(heat_ie_plan *fine, heat_ie_plan *coarse, int *nslices, int *nfine, int *ncoarse,
+                  double *U, double *tol, int *maxk, int *nthreads, double *resvec, int *nbite){
+  int la = fine->la, N = *nslices, k, n, jj;
+  size_t sz = sizeof(double)*la;
+  double *F, *G, *T;
+
+  if (coarse->la != la || N < 1){
+    printf("Erreur: heat_parareal, dimensions incorrectes\n");
+    return -1;
+  }
+  F = (double *) malloc(sz*N);
+  G = (double *) malloc(sz*N);
+  T = (double *) malloc(sz);
+  if (F == NULL || G == NULL || T == NULL){
+    perror("heat_parareal");
+    free(F); free(G); free(T);
+    return -1;
+  }
+  // Prédiction par le propagateur grossier
+  for (n=0;n<N;n++){
+    memcpy(U + (size_t) (n+1)*la, U + (size_t) n*la, sz);
+    heat_ie_step(coarse, U + (size_t) (n+1)*la, ncoarse);
+    memcpy(G + (size_t) n*la, U + (size_t) (n+1)*la, sz);
+  }
+  for (k=0;k<*maxk && k<N;k++){
+    double diff = 0.0, unorm = 0.0;
+    // Propagateurs fins concurrents sur les tranches non convergées
+    #pragma omp parallel for num_threads(*nthreads) schedule(dynamic, 1)
+    for (n=k;n<N;n++){
+      memcpy(F + (size_t) n*la, U + (size_t) n*la, sz);
+      heat_ie_step(fine, F + (size_t) n*la, nfine);
+    }
+    // Correction séquentielle ; la tranche k part d'un état exact :
+    // U_{k+1} = F_k, identique au pas à pas séquentiel après N itérations
+    for (n=k;n<N;n++){
+      double *Un1 = U + (size_t) (n+1)*la, *Fn = F + (size_t) n*la, *Gn = G + (size_t) n*la;
+      if (n > k){
+        memcpy(T, U + (size_t) n*la, sz);
+        heat_ie_step(coarse, T, ncoarse);
+      }
+      for (jj=0;jj<la;jj++){
+        double u = (n > k) ? T[jj] + (Fn[jj] - Gn[jj]) : Fn[jj];
+        diff = fmax(diff, fabs(u - Un1[jj]));
+        unorm = fmax(unorm, fabs(u));
+        Un1[jj] = u;
+      }
+      if (n > k) memcpy(Gn, T, sz);
+    }
+    resvec[k] = (unorm > 0.0) ? diff/unorm : diff;
+    if (resvec[k] <= *tol){
+      k++;
+      break;
+    }
+  }
+  *nbite = k;
+  free(F); free(G); free(T);
+  return 0;
+}
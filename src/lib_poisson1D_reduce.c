@@ -0,0 +1,212 @@
+/**********************************************/
+/* lib_poisson1D_reduce.c                     */
+/* Deterministic compensated reductions:      */
+/* dot products and 2-norms                   */
+/**********************************************/
+#include "lib_poisson1D.h"
+#include <limits.h>
+
+/* Les blocs ont une taille fixe : le découpage, donc l'arbre de réduction,
+   ne dépend pas du nombre de threads et le résultat est reproductible bit à bit */
+#define RED_BLOCK 2048
+#define RED_LANES 4
+#define RED_STACK 256
+/* Plage où la somme directe des carrés d'un bloc est sûre : 2^600 laisse la
+   marge de la réduction par paires, et sous 2^-600 un carré dénormalisé
+   pourrait ne plus être négligeable */
+#define RED_SSQ_MIN 0x1p-600
+#define RED_SSQ_MAX 0x1p600
+
+/* Somme compensée (Kahan) sur RED_LANES voies indépendantes, vectorisables */
+static double block_dot(const double *x, const double *y, int len){
+  double s[RED_LANES] = {0.0}, c[RED_LANES] = {0.0};
+  double sum, comp;
+  int i, l;
+  for (i=0;i+RED_LANES<=len;i+=RED_LANES){
+    for (l=0;l<RED_LANES;l++){
+      double yk = x[i+l]*y[i+l] - c[l];
+      double t = s[l] + yk;
+      c[l] = (t - s[l]) - yk;
+      s[l] = t;
+    }
+  }
+  for (l=0;i<len;i++,l++){
+    double yk = x[i]*y[i] - c[l];
+    double t = s[l] + yk;
+    c[l] = (t - s[l]) - yk;
+    s[l] = t;
+  }
+  // Combinaison des voies dans un ordre fixe
+  sum = (s[0] + s[1]) + (s[2] + s[3]);
+  comp = (c[0] + c[1]) + (c[2] + c[3]);
+  return sum - comp;
+}
+
+/* Somme des carrés de (x - y) s (y peut être NULL), s puissance de 2 : la
+   mise à l'échelle est exacte, seul le domaine d'exposants change */
+static double block_ssq(const double *x, const double *y, int len, double sc){
+  double s[RED_LANES] = {0.0}, c[RED_LANES] = {0.0};
+  double sum, comp;
+  int i, l;
+  for (i=0;i+RED_LANES<=len;i+=RED_LANES){
+    for (l=0;l<RED_LANES;l++){
+      double d = ((y != NULL) ? x[i+l] - y[i+l] : x[i+l])*sc;
+      double yk = d*d - c[l];
+      double t = s[l] + yk;
+      c[l] = (t - s[l]) - yk;
+      s[l] = t;
+    }
+  }
+  for (l=0;i<len;i++,l++){
+    double d = ((y != NULL) ? x[i] - y[i] : x[i])*sc;
+    double yk = d*d - c[l];
+    double t = s[l] + yk;
+    c[l] = (t - s[l]) - yk;
+    s[l] = t;
+  }
+  sum = (s[0] + s[1]) + (s[2] + s[3]);
+  comp = (c[0] + c[1]) + (c[2] + c[3]);
+  return sum - comp;
+}
+
+/* Somme directe des carrés de (x - y) et max |x - y| (y peut être NULL) en
+   une seule lecture du bloc ; le max ignore les NaN, que la somme propage */
+static double block_ssq_max(const double *x, const double *y, int len, double *mx){
+  double s[RED_LANES] = {0.0}, c[RED_LANES] = {0.0}, m[RED_LANES] = {0.0};
+  double sum, comp;
+  int i, l;
+  for (i=0;i+RED_LANES<=len;i+=RED_LANES){
+    for (l=0;l<RED_LANES;l++){
+      double d = (y != NULL) ? x[i+l] - y[i+l] : x[i+l];
+      double a = fabs(d);
+      double yk = d*d - c[l];
+      double t = s[l] + yk;
+      c[l] = (t - s[l]) - yk;
+      s[l] = t;
+      m[l] = (a > m[l]) ? a : m[l];
+    }
+  }
+  for (l=0;i<len;i++,l++){
+    double d = (y != NULL) ? x[i] - y[i] : x[i];
+    double a = fabs(d);
+    double yk = d*d - c[l];
+    double t = s[l] + yk;
+    c[l] = (t - s[l]) - yk;
+    s[l] = t;
+    m[l] = (a > m[l]) ? a : m[l];
+  }
+  m[0] = (m[1] > m[0]) ? m[1] : m[0];
+  m[2] = (m[3] > m[2]) ? m[3] : m[2];
+  *mx = (m[2] > m[0]) ? m[2] : m[0];
+  sum = (s[0] + s[1]) + (s[2] + s[3]);
+  comp = (c[0] + c[1]) + (c[2] + c[3]);
+  return sum - comp;
+}
+
+/* Somme des carrés de (x - y) 2^-e sur un bloc, *e = INT_MIN pour un bloc
+   nul. Cas courant : la somme directe (e = 0) est loin des bornes de la
+   plage des doubles, rien n'a débordé ni perdu de chiffres significatifs.
+   Sinon le bloc est mis à l'échelle par son max |x - y| = f 2^e, f dans
+   [0.5, 1[ ; dans les deux cas le choix ne dépend que des valeurs du bloc */
+static double block_nrm2(const double *x, const double *y, int len, int *e){
+  double m, ssq;
+  ssq = block_ssq_max(x, y, len, &m);
+  if (ssq >= RED_SSQ_MIN && ssq <= RED_SSQ_MAX){
+    *e = 0;
+    return ssq;
+  }
+  // Bloc nul, ou dont les seuls non-zéros sont des NaN (ssq = NaN)
+  if (m == 0.0){
+    *e = (ssq == 0.0) ? INT_MIN : 0;
+    return ssq;
+  }
+  // Infini : somme directe, qui le propage (un NaN l'est aussi par block_ssq)
+  if (!isfinite(m)){
+    *e = 0;
+    return block_ssq(x, y, len, 1.0);
+  }
+  frexp(m, e);
+  return block_ssq(x, y, len, ldexp(1.0, -*e));
+}
+
+/* Réduction par paires des sommes partielles (arbre fixe) */
+static double pairwise_sum(double *p, int nb){
+  int stride, k;
+  for (stride=1;stride<nb;stride*=2){
+    for (k=0;k+stride<nb;k+=2*stride){
+      p[k] += p[k+stride];
+    }
+  }
+  return (nb > 0) ? p[0] : 0.0;
+}
+
+static double reduce_blocks(int n, double *x, double *y){
+  double stack_partial[RED_STACK];
+  double *partial;
+  double sum;
+  int nb = (n + RED_BLOCK - 1) / RED_BLOCK, b;
+
+  if (nb <= 1){
+    return block_dot(x, y, n);
+  }
+  partial = (nb <= RED_STACK) ? stack_partial : (double *) malloc(sizeof(double)*nb);
+  #pragma omp parallel for schedule(static) if(nb >= 8)
+  for (b=0;b<nb;b++){
+    int off = b*RED_BLOCK;
+    int len = (off + RED_BLOCK <= n) ? RED_BLOCK : n - off;
+    partial[b] = block_dot(x + off, y + off, len);
+  }
+  sum = pairwise_sum(partial, nb);
+  if (partial != stack_partial) free(partial);
+  return sum;
+}
+
+/* ||x - y||_2 (y peut être NULL) : chaque bloc a sa propre échelle 2^e_b,
+   les sommes partielles sont ramenées à l'échelle du plus grand bloc avant
+   la réduction par paires. Toutes les mises à l'échelle sont des puissances
+   de 2, donc exactes : hors débordement, le résultat est celui de la somme
+   directe, et il reste indépendant du nombre de threads */
+static double reduce_nrm2(int n, double *x, double *y){
+  double stack_partial[RED_STACK];
+  int stack_expo[RED_STACK];
+  double *partial;
+  int *expo;
+  int nb = (n + RED_BLOCK - 1) / RED_BLOCK, b, E = INT_MIN;
+  double sum;
+
+  if (nb < 1) return 0.0;
+  partial = (nb <= RED_STACK) ? stack_partial : (double *) malloc(sizeof(double)*nb);
+  expo = (nb <= RED_STACK) ? stack_expo : (int *) malloc(sizeof(int)*nb);
+  #pragma omp parallel for schedule(static) if(nb >= 8)
+  for (b=0;b<nb;b++){
+    int off = b*RED_BLOCK;
+    int len = (off + RED_BLOCK <= n) ? RED_BLOCK : n - off;
+    partial[b] = block_nrm2(x + off, (y != NULL) ? y + off : NULL, len, &expo[b]);
+  }
+  for (b=0;b<nb;b++){
+    if (expo[b] > E) E = expo[b];
+  }
+  if (E == INT_MIN){
+    sum = 0.0;
+  } else {
+    for (b=0;b<nb;b++){
+      if (expo[b] != INT_MIN) partial[b] = ldexp(partial[b], 2*(expo[b] - E));
+    }
+    sum = ldexp(sqrt(pairwise_sum(partial, nb)), E);
+  }
+  if (partial != stack_partial) free(partial);
+  if (expo != stack_expo) free(expo);
+  return sum;
+}
+
+double dot_repro(int *n, double *x, double *y){
+  return reduce_blocks(*n, x, y);
+}
+
+double nrm2_repro(int *n, double *x){
+  return reduce_nrm2(*n, x, NULL);
+}
+
+double nrm2_diff_repro(int *n, double *x, double *y){
+  return reduce_nrm2(*n, x, y);
+}
@@ -6,18 +6,25 @@
 #include "lib_poisson1D.h"
 
 void eig_poisson1D(double* eigval, int *la){
+    // Valeurs propres de la matrice tridiagonale [-1 2 -1] de taille n,
+    // associées aux modes sinus v_k(j) = sin(j k pi/(n+1)) :
+    // λk = 4*sin²(kπ/(2(n+1))), k = 1..n (ordre croissant)
+    int k;
+    for (k = 0; k < *la; k++) {
+        eigval[k] = 4.0 * pow(sin((k + 1) * M_PI/(2.0*(*la + 1))), 2);
+    }
 }
 
 double eigmax_poisson1D(int *la){
     // Pour une matrice tridiagonale de Poisson 1D
-    // λmax = 4*sin²(π/(2(n+1)))
-    return 4.0 * pow(sin(M_PI/(2.0*(*la + 1))), 2);
+    // λmax = 4*sin²(nπ/(2(n+1)))
+    return 4.0 * pow(sin(*la * M_PI/(2.0*(*la + 1))), 2);
 }
 
 double eigmin_poisson1D(int *la){
     // Pour une matrice tridiagonale de Poisson 1D
-    // λmin = 4*sin²(nπ/(2(n+1)))
-    return 4.0 * pow(sin(*la * M_PI/(2.0*(*la + 1))), 2);
+    // λmin = 4*sin²(π/(2(n+1)))
+    return 4.0 * pow(sin(M_PI/(2.0*(*la + 1))), 2);
 }
 
 double richardson_alpha_opt(int *la){
@@ -35,9 +42,33 @@ double richardson_alpha_opt(int *la){
     return alpha;
 }
 
-void richardson_alpha(double *AB, double *RHS, double *X, double *alpha_rich, int *lab, int *la, int *ku, int *kl, double *tol, int *maxit, double *resvec, int *nbite){
+double richardson_alpha_step(double *AB, double *RHS, double *X, double *AX, double *resid, double *alpha_rich, int *lab, int *la, int *ku, int *kl){
     int i;
     int kv = 1;
+    double norm_rhs, norm_res;
+
+    // 1. Calcul de AX
+    dgbmv_poisson1D(AB, X, AX, la, lab, ku, kl, &kv);
+    
+    // 2. Calcul du résidu r = RHS - AX
+    for(i = 0; i < *la; i++){
+        resid[i] = RHS[i] - AX[i];
+    }
+    
+    // 3. Calcul de la norme du résidu normalisé
+    norm_rhs = dot_repro(la, RHS, RHS);
+    norm_res = dot_repro(la, resid, resid);
+    norm_res = sqrt(norm_res/norm_rhs);
+    
+    // 4. Mise à jour de la solution : X = X + alpha * resid
+    for(i = 0; i < *la; i++){
+        X[i] = X[i] + (*alpha_rich) * resid[i];
+    }
+    return norm_res;
+}
+
+void richardson_alpha(double *AB, double *RHS, double *X, double *alpha_rich, int *lab, int *la, int *ku, int *kl, double *tol, int *maxit, double *resvec, int *nbite){
+    int i;
     double *AX = (double *) malloc(sizeof(double)*(*la));
     double *resid = (double *) malloc(sizeof(double)*(*la));
     
@@ -61,36 +92,16 @@ void richardson_alpha(double *AB, double *RHS, double *X, double *alpha_rich, in
     *nbite = 0;
     
     do {
-        // 1. Calcul de AX
-        dgbmv_poisson1D(AB, X, AX, la, lab, ku, kl, &kv);
-        
-        // 2. Calcul du résidu r = RHS - AX
-        double norm_rhs = 0.0;
-        for(i = 0; i < *la; i++){
-            resid[i] = RHS[i] - AX[i];
-            norm_rhs += RHS[i] * RHS[i];
-        }
-        
-        // 3. Calcul de la norme du résidu normalisé
-        double norm_res = 0.0;
-        for(i = 0; i < *la; i++){
-            norm_res += resid[i] * resid[i];
-        }
-        norm_res = sqrt(norm_res/norm_rhs);
+        double norm_res = richardson_alpha_step(AB, RHS, X, AX, resid, alpha_rich, lab, la, ku, kl);
         
         // Debug: Afficher tous les 100 itérations
         if(*nbite % 100 == 0) {
             printf("Iteration %d: résidu = %e\n", *nbite, norm_res);
         }
         
-        // 4. Sauvegarde de la norme du résidu
+        // Sauvegarde de la norme du résidu
         resvec[*nbite] = norm_res;
         
-        // 5. Mise à jour de la solution : X = X + alpha * resid
-        for(i = 0; i < *la; i++){
-            X[i] = X[i] + (*alpha_rich) * resid[i];
-        }
-        
         (*nbite)++;
         
     } while (*nbite < *maxit && resvec[*nbite-1] > *tol);
@@ -99,12 +110,64 @@ void richardson_alpha(double *AB, double *RHS, double *X, double *alpha_rich, in
     free(resid);
 }
 
+/* La diagonale est sur la ligne lab-kl-1 de AB quel que soit kv :
+   le TP alloue lab = 3 mais passe kv = 1 */
 void extract_MB_jacobi_tridiag(double *AB, double *MB, int *lab, int *la,int *ku, int*kl, int *kv){
+    // M = D
+    int i, d = *lab - *kl - 1;
+    memset(MB, 0, sizeof(double)*(*lab)*(*la));
+    for (i = 0; i < *la; i++) {
+        MB[i*(*lab) + d] = AB[i*(*lab) + d];
+    }
 }
 
 void extract_MB_gauss_seidel_tridiag(double *AB, double *MB, int *lab, int *la,int *ku, int*kl, int *kv){
+    // M = D - E : diagonale et sous-diagonale
+    int i, d = *lab - *kl - 1;
+    memset(MB, 0, sizeof(double)*(*lab)*(*la));
+    for (i = 0; i < *la; i++) {
+        MB[i*(*lab) + d] = AB[i*(*lab) + d];
+        if (i < *la-1) {
+            MB[i*(*lab) + d + 1] = AB[i*(*lab) + d + 1];
+        }
+    }
 }
 
+/* X = X + alpha M^-1 (RHS - AX), alpha donné par richardson_MB_alpha */
 void richardson_MB(double *AB, double *RHS, double *X, double *MB, int *lab, int *la,int *ku, int*kl, double *tol, int *maxit, double *resvec, int *nbite){
-}
+    int i, kv = 1, d = *lab - *kl - 1;
+    double norm_rhs, norm_res;
+    double alpha = richardson_MB_alpha(AB, MB, lab, la, kl);
+    double *AX = (double *) malloc(sizeof(double)*(*la));
+    double *resid = (double *) malloc(sizeof(double)*(*la));
 
+    norm_rhs = dot_repro(la, RHS, RHS);
+    *nbite = 0;
+    do {
+        // 1. Résidu r = RHS - AX
+        dgbmv_poisson1D(AB, X, AX, la, lab, ku, kl, &kv);
+        for (i = 0; i < *la; i++) {
+            resid[i] = RHS[i] - AX[i];
+        }
+        norm_res = dot_repro(la, resid, resid);
+        norm_res = sqrt(norm_res/norm_rhs);
+        resvec[*nbite] = norm_res;
+        (*nbite)++;
+
+        // 2. Descente M z = r (M bidiagonale inférieure), z écrase r
+        for (i = 0; i < *la; i++) {
+            if (i > 0) {
+                resid[i] -= MB[(i-1)*(*lab) + d + 1] * resid[i-1];
+            }
+            resid[i] /= MB[i*(*lab) + d];
+        }
+
+        // 3. Mise à jour : X = X + alpha M^-1 r
+        for (i = 0; i < *la; i++) {
+            X[i] = X[i] + alpha * resid[i];
+        }
+    } while (*nbite < *maxit && norm_res > *tol);
+
+    free(AX);
+    free(resid);
+}
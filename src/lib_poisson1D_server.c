@@ -0,0 +1,455 @@
+/**********************************************/
+/* lib_poisson1D_server.c                     */
+/* Resident solver: Unix socket requests,     */
+/* solutions returned in shared memory        */
+/**********************************************/
+#include "lib_poisson1D.h"
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+
+static int read_full(int fd, void *buf, size_t len){
+  char *p = (char *) buf;
+  while (len > 0){
+    ssize_t r = read(fd, p, len);
+    if (r < 0 && errno == EINTR) continue;
+    if (r <= 0) return -1;
+    p += r;
+    len -= r;
+  }
+  return 0;
+}
+
+static int write_full(int fd, const void *buf, size_t len){
+  const char *p = (const char *) buf;
+  while (len > 0){
+    ssize_t w = write(fd, p, len);
+    if (w < 0 && errno == EINTR) continue;
+    if (w <= 0) return -1;
+    p += w;
+    len -= w;
+  }
+  return 0;
+}
+
+/* Cache LRU des factorisations LU (dgbtrf), partagées en lecture entre les
+   connexions et borné en octets comme le cache des solutions de base */
+static void lu_unlink(p1d_server *srv, p1d_lu_entry *e){
+  if (e->prev != NULL) e->prev->next = e->next; else srv->lu_head = e->next;
+  if (e->next != NULL) e->next->prev = e->prev; else srv->lu_tail = e->prev;
+  e->prev = e->next = NULL;
+}
+
+static void lu_push_front(p1d_server *srv, p1d_lu_entry *e){
+  e->prev = NULL;
+  e->next = srv->lu_head;
+  if (srv->lu_head != NULL) srv->lu_head->prev = e;
+  srv->lu_head = e;
+  if (srv->lu_tail == NULL) srv->lu_tail = e;
+}
+
+static void lu_entry_free(p1d_lu_entry *e){
+  free(e->AB);
+  free(e->ipiv);
+  free(e);
+}
+
+/* Éviction LRU des factorisations inutilisées, sous lu_lock */
+static void lu_evict(p1d_server *srv){
+  p1d_lu_entry *e = srv->lu_tail;
+  while (srv->lu_max_bytes > 0 && srv->lu_bytes > srv->lu_max_bytes && e != NULL){
+    p1d_lu_entry *prev = e->prev;
+    if (e->refcount == 0){
+      lu_unlink(srv, e);
+      srv->lu_bytes -= e->bytes;
+      srv->nlu--;
+      lu_entry_free(e);
+    }
+    e = prev;
+  }
+}
+
+static p1d_lu_entry *lu_acquire(p1d_server *srv, int la){
+  p1d_lu_entry *e, *other;
+  int kl = 1, ku = 1, kv = 1, lab = 4, info;
+
+  pthread_mutex_lock(&srv->lu_lock);
+  for (e=srv->lu_head;e!=NULL;e=e->next){
+    if (e->la == la) break;
+  }
+  if (e != NULL){
+    lu_unlink(srv, e);
+    lu_push_front(srv, e);
+    e->refcount++;
+    pthread_mutex_unlock(&srv->lu_lock);
+    return e;
+  }
+  pthread_mutex_unlock(&srv->lu_lock);
+
+  // Factorisation hors verrou
+  e = (p1d_lu_entry *) calloc(1, sizeof(p1d_lu_entry));
+  if (e == NULL) return NULL;
+  e->la = la;
+  e->bytes = (sizeof(double)*lab + sizeof(int))*(size_t) la;
+  e->AB = (double *) malloc(sizeof(double)*lab*(size_t) la);
+  e->ipiv = (int *) malloc(sizeof(int)*(size_t) la);
+  if (e->AB == NULL || e->ipiv == NULL){
+    printf("Erreur: allocation de la factorisation impossible pour la = %d\n", la);
+    lu_entry_free(e);
+    return NULL;
+  }
+  set_GB_operator_colMajor_poisson1D_quiet(e->AB, &lab, &la, &kv);
+  dgbtrf_(&la, &la, &kl, &ku, e->AB, &lab, e->ipiv, &info);
+  if (info != 0){
+    lu_entry_free(e);
+    return NULL;
+  }
+
+  pthread_mutex_lock(&srv->lu_lock);
+  // Un autre thread a pu insérer la même taille entre-temps
+  for (other=srv->lu_head;other!=NULL;other=other->next){
+    if (other->la == la) break;
+  }
+  if (other != NULL){
+    other->refcount++;
+    pthread_mutex_unlock(&srv->lu_lock);
+    lu_entry_free(e);
+    return other;
+  }
+  e->refcount = 1;
+  lu_push_front(srv, e);
+  srv->lu_bytes += e->bytes;
+  srv->nlu++;
+  srv->nfactor++;
+  lu_evict(srv);
+  pthread_mutex_unlock(&srv->lu_lock);
+  return e;
+}
+
+static void lu_release(p1d_server *srv, p1d_lu_entry *e){
+  pthread_mutex_lock(&srv->lu_lock);
+  e->refcount--;
+  lu_evict(srv);
+  pthread_mutex_unlock(&srv->lu_lock);
+}
+
+/* Erreur inverse ||b - Ax||inf / (4||x||inf + ||b||inf) pour [-1 2 -1], avec
+   b = B + T0 e_1 + T1 e_la (B peut être NULL : problème de Dirichlet seul) */
+static double backward_error(double *B, double T0, double T1, double *X, int la){
+  double r = 0.0, nx = 0.0, nb = 0.0;
+  int jj;
+  for (jj=0;jj<la;jj++){
+    double ax = 2.0*X[jj];
+    double b = (B != NULL) ? B[jj] : 0.0;
+    if (jj == 0) b += T0;
+    if (jj == la-1) b += T1;
+    if (jj > 0) ax -= X[jj-1];
+    if (jj < la-1) ax -= X[jj+1];
+    r = fmax(r, fabs(b - ax));
+    nx = fmax(nx, fabs(X[jj]));
+    nb = fmax(nb, fabs(b));
+  }
+  return (nx + nb > 0.0) ? r/(4.0*nx + nb) : 0.0;
+}
+
+/* Connexion vivante : chaînée dans srv->conns jusqu'à la fin de son thread */
+typedef struct p1d_conn {
+  p1d_server *srv;
+  int fd;
+  struct p1d_conn *next;
+} p1d_conn;
+
+static void conn_release(p1d_conn *conn){
+  p1d_server *srv = conn->srv;
+  p1d_conn **pc;
+  pthread_mutex_lock(&srv->conn_lock);
+  for (pc=&srv->conns;*pc!=NULL;pc=&(*pc)->next){
+    if (*pc == conn){
+      *pc = conn->next;
+      break;
+    }
+  }
+  srv->nconn--;
+  pthread_cond_broadcast(&srv->conn_done);
+  pthread_mutex_unlock(&srv->conn_lock);
+  free(conn);
+}
+
+static void *p1d_connection(void *arg){
+  p1d_conn *conn = (p1d_conn *) arg;
+  p1d_server *srv = conn->srv;
+  int fd = conn->fd;
+  p1d_request req;
+  p1d_reply rep;
+  double *shm = NULL, *work = NULL;
+  size_t shmlen = 0;
+  int workcap = 0;
+
+  while (read_full(fd, &req, sizeof(req)) == 0){
+    memset(&rep, 0, sizeof(rep));
+    rep.la = req.la;
+    if (req.magic != P1D_SERVER_MAGIC){
+      rep.status = P1D_EPROTO;
+    } else if (req.op == P1D_OP_ATTACH){
+      // Segment partagé du client, projeté une fois pour toute la connexion
+      int sfd;
+      struct stat st;
+      req.shm[sizeof(req.shm)-1] = '\0';
+      if (shm != NULL) munmap(shm, shmlen);
+      shm = NULL;
+      shmlen = 0;
+      sfd = shm_open(req.shm, O_RDWR, 0);
+      if (sfd < 0 || fstat(sfd, &st) != 0){
+        rep.status = P1D_ESHM;
+      } else {
+        shmlen = (size_t) st.st_size;
+        shm = (double *) mmap(NULL, shmlen, PROT_READ | PROT_WRITE, MAP_SHARED, sfd, 0);
+        if (shm == MAP_FAILED){
+          shm = NULL;
+          shmlen = 0;
+          rep.status = P1D_ESHM;
+        }
+      }
+      if (sfd >= 0) close(sfd);
+    } else if (req.op == P1D_OP_SOLVE){
+      if (shm == NULL || req.la < 1 || sizeof(double)*(size_t) req.la > shmlen){
+        rep.status = P1D_ESHM;
+      } else if (req.solver == P1D_SOLVER_BCCACHE){
+        // Conditions de Dirichlet seules : une combinaison des solutions de base
+        if (bc_cache_solve(&srv->bc, &req.la, &req.T0, &req.T1, shm) != 0){
+          rep.status = P1D_ESOLVE;
+        } else {
+          rep.berr = backward_error(NULL, req.T0, req.T1, shm, req.la);
+          rep.status = (rep.berr > req.tol) ? P1D_ETOL : 0;
+        }
+      } else if (req.solver == P1D_SOLVER_LU){
+        // Second membre lu dans le segment, solution écrite à sa place
+        p1d_lu_entry *e = lu_acquire(srv, req.la);
+        int kl = 1, ku = 1, lab = 4, nrhs = 1, info;
+        if (e != NULL && req.la > workcap){
+          free(work);
+          work = (double *) malloc(sizeof(double)*req.la);
+          workcap = (work != NULL) ? req.la : 0;
+        }
+        if (e == NULL || work == NULL){
+          rep.status = P1D_ESOLVE;
+        } else {
+          memcpy(work, shm, sizeof(double)*req.la);
+          dgbtrs_("N", &req.la, &kl, &ku, &nrhs, e->AB, &lab, e->ipiv, shm, &req.la, &info);
+          rep.berr = backward_error(work, 0.0, 0.0, shm, req.la);
+          rep.status = (info != 0) ? P1D_ESOLVE : (rep.berr > req.tol) ? P1D_ETOL : 0;
+        }
+        if (e != NULL) lu_release(srv, e);
+      } else {
+        rep.status = P1D_EPROTO;
+      }
+      __sync_fetch_and_add(&srv->nrequests, 1ULL);
+    } else if (req.op == P1D_OP_SHUTDOWN){
+      p1d_server_stop(srv);
+    } else {
+      rep.status = P1D_EPROTO;
+    }
+    if (write_full(fd, &rep, sizeof(rep)) != 0) break;
+  }
+
+  if (shm != NULL) munmap(shm, shmlen);
+  free(work);
+  close(fd);
+  conn_release(conn);
+  return NULL;
+}
+
+int p1d_server_init(p1d_server *srv, char *path, size_t cache_bytes){
+  struct sockaddr_un addr;
+
+  memset(srv, 0, sizeof(p1d_server));
+  if (strlen(path) >= sizeof(addr.sun_path)){
+    printf("Erreur: chemin de socket trop long\n");
+    return -1;
+  }
+  strcpy(srv->path, path);
+  bc_cache_init(&srv->bc, cache_bytes);
+  srv->lu_max_bytes = cache_bytes;
+  pthread_mutex_init(&srv->lu_lock, NULL);
+  pthread_mutex_init(&srv->conn_lock, NULL);
+  pthread_cond_init(&srv->conn_done, NULL);
+
+  srv->fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (srv->fd < 0){
+    perror("socket");
+    return -1;
+  }
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  strcpy(addr.sun_path, path);
+  unlink(path);
+  if (bind(srv->fd, (struct sockaddr *) &addr, sizeof(addr)) != 0 || listen(srv->fd, 64) != 0){
+    perror(path);
+    close(srv->fd);
+    srv->fd = -1;
+    return -1;
+  }
+  return 0;
+}
+
+/* Boucle d'acceptation : un thread par connexion, jusqu'à p1d_server_stop ;
+   au retour, plus aucun thread de connexion n'utilise srv */
+int p1d_server_run(p1d_server *srv){
+  pthread_attr_t attr;
+  p1d_conn *c;
+  pthread_attr_init(&attr);
+  pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+  while (!srv->stop){
+    pthread_t th;
+    p1d_conn *conn;
+    int cfd = accept(srv->fd, NULL, NULL);
+    if (cfd < 0){
+      if (errno == EINTR) continue;
+      break;
+    }
+    conn = (p1d_conn *) malloc(sizeof(p1d_conn));
+    if (conn == NULL){
+      close(cfd);
+      continue;
+    }
+    conn->srv = srv;
+    conn->fd = cfd;
+    pthread_mutex_lock(&srv->conn_lock);
+    conn->next = srv->conns;
+    srv->conns = conn;
+    srv->nconn++;
+    pthread_mutex_unlock(&srv->conn_lock);
+    if (pthread_create(&th, &attr, p1d_connection, conn) != 0){
+      close(cfd);
+      conn_release(conn);
+    }
+  }
+  pthread_attr_destroy(&attr);
+
+  // Drain : SHUT_RD termine la lecture de la requête suivante, la requête
+  // en cours (y compris P1D_OP_SHUTDOWN) reçoit encore sa réponse
+  pthread_mutex_lock(&srv->conn_lock);
+  for (c=srv->conns;c!=NULL;c=c->next){
+    shutdown(c->fd, SHUT_RD);
+  }
+  while (srv->nconn > 0){
+    pthread_cond_wait(&srv->conn_done, &srv->conn_lock);
+  }
+  pthread_mutex_unlock(&srv->conn_lock);
+  return 0;
+}
+
+/* Utilisable depuis un gestionnaire de signal : shutdown() réveille accept() */
+void p1d_server_stop(p1d_server *srv){
+  srv->stop = 1;
+  shutdown(srv->fd, SHUT_RDWR);
+}
+
+void p1d_server_free(p1d_server *srv){
+  p1d_lu_entry *e = srv->lu_head;
+  if (srv->fd >= 0){
+    close(srv->fd);
+    unlink(srv->path);
+  }
+  while (e != NULL){
+    p1d_lu_entry *next = e->next;
+    lu_entry_free(e);
+    e = next;
+  }
+  srv->lu_head = srv->lu_tail = NULL;
+  srv->lu_bytes = 0;
+  srv->nlu = 0;
+  bc_cache_free(&srv->bc);
+  pthread_mutex_destroy(&srv->lu_lock);
+  pthread_mutex_destroy(&srv->conn_lock);
+  pthread_cond_destroy(&srv->conn_done);
+}
+
+/* Côté client : segment partagé de maxla doubles, attaché une fois */
+int p1d_client_connect(p1d_client *cli, char *path, int maxla){
+  static int counter = 0;
+  struct sockaddr_un addr;
+  p1d_request req;
+  p1d_reply rep;
+  int sfd;
+
+  memset(cli, 0, sizeof(p1d_client));
+  cli->fd = -1;
+  cli->maxla = maxla;
+  cli->len = sizeof(double)*(size_t) maxla;
+  snprintf(cli->shm, sizeof(cli->shm), "/poisson1D_%d_%d", (int) getpid(), __sync_fetch_and_add(&counter, 1));
+  sfd = shm_open(cli->shm, O_RDWR | O_CREAT | O_EXCL, 0600);
+  if (sfd < 0 || ftruncate(sfd, (off_t) cli->len) != 0){
+    perror(cli->shm);
+    if (sfd >= 0){
+      close(sfd);
+      shm_unlink(cli->shm);
+    }
+    return -1;
+  }
+  cli->X = (double *) mmap(NULL, cli->len, PROT_READ | PROT_WRITE, MAP_SHARED, sfd, 0);
+  close(sfd);
+  if (cli->X == MAP_FAILED){
+    perror(cli->shm);
+    cli->X = NULL;
+    shm_unlink(cli->shm);
+    return -1;
+  }
+
+  cli->fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  strncpy(addr.sun_path, path, sizeof(addr.sun_path)-1);
+  if (cli->fd < 0 || connect(cli->fd, (struct sockaddr *) &addr, sizeof(addr)) != 0){
+    perror(path);
+    p1d_client_close(cli);
+    return -1;
+  }
+
+  memset(&req, 0, sizeof(req));
+  req.magic = P1D_SERVER_MAGIC;
+  req.op = P1D_OP_ATTACH;
+  memcpy(req.shm, cli->shm, sizeof(req.shm));
+  if (write_full(cli->fd, &req, sizeof(req)) != 0 || read_full(cli->fd, &rep, sizeof(rep)) != 0 || rep.status != 0){
+    printf("Erreur: le serveur n'a pas pu attacher %s\n", cli->shm);
+    p1d_client_close(cli);
+    return -1;
+  }
+  return 0;
+}
+
+/* Requête synchrone ; la solution est dans cli->X au retour */
+int p1d_client_solve(p1d_client *cli, p1d_request *req, p1d_reply *rep){
+  if (req->la < 1 || req->la > cli->maxla) return P1D_ESHM;
+  req->magic = P1D_SERVER_MAGIC;
+  req->op = P1D_OP_SOLVE;
+  if (write_full(cli->fd, req, sizeof(p1d_request)) != 0 || read_full(cli->fd, rep, sizeof(p1d_reply)) != 0){
+    return P1D_EPROTO;
+  }
+  return rep->status;
+}
+
+int p1d_client_shutdown(p1d_client *cli){
+  p1d_request req;
+  p1d_reply rep;
+  memset(&req, 0, sizeof(req));
+  req.magic = P1D_SERVER_MAGIC;
+  req.op = P1D_OP_SHUTDOWN;
+  if (write_full(cli->fd, &req, sizeof(req)) != 0 || read_full(cli->fd, &rep, sizeof(rep)) != 0){
+    return P1D_EPROTO;
+  }
+  return rep.status;
+}
+
+void p1d_client_close(p1d_client *cli){
+  if (cli->fd >= 0) close(cli->fd);
+  if (cli->X != NULL) munmap(cli->X, cli->len);
+  if (cli->shm[0] != '\0') shm_unlink(cli->shm);
+  cli->fd = -1;
+  cli->X = NULL;
+  cli->shm[0] = '\0';
+}
@@ -0,0 +1,316 @@
+/**********************************************/
+/* lib_poisson1D_snapshot.c                   */
+/* Compressed snapshots (.p1z): error-bounded */
+/* predictive coding of smooth fields,        */
+/* lossless XOR coding of histories,          */
+/* independent chunks for random access       */
+/**********************************************/
+#include "lib_poisson1D.h"
+
+#define P1Z_MAGIC "P1Z1"
+#define P1Z_BLOCK 64
+#define P1Z_KIND_PRED 0
+#define P1Z_KIND_RAW 1
+#define P1Z_KIND_XOR 2
+
+/* Écriture/lecture bit à bit, poids faibles d'abord */
+typedef struct {
+  unsigned char *p;
+  unsigned long long acc;
+  int nbits;
+} p1z_bits;
+
+static void bw_put(p1z_bits *b, unsigned long long v, int w){
+  if (w > 32){
+    bw_put(b, v & 0xffffffffULL, 32);
+    bw_put(b, v >> 32, w - 32);
+    return;
+  }
+  b->acc |= (v & ((1ULL << w) - 1)) << b->nbits;
+  b->nbits += w;
+  while (b->nbits >= 8){
+    *b->p++ = (unsigned char) b->acc;
+    b->acc >>= 8;
+    b->nbits -= 8;
+  }
+}
+
+static void bw_flush(p1z_bits *b){
+  if (b->nbits > 0) *b->p++ = (unsigned char) b->acc;
+  b->acc = 0;
+  b->nbits = 0;
+}
+
+static unsigned long long br_get(p1z_bits *b, int w){
+  unsigned long long v;
+  if (w > 32){
+    v = br_get(b, 32);
+    return v | (br_get(b, w - 32) << 32);
+  }
+  while (b->nbits < w){
+    b->acc |= (unsigned long long) (*b->p++) << b->nbits;
+    b->nbits += 8;
+  }
+  v = b->acc & ((1ULL << w) - 1);
+  b->acc >>= w;
+  b->nbits -= w;
+  return v;
+}
+
+static unsigned long long dbits(double x){
+  unsigned long long u;
+  memcpy(&u, &x, sizeof(u));
+  return u;
+}
+
+static double bitsd(unsigned long long u){
+  double x;
+  memcpy(&x, &u, sizeof(x));
+  return x;
+}
+
+/* Prédiction linéaire sur les entiers quantifiés : exacte au décodage, les
+   erreurs ne s'accumulent pas */
+static long long pred(const long long *q, int i){
+  if (i >= 2) return 2*q[i-1] - q[i-2];
+  return (i == 1) ? q[0] : 0;
+}
+
+/* Quantification q = round(x/2eb) ; le bloc est stocké brut si une valeur
+   ne respecte pas |x - 2eb q| <= eb une fois reconstruite */
+static size_t p1z_encode_chunk(const double *v, int m, double eb, long long *q, unsigned char *out){
+  p1z_bits b = {out, 0, 0};
+  double step = 2.0*eb;
+  int i, j, kind = (eb > 0.0) ? P1Z_KIND_PRED : P1Z_KIND_XOR;
+
+  if (kind == P1Z_KIND_PRED){
+    for (i=0;i<m;i++){
+      double t = v[i]/step;
+      if (!(fabs(t) < 4503599627370496.0)){   // 2^52, NaN et infinis exclus
+        kind = P1Z_KIND_RAW;
+        break;
+      }
+      q[i] = llrint(t);
+      if (!(fabs(v[i] - step*(double) q[i]) <= eb)){
+        kind = P1Z_KIND_RAW;
+        break;
+      }
+    }
+  }
+  bw_put(&b, kind, 8);
+  if (kind == P1Z_KIND_PRED){
+    for (i=0;i<m;i+=P1Z_BLOCK){
+      int e = (i + P1Z_BLOCK < m) ? i + P1Z_BLOCK : m, w = 0;
+      unsigned long long zmax = 0, z[P1Z_BLOCK];
+      // Zigzag : petits résidus signés -> petits entiers non signés
+      for (j=i;j<e;j++){
+        long long r = q[j] - pred(q, j);
+        z[j-i] = ((unsigned long long) r << 1) ^ (unsigned long long) (r >> 63);
+        zmax |= z[j-i];
+      }
+      if (zmax != 0) w = 64 - __builtin_clzll(zmax);
+      bw_put(&b, w, 7);
+      for (j=i;j<e;j++) bw_put(&b, z[j-i], w);
+    }
+  } else if (kind == P1Z_KIND_RAW){
+    for (i=0;i<m;i++) bw_put(&b, dbits(v[i]), 64);
+  } else {
+    // XOR avec la valeur précédente : seuls les bits significatifs
+    unsigned long long prev = 0;
+    for (i=0;i<m;i++){
+      unsigned long long u = dbits(v[i]), x = u ^ prev;
+      if (x == 0){
+        bw_put(&b, 0, 1);
+      } else {
+        int lz = __builtin_clzll(x), tz = __builtin_ctzll(x), len = 64 - lz - tz;
+        bw_put(&b, 1, 1);
+        bw_put(&b, lz, 6);
+        bw_put(&b, len - 1, 6);
+        bw_put(&b, x >> tz, len);
+      }
+      prev = u;
+    }
+  }
+  bw_flush(&b);
+  return (size_t) (b.p - out);
+}
+
+static void p1z_decode_chunk(const unsigned char *in, int m, double eb, long long *q, double *v){
+  p1z_bits b = {(unsigned char *) in, 0, 0};
+  int i, j, kind = (int) br_get(&b, 8);
+
+  if (kind == P1Z_KIND_PRED){
+    for (i=0;i<m;i+=P1Z_BLOCK){
+      int e = (i + P1Z_BLOCK < m) ? i + P1Z_BLOCK : m, w = (int) br_get(&b, 7);
+      for (j=i;j<e;j++){
+        unsigned long long z = br_get(&b, w);
+        long long r = (long long) (z >> 1) ^ -(long long) (z & 1);
+        q[j] = pred(q, j) + r;
+        v[j] = 2.0*eb*(double) q[j];
+      }
+    }
+  } else if (kind == P1Z_KIND_RAW){
+    for (i=0;i<m;i++) v[i] = bitsd(br_get(&b, 64));
+  } else {
+    unsigned long long prev = 0;
+    for (i=0;i<m;i++){
+      if (br_get(&b, 1)){
+        int lz = (int) br_get(&b, 6), len = (int) br_get(&b, 6) + 1;
+        prev ^= br_get(&b, len) << (64 - lz - len);
+      }
+      v[i] = bitsd(prev);
+    }
+  }
+}
+
+/* Pire cas : XOR, 1+6+6+64 bits par valeur */
+static size_t p1z_chunk_cap(int chunk){
+  return 10*(size_t) chunk + 16;
+}
+
+int p1z_write(double *vec, long long n, double eb, int chunk, char *filename){
+  FILE *file;
+  int nchunks, c, mode = (eb > 0.0) ? P1Z_LOSSY : P1Z_LOSSLESS, ret = 0;
+  size_t cap;
+  unsigned char *buf;
+  unsigned long long *off;
+  size_t *len;
+
+  if (chunk <= 0) chunk = P1Z_CHUNK;
+  if (mode == P1Z_LOSSLESS) eb = 0.0;
+  nchunks = (int) ((n + chunk - 1)/chunk);
+  cap = p1z_chunk_cap(chunk);
+  buf = (unsigned char *) malloc(cap*(size_t) (nchunks > 0 ? nchunks : 1));
+  off = (unsigned long long *) malloc(sizeof(unsigned long long)*(nchunks+1));
+  len = (size_t *) malloc(sizeof(size_t)*(nchunks > 0 ? nchunks : 1));
+  if (buf == NULL || off == NULL || len == NULL){
+    perror("p1z_write");
+    free(buf); free(off); free(len);
+    return -1;
+  }
+  // Tranches indépendantes : codage parallèle
+  #pragma omp parallel
+  {
+    long long *q = (long long *) malloc(sizeof(long long)*chunk);
+    #pragma omp for schedule(dynamic, 4)
+    for (c=0;c<nchunks;c++){
+      long long i0 = (long long) c*chunk;
+      int m = (n - i0 < chunk) ? (int) (n - i0) : chunk;
+      len[c] = p1z_encode_chunk(vec + i0, m, eb, q, buf + (size_t) c*cap);
+    }
+    free(q);
+  }
+  off[0] = 0;
+  for (c=0;c<nchunks;c++) off[c+1] = off[c] + len[c];
+
+  file = fopen(filename, "wb");
+  if (file == NULL){
+    perror(filename);
+    ret = -1;
+  } else {
+    fwrite(P1Z_MAGIC, 1, 4, file);
+    fwrite(&mode, sizeof(int), 1, file);
+    fwrite(&chunk, sizeof(int), 1, file);
+    fwrite(&nchunks, sizeof(int), 1, file);
+    fwrite(&n, sizeof(long long), 1, file);
+    fwrite(&eb, sizeof(double), 1, file);
+    fwrite(off, sizeof(unsigned long long), nchunks+1, file);
+    for (c=0;c<nchunks;c++) fwrite(buf + (size_t) c*cap, 1, len[c], file);
+    if (ferror(file)) ret = -1;
+    if (fclose(file) != 0) ret = -1;
+    if (ret != 0) perror(filename);
+  }
+  free(buf); free(off); free(len);
+  return ret;
+}
+
+int p1z_open(p1z_reader *r, char *filename){
+  char magic[4];
+  int ok;
+  memset(r, 0, sizeof(p1z_reader));
+  r->file = fopen(filename, "rb");
+  if (r->file == NULL){
+    perror(filename);
+    return -1;
+  }
+  ok = fread(magic, 1, 4, r->file) == 4 && memcmp(magic, P1Z_MAGIC, 4) == 0
+    && fread(&r->mode, sizeof(int), 1, r->file) == 1
+    && fread(&r->chunk, sizeof(int), 1, r->file) == 1
+    && fread(&r->nchunks, sizeof(int), 1, r->file) == 1
+    && fread(&r->n, sizeof(long long), 1, r->file) == 1
+    && fread(&r->eb, sizeof(double), 1, r->file) == 1
+    && r->chunk > 0 && r->nchunks >= 0 && r->n >= 0
+    && (long long) r->nchunks == (r->n + r->chunk - 1)/r->chunk;
+  if (ok){
+    r->off = (unsigned long long *) malloc(sizeof(unsigned long long)*(r->nchunks+1));
+    ok = r->off != NULL && fread(r->off, sizeof(unsigned long long), r->nchunks+1, r->file) == (size_t) r->nchunks+1;
+  }
+  if (!ok){
+    printf("Erreur: %s n'est pas un fichier p1z valide\n", filename);
+    p1z_close(r);
+    return -1;
+  }
+  r->data = ftell(r->file);
+  return 0;
+}
+
+void p1z_close(p1z_reader *r){
+  if (r->file != NULL) fclose(r->file);
+  free(r->off);
+  r->file = NULL;
+  r->off = NULL;
+}
+
+/* out[0..n-1] = valeurs i0..i0+n-1 : seules les tranches concernées sont
+   lues et décodées, en parallèle */
+int p1z_read(p1z_reader *r, long long i0, long long n, double *out){
+  int c0, c1, c;
+  unsigned char *buf;
+  size_t nbytes;
+  if (i0 < 0 || n < 0 || i0 + n > r->n) return -1;
+  if (n == 0) return 0;
+  c0 = (int) (i0/r->chunk);
+  c1 = (int) ((i0 + n - 1)/r->chunk);
+  // Octets de bourrage : br_get peut lire au-delà du dernier octet utile
+  nbytes = r->off[c1+1] - r->off[c0];
+  buf = (unsigned char *) calloc(nbytes + 8, 1);
+  if (buf == NULL){
+    perror("p1z_read");
+    return -1;
+  }
+  if (fseek(r->file, r->data + (long) r->off[c0], SEEK_SET) != 0
+      || fread(buf, 1, nbytes, r->file) != nbytes){
+    printf("Erreur: p1z_read, fichier tronqué\n");
+    free(buf);
+    return -1;
+  }
+  #pragma omp parallel
+  {
+    long long *q = (long long *) malloc(sizeof(long long)*r->chunk);
+    double *v = (double *) malloc(sizeof(double)*r->chunk);
+    #pragma omp for schedule(dynamic, 4)
+    for (c=c0;c<=c1;c++){
+      long long s = (long long) c*r->chunk, e = s + r->chunk, a, z;
+      int m;
+      if (e > r->n) e = r->n;
+      m = (int) (e - s);
+      a = (s > i0) ? s : i0;
+      z = (e < i0 + n) ? e : i0 + n;
+      p1z_decode_chunk(buf + (r->off[c] - r->off[c0]), m, r->eb, q, v);
+      memcpy(out + (a - i0), v + (a - s), sizeof(double)*(size_t) (z - a));
+    }
+    free(q);
+    free(v);
+  }
+  free(buf);
+  return 0;
+}
+
+/* POISSON1D_COMPRESS=<borne d'erreur absolue> ou "lossless" */
+int poisson1D_compress_eb(double *eb){
+  char *env = getenv("POISSON1D_COMPRESS");
+  if (env == NULL || env[0] == '\0') return 0;
+  *eb = (strcmp(env, "lossless") == 0) ? 0.0 : atof(env);
+  if (*eb < 0.0) *eb = 0.0;
+  return 1;
+}
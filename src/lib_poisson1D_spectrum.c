@@ -0,0 +1,291 @@
+/**********************************************/
+/* lib_poisson1D_spectrum.c                   */
+/* Extreme eigenvalues of tridiagonal         */
+/* operators by Lanczos, cached per operator, */
+/* for the Richardson and Chebyshev steps     */
+/**********************************************/
+#include "lib_poisson1D.h"
+
+/* Ligne de la diagonale dans le stockage bande : kv = lab - 3 */
+#define SP_SUP(AB, lab, i) ((AB)[(size_t) (lab)*(i) + (lab) - 3])   /* A(i-1,i) */
+#define SP_DIAG(AB, lab, i) ((AB)[(size_t) (lab)*(i) + (lab) - 2])
+#define SP_SUB(AB, lab, i) ((AB)[(size_t) (lab)*(i) + (lab) - 1])   /* A(i+1,i) */
+
+/* y = S x, S = A ou D^-1/2 A D^-1/2 (symétrique si A l'est) ; s = D^-1/2 */
+static void sp_matvec(double *AB, int lab, int n, const double *s, const double *x, double *y){
+  int i;
+  for (i=0;i<n;i++){
+    double xi = (s != NULL) ? s[i]*x[i] : x[i], v = SP_DIAG(AB, lab, i)*xi;
+    if (i > 0) v += SP_SUB(AB, lab, i-1)*((s != NULL) ? s[i-1]*x[i-1] : x[i-1]);
+    if (i < n-1) v += SP_SUP(AB, lab, i+1)*((s != NULL) ? s[i+1]*x[i+1] : x[i+1]);
+    y[i] = (s != NULL) ? s[i]*v : v;
+  }
+}
+
+/* Nombre de valeurs propres de T (diagonale a, hors-diagonale b) < x (Sturm) */
+static int sp_sturm(const double *a, const double *b, int m, double x){
+  int j, count = 0;
+  double q = 1.0;
+  for (j=0;j<m;j++){
+    q = (a[j] - x) - ((j > 0) ? b[j-1]*b[j-1]/q : 0.0);
+    if (q == 0.0) q = -DBL_EPSILON*(fabs(a[j]) + fabs(x) + DBL_MIN);
+    if (q < 0.0) count++;
+  }
+  return count;
+}
+
+/* k-ième plus petite valeur propre de T par bissection sur [lo, hi] */
+static double sp_bisect(const double *a, const double *b, int m, int k, double lo, double hi){
+  int it;
+  for (it=0;it<200 && hi - lo > 2.0*DBL_EPSILON*fmax(fabs(lo), fabs(hi));it++){
+    double mid = 0.5*(lo + hi);
+    if (sp_sturm(a, b, m, mid) > k) hi = mid; else lo = mid;
+  }
+  return 0.5*(lo + hi);
+}
+
+/* |dernière composante| du vecteur propre de T pour theta : itération inverse */
+static double sp_lastcomp(const double *a, const double *b, int m, double theta){
+  double *x = (double *) malloc(sizeof(double)*m), *c = (double *) malloc(sizeof(double)*m);
+  double shift = theta + 1e3*DBL_EPSILON*(fabs(theta) + 1.0), nrm, last;
+  int it, j;
+  for (j=0;j<m;j++) x[j] = 1.0;
+  for (it=0;it<3;it++){
+    // (T - shift I) y = x, Thomas sans pivotage (décalage hors du spectre discret)
+    double den = a[0] - shift;
+    c[0] = (m > 1) ? b[0]/den : 0.0;
+    x[0] /= den;
+    for (j=1;j<m;j++){
+      den = (a[j] - shift) - b[j-1]*c[j-1];
+      if (j < m-1) c[j] = b[j]/den;
+      x[j] = (x[j] - b[j-1]*x[j-1])/den;
+    }
+    for (j=m-2;j>=0;j--) x[j] -= c[j]*x[j+1];
+    nrm = 0.0;
+    for (j=0;j<m;j++) nrm += x[j]*x[j];
+    nrm = sqrt(nrm);
+    for (j=0;j<m;j++) x[j] /= nrm;
+  }
+  last = fabs(x[m-1]);
+  free(x);
+  free(c);
+  return last;
+}
+
+int spectrum_lanczos_tridiag(double *AB, int *lab, int *la, int prec, int *m, p1d_spectrum *spec){
+  int n = *la, mm = (*m < n) ? *m : n, j, i;
+  double *v = (double *) malloc(sizeof(double)*n), *w = (double *) malloc(sizeof(double)*n);
+  double *vold = (double *) calloc(n, sizeof(double)), *s = NULL;
+  double *a = (double *) malloc(sizeof(double)*(mm+1)), *b = (double *) malloc(sizeof(double)*(mm+1));
+  double beta = 0.0, lo, hi, nrm = 0.0;
+  int exact = 0;
+  unsigned long long seed = 0x9E3779B97F4A7C15ULL;
+
+  if (v == NULL || w == NULL || vold == NULL || a == NULL || b == NULL || mm < 1){
+    free(v); free(w); free(vold); free(a); free(b);
+    return -1;
+  }
+  // Lanczos symétrique : sur un opérateur non symétrique (convection-diffusion),
+  // les valeurs de Ritz ne bornent rien
+  for (i=0;i<n-1;i++){
+    double l = SP_SUB(AB, *lab, i), u = SP_SUP(AB, *lab, i+1);
+    if (fabs(l - u) > 64.0*DBL_EPSILON*(fabs(l) + fabs(u))){
+      free(v); free(w); free(vold); free(a); free(b);
+      return SPECTRUM_ENONSYM;
+    }
+  }
+  if (prec == KRYLOV_PREC_JACOBI){
+    s = (double *) malloc(sizeof(double)*n);
+    for (i=0;i<n;i++){
+      if (!(SP_DIAG(AB, *lab, i) > 0.0)){
+        printf("Erreur: spectrum_lanczos_tridiag, diagonale non positive en %d\n", i);
+        free(v); free(w); free(vold); free(a); free(b); free(s);
+        return -1;
+      }
+      s[i] = 1.0/sqrt(SP_DIAG(AB, *lab, i));
+    }
+  }
+  // Vecteur de départ pseudo-aléatoire fixe : estimation reproductible
+  for (i=0;i<n;i++){
+    seed ^= seed >> 12; seed ^= seed << 25; seed ^= seed >> 27;
+    v[i] = ((seed*2685821657736338717ULL) >> 11)*(1.0/9007199254740992.0) - 0.5;
+  }
+  nrm = nrm2_repro(&n, v);
+  for (i=0;i<n;i++) v[i] /= nrm;
+  for (j=0;j<mm;j++){
+    double *t;
+    sp_matvec(AB, *lab, n, s, v, w);
+    a[j] = dot_repro(&n, w, v);
+    for (i=0;i<n;i++) w[i] -= a[j]*v[i] + beta*vold[i];
+    beta = nrm2_repro(&n, w);
+    b[j] = beta;
+    // Sous-espace invariant : T_j est exacte
+    if (beta <= 1e3*DBL_EPSILON*fabs(a[j])){
+      j++;
+      exact = 1;
+      break;
+    }
+    for (i=0;i<n;i++) w[i] /= beta;
+    t = vold; vold = v; v = w; w = t;
+  }
+  mm = j;
+  spec->nmatvec = mm;
+  // Gershgorin sur T, puis bissection des deux valeurs extrêmes
+  lo = hi = a[0];
+  for (j=0;j<mm;j++){
+    double r = ((j > 0) ? fabs(b[j-1]) : 0.0) + ((j < mm-1) ? fabs(b[j]) : 0.0);
+    lo = fmin(lo, a[j] - r);
+    hi = fmax(hi, a[j] + r);
+  }
+  spec->theta_min = sp_bisect(a, b, mm, 0, lo, hi);
+  spec->theta_max = sp_bisect(a, b, mm, mm-1, lo, hi);
+  // Bornes de Kaniel-Paige : |beta_m s_m| pour chaque valeur de Ritz
+  spec->res_min = fabs(b[mm-1])*sp_lastcomp(a, b, mm, spec->theta_min);
+  spec->res_max = fabs(b[mm-1])*sp_lastcomp(a, b, mm, spec->theta_max);
+  spec->lmin = spec->theta_min;
+  spec->lmax = spec->theta_max + spec->res_max;
+  // Valeur de Ritz pas encore convergée : la borne de résidu encadre une
+  // valeur propre, pas forcément la plus grande ; marge de 5 % de l'intervalle,
+  // plafonnée par Gershgorin sur A
+  if (!exact && mm < n){
+    double g = 0.0;
+    for (i=0;i<n;i++){
+      double si = (s != NULL) ? s[i] : 1.0, gi = si*SP_DIAG(AB, *lab, i)*si;
+      if (i > 0) gi += fabs(si*SP_SUB(AB, *lab, i-1)*((s != NULL) ? s[i-1] : 1.0));
+      if (i < n-1) gi += fabs(si*SP_SUP(AB, *lab, i+1)*((s != NULL) ? s[i+1] : 1.0));
+      g = fmax(g, gi);
+    }
+    spec->lmax = fmin(g, fmax(spec->lmax, spec->theta_max + 0.05*(spec->theta_max - spec->theta_min)));
+  }
+  spec->cached = 0;
+  free(v); free(w); free(vold); free(a); free(b); free(s);
+  return 0;
+}
+
+/* Cache des estimations : clé = taille, préconditionneur et empreinte FNV-1a
+   des trois diagonales */
+typedef struct {
+  int la;
+  int prec;
+  unsigned long long hash;
+  p1d_spectrum spec;
+} spectrum_entry;
+
+static spectrum_entry sp_cache[SPECTRUM_CACHE_SIZE];
+static int sp_cache_n = 0, sp_cache_next = 0;
+static pthread_mutex_t sp_cache_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static unsigned long long sp_hash(double *AB, int lab, int n){
+  unsigned long long h = 0xcbf29ce484222325ULL, u;
+  int i, k;
+  for (i=0;i<n;i++){
+    for (k=lab-3;k<lab;k++){
+      memcpy(&u, &AB[(size_t) lab*i + k], sizeof(u));
+      h = (h ^ u)*0x100000001b3ULL;
+    }
+  }
+  return h;
+}
+
+int spectrum_get(double *AB, int *lab, int *la, int prec, p1d_spectrum *spec){
+  unsigned long long h = sp_hash(AB, *lab, *la);
+  int e, m = SPECTRUM_M, info;
+  pthread_mutex_lock(&sp_cache_lock);
+  for (e=0;e<sp_cache_n;e++){
+    if (sp_cache[e].la == *la && sp_cache[e].prec == prec && sp_cache[e].hash == h){
+      *spec = sp_cache[e].spec;
+      spec->cached = 1;
+      pthread_mutex_unlock(&sp_cache_lock);
+      return 0;
+    }
+  }
+  pthread_mutex_unlock(&sp_cache_lock);
+  info = spectrum_lanczos_tridiag(AB, lab, la, prec, &m, spec);
+  if (info != 0) return info;
+  pthread_mutex_lock(&sp_cache_lock);
+  e = sp_cache_next;
+  sp_cache_next = (sp_cache_next + 1) % SPECTRUM_CACHE_SIZE;
+  if (sp_cache_n < SPECTRUM_CACHE_SIZE) sp_cache_n++;
+  sp_cache[e].la = *la;
+  sp_cache[e].prec = prec;
+  sp_cache[e].hash = h;
+  sp_cache[e].spec = *spec;
+  pthread_mutex_unlock(&sp_cache_lock);
+  return 0;
+}
+
+void spectrum_cache_clear(void){
+  pthread_mutex_lock(&sp_cache_lock);
+  sp_cache_n = 0;
+  sp_cache_next = 0;
+  pthread_mutex_unlock(&sp_cache_lock);
+}
+
+double richardson_alpha_auto(double *AB, int *lab, int *la){
+  p1d_spectrum spec;
+  if (spectrum_get(AB, lab, la, KRYLOV_PREC_NONE, &spec) != 0) return 0.0;
+  return 2.0/(spec.lmin + spec.lmax);
+}
+
+double richardson_MB_alpha(double *AB, double *MB, int *lab, int *la, int *kl){
+  p1d_spectrum spec;
+  int i, d = *lab - *kl - 1;
+  // Une sous-diagonale non nulle dans MB : découpage de Gauss-Seidel, pas 1
+  for (i=0;i<*la-1;i++){
+    if (MB[(size_t) (*lab)*i + d + 1] != 0.0) return 1.0;
+  }
+  // M = D : spectre de D^-1 A = spectre de D^-1/2 A D^-1/2
+  if (spectrum_get(AB, lab, la, KRYLOV_PREC_JACOBI, &spec) != 0) return 1.0;
+  return 2.0/(spec.lmin + spec.lmax);
+}
+
+/* Itération de Chebyshev sur [lmin, lmax] (Saad, algorithme 12.1) */
+int chebyshev_tridiag(double *AB, double *RHS, double *X, int *lab, int *la, int prec,
+                      double *tol, int *maxit, double *resvec, int *nbite){
+  int n = *la, i;
+  double *r = (double *) malloc(sizeof(double)*n), *d = (double *) malloc(sizeof(double)*n);
+  double *Ad = (double *) malloc(sizeof(double)*n), *dinv = NULL;
+  double theta, delta, sigma, rho, nb;
+  p1d_spectrum spec;
+  int info;
+
+  *nbite = 0;
+  if ((info = spectrum_get(AB, lab, la, prec, &spec)) != 0){
+    free(r); free(d); free(Ad);
+    return info;
+  }
+  if (prec == KRYLOV_PREC_JACOBI){
+    dinv = (double *) malloc(sizeof(double)*n);
+    for (i=0;i<n;i++) dinv[i] = 1.0/SP_DIAG(AB, *lab, i);
+  }
+  theta = 0.5*(spec.lmax + spec.lmin);
+  delta = 0.5*(spec.lmax - spec.lmin);
+  nb = nrm2_repro(la, RHS);
+  if (nb == 0.0) nb = 1.0;
+  sp_matvec(AB, *lab, n, NULL, X, r);
+  for (i=0;i<n;i++){
+    r[i] = RHS[i] - r[i];
+    d[i] = ((dinv != NULL) ? dinv[i]*r[i] : r[i])/theta;
+  }
+  resvec[0] = nrm2_repro(la, r)/nb;
+  // Intervalle réduit à un point : Richardson au pas 1/theta
+  sigma = (delta > 0.0) ? theta/delta : INFINITY;
+  rho = 1.0/sigma;
+  while (*nbite < *maxit && resvec[*nbite] > *tol){
+    double rho1 = 1.0/(2.0*sigma - rho);
+    sp_matvec(AB, *lab, n, NULL, d, Ad);
+    for (i=0;i<n;i++){
+      X[i] += d[i];
+      r[i] -= Ad[i];
+    }
+    for (i=0;i<n;i++){
+      double z = (dinv != NULL) ? dinv[i]*r[i] : r[i];
+      d[i] = (delta > 0.0) ? rho1*rho*d[i] + 2.0*rho1/delta*z : z/theta;
+    }
+    rho = rho1;
+    (*nbite)++;
+    resvec[*nbite] = nrm2_repro(la, r)/nb;
+  }
+  free(r); free(d); free(Ad); free(dinv);
+  return 0;
+}
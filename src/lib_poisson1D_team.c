@@ -0,0 +1,326 @@
+/**********************************************/
+/* lib_poisson1D_team.c                       */
+/* Persistent pinned thread team: sense-      */
+/* reversing barrier, neighbour halo flags,   */
+/* lagged combined reduction; Jacobi and      */
+/* Richardson on the team                     */
+/**********************************************/
+#define _GNU_SOURCE
+#include "lib_poisson1D.h"
+#include <sched.h>
+
+#define TEAM_SPIN 2000
+
+/* Attente active courte puis cession du cœur : reste correct quand il y a
+   plus de threads que de cœurs */
+static void team_pause(int *count){
+  if (++(*count) < TEAM_SPIN){
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+  } else {
+    sched_yield();
+  }
+}
+
+typedef struct {
+  p1d_team *team;
+  int tid;
+} team_arg;
+
+static void *team_worker(void *p){
+  team_arg *a = (team_arg *) p;
+  p1d_team *team = a->team;
+  int tid = a->tid, seen = 0, cpu;
+
+  cpu = poisson1D_pin_cpu(team->policy, tid);
+  if (cpu >= 0){
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+  }
+  for (;;){
+    int spins = 0;
+    // Nouveau travail : attente active, puis sommeil sur la condition
+    while (__atomic_load_n(&team->gen, __ATOMIC_ACQUIRE) == seen && spins < 4*TEAM_SPIN){
+      team_pause(&spins);
+    }
+    if (__atomic_load_n(&team->gen, __ATOMIC_ACQUIRE) == seen){
+      pthread_mutex_lock(&team->lock);
+      while (__atomic_load_n(&team->gen, __ATOMIC_ACQUIRE) == seen){
+        pthread_cond_wait(&team->wake, &team->lock);
+      }
+      pthread_mutex_unlock(&team->lock);
+    }
+    seen = __atomic_load_n(&team->gen, __ATOMIC_ACQUIRE);
+    if (team->stop) break;
+    team->fn(team, tid, team->arg);
+    p1d_team_barrier(team, tid);
+  }
+  return NULL;
+}
+
+int p1d_team_create(p1d_team *team, int nthreads, int policy){
+  team_arg *args;
+  int t, cpu;
+
+  memset(team, 0, sizeof(p1d_team));
+  if (nthreads < 1) nthreads = 1;
+  team->nthreads = nthreads;
+  team->policy = policy;
+  team->slot = (p1d_team_slot *) aligned_alloc(sizeof(p1d_team_slot), sizeof(p1d_team_slot)*nthreads);
+  team->threads = (pthread_t *) malloc(sizeof(pthread_t)*nthreads);
+  args = (team_arg *) malloc(sizeof(team_arg)*nthreads);
+  team->args = args;
+  if (team->slot == NULL || team->threads == NULL || args == NULL){
+    printf("Erreur: allocation de l'équipe de %d threads\n", nthreads);
+    free(team->slot); free(team->threads); free(args);
+    return -1;
+  }
+  memset(team->slot, 0, sizeof(p1d_team_slot)*nthreads);
+  pthread_mutex_init(&team->lock, NULL);
+  pthread_cond_init(&team->wake, NULL);
+
+  // Le thread appelant est le membre 0
+  cpu = poisson1D_pin_cpu(policy, 0);
+  if (cpu >= 0){
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+  }
+  for (t=1;t<nthreads;t++){
+    args[t].team = team;
+    args[t].tid = t;
+    if (pthread_create(&team->threads[t], NULL, team_worker, &args[t]) != 0){
+      perror("pthread_create");
+      team->nthreads = t;
+      p1d_team_free(team);
+      return -1;
+    }
+  }
+  return 0;
+}
+
+static void team_dispatch(p1d_team *team){
+  pthread_mutex_lock(&team->lock);
+  __atomic_add_fetch(&team->gen, 1, __ATOMIC_RELEASE);
+  pthread_cond_broadcast(&team->wake);
+  pthread_mutex_unlock(&team->lock);
+}
+
+void p1d_team_free(p1d_team *team){
+  int t;
+  if (team->slot == NULL) return;
+  team->stop = 1;
+  team_dispatch(team);
+  for (t=1;t<team->nthreads;t++){
+    pthread_join(team->threads[t], NULL);
+  }
+  pthread_mutex_destroy(&team->lock);
+  pthread_cond_destroy(&team->wake);
+  free(team->slot);
+  free(team->threads);
+  free(team->args);
+  memset(team, 0, sizeof(p1d_team));
+}
+
+/* Les threads restent actifs entre deux appels : seul le lancement passe par
+   le verrou, pas les itérations */
+void p1d_team_run(p1d_team *team, p1d_team_fn fn, void *arg){
+  int t;
+  for (t=0;t<team->nthreads;t++){
+    team->slot[t].epoch = 0;
+  }
+  team->fn = fn;
+  team->arg = arg;
+  if (team->nthreads > 1) team_dispatch(team);
+  fn(team, 0, arg);
+  p1d_team_barrier(team, 0);
+}
+
+/* Barrière centralisée à inversion de sens : un compteur atomique, chaque
+   thread attend que le sens global prenne la valeur de son sens local */
+void p1d_team_barrier(p1d_team *team, int tid){
+  p1d_team_slot *s = &team->slot[tid];
+  int sense = !s->sense, spins = 0;
+  s->sense = sense;
+  if (__atomic_add_fetch(&team->bar_count, 1, __ATOMIC_ACQ_REL) == team->nthreads){
+    __atomic_store_n(&team->bar_count, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&team->bar_sense, sense, __ATOMIC_RELEASE);
+  } else {
+    while (__atomic_load_n(&team->bar_sense, __ATOMIC_ACQUIRE) != sense){
+      team_pause(&spins);
+    }
+  }
+}
+
+/* Réduction bloquante de nv valeurs en une barrière ; double tampon : le
+   tampon p n'est réécrit qu'après la barrière de l'appel suivant */
+void p1d_team_allreduce(p1d_team *team, int tid, double *v, int nv){
+  p1d_team_slot *s = &team->slot[tid];
+  int p = s->red_parity, t, k;
+  s->red_parity = !p;
+  for (k=0;k<nv;k++) s->red[p][k] = v[k];
+  p1d_team_barrier(team, tid);
+  for (k=0;k<nv;k++){
+    double sum = 0.0;
+    for (t=0;t<team->nthreads;t++) sum += team->slot[t].red[p][k];
+    v[k] = sum;
+  }
+}
+
+/* Drapeau de halo et somme partielle de l'étape epoch, publiés par une
+   seule écriture release */
+void p1d_team_publish(p1d_team *team, int tid, int epoch, double partial){
+  p1d_team_slot *s = &team->slot[tid];
+  s->ring[epoch % P1D_TEAM_RING] = partial;
+  __atomic_store_n(&s->epoch, epoch, __ATOMIC_RELEASE);
+}
+
+void p1d_team_wait(p1d_team *team, int tid, int epoch){
+  int spins = 0;
+  if (tid < 0 || tid >= team->nthreads) return;
+  while (__atomic_load_n(&team->slot[tid].epoch, __ATOMIC_ACQUIRE) < epoch){
+    team_pause(&spins);
+  }
+}
+
+/* Somme, dans l'ordre des threads, des partielles de l'étape epoch : même
+   résultat sur tous les threads, reproductible à nombre de threads fixé */
+double p1d_team_gather(p1d_team *team, int epoch){
+  double sum = 0.0;
+  int t;
+  for (t=0;t<team->nthreads;t++){
+    p1d_team_wait(team, t, epoch);
+    sum += team->slot[t].ring[epoch % P1D_TEAM_RING];
+  }
+  return sum;
+}
+
+#define SWEEP_JACOBI 0
+#define SWEEP_RICHARDSON 1
+
+typedef struct {
+  int kind;
+  double *AB;
+  int lab, la;
+  double *RHS;
+  double *buf[2];     /* itérés pairs (X) et impairs */
+  double alpha;
+  double scale;       /* 1/||RHS||^2 pour Richardson */
+  double tol;
+  int maxit;
+  double *resvec;
+  int nbite;
+} team_sweep;
+
+static double sweep_resid(team_sweep *w, int tid, int k, double s){
+  double r = sqrt(s*w->scale);
+  // Jacobi : ||x_k - x_{k-1}|| ; Richardson : ||b - A x_{k-1}|| / ||b||
+  if (tid == 0) w->resvec[(w->kind == SWEEP_JACOBI) ? k : k-1] = r;
+  return r;
+}
+
+/* Chaque thread garde sa tranche [lo, hi) pendant toute la résolution. À
+   l'étape k il attend seulement ses deux voisins (halo de x_{k-1} prêt, et
+   lecture de x_{k-2} terminée avant d'écraser ce tampon), publie sa
+   partielle, puis teste la convergence de l'étape k-1 : la réduction est
+   décalée d'une étape et ne bloque pas le balayage. Quatre partielles en
+   anneau suffisent car gather(k-1) impose à tous d'avoir publié k-1. */
+static void sweep_job(p1d_team *team, int tid, void *arg){
+  team_sweep *w = (team_sweep *) arg;
+  double *AB = w->AB, *RHS = w->RHS;
+  int lab = w->lab, n = w->la, lo, hi, k, i, fin = 0;
+
+  poisson1D_partition(&n, team->nthreads, tid, &lo, &hi);
+  for (k=1;k<=w->maxit;k++){
+    const double *src = w->buf[(k-1) & 1];
+    double *dst = w->buf[k & 1];
+    double s = 0.0, r;
+    if (k > 1){
+      p1d_team_wait(team, tid-1, k-1);
+      p1d_team_wait(team, tid+1, k-1);
+    }
+    if (w->kind == SWEEP_JACOBI){
+      for (i=lo;i<hi;i++){
+        double v = RHS[i], d;
+        if (i > 0) v -= AB[lab*(i-1) + 2]*src[i-1];
+        if (i < n-1) v -= AB[lab*(i+1) + 0]*src[i+1];
+        v /= AB[lab*i + 1];
+        d = v - src[i];
+        s += d*d;
+        dst[i] = v;
+      }
+    } else {
+      for (i=lo;i<hi;i++){
+        double v = RHS[i] - AB[lab*i + 1]*src[i];
+        if (i > 0) v -= AB[lab*(i-1) + 2]*src[i-1];
+        if (i < n-1) v -= AB[lab*(i+1) + 0]*src[i+1];
+        s += v*v;
+        dst[i] = src[i] + w->alpha*v;
+      }
+    }
+    p1d_team_publish(team, tid, k, s);
+    if (k > 1){
+      r = sweep_resid(w, tid, k-1, p1d_team_gather(team, k-1));
+      if (r <= w->tol){
+        fin = k-1;
+        break;
+      }
+    }
+    if (k == w->maxit){
+      sweep_resid(w, tid, k, p1d_team_gather(team, k));
+      fin = k;
+      break;
+    }
+  }
+  // Itéré final dans le tampon impair : recopie de sa propre tranche
+  if (fin & 1){
+    for (i=lo;i<hi;i++) w->buf[0][i] = w->buf[1][i];
+  }
+  if (tid == 0) w->nbite = fin;
+}
+
+static void team_sweep_solve(p1d_team *team, int kind, double *AB, double *RHS, double *X, double alpha,
+                             int *lab, int *la, double *tol, int *maxit, double *resvec, int *nbite){
+  team_sweep w;
+  w.kind = kind;
+  w.AB = AB;
+  w.lab = *lab;
+  w.la = *la;
+  w.RHS = RHS;
+  w.buf[0] = X;
+  // Premier accès au second tampon par les threads propriétaires
+  w.buf[1] = (double *) malloc(sizeof(double)*(*la));
+  w.alpha = alpha;
+  w.scale = 1.0;
+  if (kind == SWEEP_RICHARDSON){
+    double nb = dot_repro(la, RHS, RHS);
+    w.scale = (nb > 0.0) ? 1.0/nb : 1.0;
+  }
+  w.tol = *tol;
+  w.maxit = *maxit;
+  w.resvec = resvec;
+  w.nbite = 0;
+  p1d_team_run(team, sweep_job, &w);
+  *nbite = w.nbite;
+  free(w.buf[1]);
+}
+
+void jacobi_tridiag_team(p1d_team *team, double *AB, double *RHS, double *X, int *lab, int *la,
+                         double *tol, int *maxit, double *resvec, int *nbite){
+  resvec[0] = 1.0;
+  // Comme jacobi_tridiag : résidu initial conventionnel de 1
+  if (*tol >= 1.0){
+    *nbite = 0;
+    return;
+  }
+  team_sweep_solve(team, SWEEP_JACOBI, AB, RHS, X, 0.0, lab, la, tol, maxit, resvec, nbite);
+}
+
+void richardson_alpha_team(p1d_team *team, double *AB, double *RHS, double *X, double *alpha_rich,
+                           int *lab, int *la, double *tol, int *maxit, double *resvec, int *nbite){
+  team_sweep_solve(team, SWEEP_RICHARDSON, AB, RHS, X, *alpha_rich, lab, la, tol, maxit, resvec, nbite);
+}
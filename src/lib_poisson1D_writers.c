@@ -65,9 +65,21 @@ void write_GB2AIJ_operator_poisson1D(double* AB, int* la, char* filename){
   }
 }
 
+/* Sortie compressée <filename>.p1z si POISSON1D_COMPRESS est défini */
+static int write_vec_p1z(double* vec, int* la, double eb, char* filename){
+  char name[1024];
+  snprintf(name, sizeof(name), "%s.p1z", filename);
+  return p1z_write(vec, *la, eb, 0, name);
+}
+
 void write_vec(double* vec, int* la, char* filename){
   int jj;
   FILE * file;
+  double eb;
+  if (poisson1D_compress_eb(&eb)){
+    write_vec_p1z(vec, la, eb, filename);
+    return;
+  }
   file = fopen(filename, "w");
   // Numbering from 1 to la
   if (file != NULL){
@@ -81,6 +93,16 @@ void write_vec(double* vec, int* la, char* filename){
   } 
 }  
 
+/* Historiques de résidus : sans perte dès que la compression est active */
+void write_vec_history(double* vec, int* la, char* filename){
+  double eb;
+  if (poisson1D_compress_eb(&eb)){
+    write_vec_p1z(vec, la, 0.0, filename);
+    return;
+  }
+  write_vec(vec, la, filename);
+}
+
 void write_xy(double* vec, double* x, int* la, char* filename){
   int jj;
   FILE * file;
@@ -0,0 +1,109 @@
+/******************************************/
+/* tp_poisson1D_adapt.c                   */
+/* Boundary layer on uniform, stretched   */
+/* and adaptively refined grids           */
+/******************************************/
+#include "lib_poisson1D.h"
+#include <time.h>
+
+typedef struct {
+  double T0, T1, delta;
+} layer_ctx;
+
+/* u(x) = T0 + x(T1-T0) + e^{-x/d} - 1 + x(1 - e^{-1/d}) : couche limite en x=0 */
+static double exact(double x, layer_ctx *p){
+  double d = p->delta;
+  return p->T0 + x*(p->T1 - p->T0) + exp(-x/d) - 1.0 + x*(1.0 - exp(-1.0/d));
+}
+
+static double source(double x, void *ctx){
+  layer_ctx *p = (layer_ctx *) ctx;
+  return -exp(-x/p->delta)/(p->delta*p->delta);
+}
+
+static double max_error(double *x, double *u, int la, layer_ctx *p){
+  double e = 0.0, n = 0.0;
+  int jj;
+  for (jj=0;jj<la;jj++){
+    double ex = exact(x[jj], p);
+    e = fmax(e, fabs(u[jj] - ex));
+    n = fmax(n, fabs(ex));
+  }
+  return e/n;
+}
+
+static double solve_on_grid(double *x, int la, layer_ctx *p){
+  int lab = 4, kv = 1, ku = 1, kl = 1, NRHS = 1, info;
+  double *AB = (double *) malloc(sizeof(double)*lab*la);
+  double *U = (double *) malloc(sizeof(double)*la);
+  int *ipiv = (int *) malloc(sizeof(int)*la);
+  double err;
+  set_GB_operator_colMajor_poisson1D_nonuniform(AB, &lab, &la, x, &kv);
+  set_dense_RHS_nonuniform_1D(U, &la, x, source, p, &p->T0, &p->T1);
+  dgbsv_(&la, &kl, &ku, &NRHS, AB, &lab, ipiv, U, &la, &info);
+  err = (info == 0) ? max_error(x, U, la, p) : -1.0;
+  free(AB); free(U); free(ipiv);
+  return err;
+}
+
+int main(int argc,char *argv[])
+{
+  layer_ctx pb = {-5.0, 5.0, 1e-3};
+  double target = 1e-6, tol, beta = 4.0, err, hmin, hmax;
+  double *x, *u;
+  int la, k, nlevel, info;
+  clock_t start;
+
+  if (argc > 1) target = atof(argv[1]);
+  if (argc > 2) pb.delta = atof(argv[2]);
+  printf("--------- Poisson 1D : grilles non uniformes ---------\n\n");
+  printf("Couche limite d'épaisseur %g en x=0, erreur cible %g\n\n", pb.delta, target);
+
+  // Grilles uniformes : doublement jusqu'à la cible
+  for (k=4;k<=24;k++){
+    la = (1 << k) - 1;
+    x = (double *) malloc(sizeof(double)*la);
+    set_grid_points_1D(x, &la);
+    err = solve_on_grid(x, la, &pb);
+    free(x);
+    if (err >= 0.0 && err <= target) break;
+  }
+  printf("%-14s la = %9d  erreur = %e\n", "uniforme", la, err);
+
+  // Grille resserrée aux bords (tanh)
+  for (k=4;k<=24;k++){
+    la = (1 << k) - 1;
+    x = (double *) malloc(sizeof(double)*la);
+    set_grid_points_stretched_1D(x, &la, &beta);
+    err = solve_on_grid(x, la, &pb);
+    free(x);
+    if (err >= 0.0 && err <= target) break;
+  }
+  printf("%-14s la = %9d  erreur = %e  (beta = %g)\n", "étirée", la, err, beta);
+
+  // Raffinement adaptatif : la tolérance locale est resserrée jusqu'à la cible
+  for (tol=target;;tol/=4.0){
+    start = clock();
+    info = poisson1D_adaptive(source, &pb, &pb.T0, &pb.T1, &tol, 15, 1 << 24, 60, &x, &u, &la, &nlevel);
+    err = (info == 0) ? max_error(x, u, la, &pb) : -1.0;
+    if ((err >= 0.0 && err <= target) || tol < target*1e-4) break;
+    free(x);
+    free(u);
+  }
+  printf("%-14s la = %9d  erreur = %e  (%d niveaux, tol = %.2e, %.3f s)\n", "adaptative", la, err,
+         nlevel, tol, ((double) (clock() - start))/CLOCKS_PER_SEC);
+  hmin = x[0];
+  hmax = x[0];
+  for (k=1;k<=la;k++){
+    double h = ((k < la) ? x[k] : 1.0) - x[k-1];
+    hmin = fmin(hmin, h);
+    hmax = fmax(hmax, h);
+  }
+  printf("\nh min = %e, h max = %e\n", hmin, hmax);
+  write_xy(u, x, &la, "SOL_adapt.dat");
+  free(x);
+  free(u);
+
+  printf("\n\n--------- End -----------\n");
+  return 0;
+}
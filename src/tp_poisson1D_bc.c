@@ -0,0 +1,102 @@
+/******************************************/
+/* tp_poisson1D_bc.c                      */
+/* Dirichlet, Neumann, Robin and periodic */
+/* boundary conditions: error and order   */
+/* of convergence on manufactured         */
+/* solutions                              */
+/******************************************/
+#include "lib_poisson1D.h"
+
+#define NLEVEL 5
+
+typedef struct {
+  const char *name;
+  poisson1D_bc left, right;
+  double sigma;
+  double (*u)(double x);
+  double (*f)(double x, void *ctx);
+} bc_case;
+
+/* u = T0 + x (T1 - T0) avec T0 = 5, T1 = 20 : exact sur la grille */
+static double u_lin(double x){ return 5.0 + 15.0*x; }
+static double f_zero(double x, void *ctx){ (void) x; (void) ctx; return 0.0; }
+/* u(0) = 0, u'(1) = 0 */
+static double u_dn(double x){ return sin(0.5*M_PI*x); }
+static double f_dn(double x, void *ctx){ (void) ctx; return 0.25*M_PI*M_PI*sin(0.5*M_PI*x); }
+/* u + du/dn = 0 en x=0, 2e en x=1 */
+static double u_rr(double x){ return exp(x); }
+static double f_rr(double x, void *ctx){ (void) ctx; return -exp(x); }
+/* Neumann pur, moyenne nulle */
+static double u_nn(double x){ return cos(M_PI*x); }
+static double f_nn(double x, void *ctx){ (void) ctx; return M_PI*M_PI*cos(M_PI*x); }
+/* Périodique, -u'' + u = f */
+static double u_pp(double x){ return sin(2.0*M_PI*x) + cos(2.0*M_PI*x); }
+static double f_pp(double x, void *ctx){ (void) ctx; return (1.0 + 4.0*M_PI*M_PI)*u_pp(x); }
+/* Périodique singulier, moyenne nulle */
+static double u_p0(double x){ return sin(2.0*M_PI*x); }
+static double f_p0(double x, void *ctx){ (void) ctx; return 4.0*M_PI*M_PI*sin(2.0*M_PI*x); }
+
+int main(int argc,char *argv[])
+{
+  bc_case cases[6] = {
+    {"Dirichlet / Dirichlet", {BC_DIRICHLET, 1.0, 0.0, 5.0}, {BC_DIRICHLET, 1.0, 0.0, 20.0}, 0.0, u_lin, f_zero},
+    {"Dirichlet / Neumann", {BC_DIRICHLET, 1.0, 0.0, 0.0}, {BC_NEUMANN, 0.0, 1.0, 0.0}, 0.0, u_dn, f_dn},
+    {"Robin / Robin", {BC_ROBIN, 1.0, 1.0, 0.0}, {BC_ROBIN, 1.0, 1.0, 2.0*M_E}, 0.0, u_rr, f_rr},
+    {"Neumann / Neumann", {BC_NEUMANN, 0.0, 1.0, 0.0}, {BC_NEUMANN, 0.0, 1.0, 0.0}, 0.0, u_nn, f_nn},
+    {"Périodique, sigma = 1", {BC_PERIODIC, 0.0, 0.0, 0.0}, {BC_PERIODIC, 0.0, 0.0, 0.0}, 1.0, u_pp, f_pp},
+    {"Périodique, sigma = 0", {BC_PERIODIC, 0.0, 0.0, 0.0}, {BC_PERIODIC, 0.0, 0.0, 0.0}, 0.0, u_p0, f_p0},
+  };
+  int lab = 3, kv = 0, la0 = 25, ic, lev, jj, fail = 0;
+  double corner[2], mean;
+
+  if (argc == 2) {
+    la0 = atoi(argv[1]);
+  } else if (argc > 2) {
+    perror("Application takes at most one argument");
+    exit(1);
+  }
+  if (la0 < 3) la0 = 3;
+
+  printf("--------- Poisson 1D, conditions aux limites ---------\n");
+  for (ic=0;ic<6;ic++){
+    bc_case *c = &cases[ic];
+    double prev = 0.0;
+    printf("\n%s\n", c->name);
+    printf("      la |  erreur max  | ordre |  moyenne retirée\n");
+    for (lev=0;lev<NLEVEL;lev++){
+      int la = la0 << lev, info;
+      double err = 0.0, shift = 0.0;
+      double *AB = (double *) malloc(sizeof(double)*lab*la);
+      double *U = (double *) malloc(sizeof(double)*la);
+      double *X = (double *) malloc(sizeof(double)*la);
+
+      set_grid_points_bc_1D(X, &la, &c->left, &c->right);
+      set_GB_operator_colMajor_bc(AB, &lab, &la, &kv, &c->sigma, &c->left, &c->right, corner);
+      set_dense_RHS_bc_1D(U, &la, c->f, NULL, &c->left, &c->right);
+      info = poisson1D_bc_solve(AB, &lab, &la, &kv, corner, &c->left, &c->right, U, &mean);
+      if (info != 0){
+        printf("Erreur: résolution, info = %d\n", info);
+        fail = 1;
+      }
+      // Problème singulier : solution définie à une constante près
+      if (c->left.type == BC_PERIODIC || (c->left.type == BC_NEUMANN && c->right.type == BC_NEUMANN)){
+        if (c->sigma == 0.0){
+          for (jj=0;jj<la;jj++) shift += U[jj] - c->u(X[jj]);
+          shift /= la;
+        }
+      }
+      for (jj=0;jj<la;jj++){
+        err = fmax(err, fabs(U[jj] - shift - c->u(X[jj])));
+      }
+      if (lev == 0) printf("%8d | %12.4e |       | %e\n", la, err, mean);
+      else if (prev < 1e-10) printf("%8d | %12.4e |   -   | %e\n", la, err, mean);  // exact au bruit près
+      else printf("%8d | %12.4e | %5.2f | %e\n", la, err, log2(prev/err), mean);
+      prev = err;
+      free(AB);
+      free(U);
+      free(X);
+    }
+  }
+  printf("\n\n--------- End -----------\n");
+  return fail;
+}
@@ -0,0 +1,1085 @@
+/******************************************/
+/* tp_poisson1D_check.c                   */
+/* Differential correctness harness: each */
+/* fast kernel against dgbsv_ or          */
+/* cblas_dgbmv on random cases            */
+/******************************************/
+#include "lib_poisson1D.h"
+#include <omp.h>
+#include <unistd.h>
+
+#define EPS DBL_EPSILON
+#define CHECK_MAXN 3000
+
+/* Générateur xorshift64* : les cas sont reproductibles à partir de (graine, n) */
+static unsigned long long rng_state;
+static void rng_seed(unsigned long long s){
+  rng_state = s*0x9E3779B97F4A7C15ULL + 0x2545F4914F6CDD1DULL;
+  if (rng_state == 0) rng_state = 1;
+}
+static unsigned long long rng_next(void){
+  rng_state ^= rng_state >> 12;
+  rng_state ^= rng_state << 25;
+  rng_state ^= rng_state >> 27;
+  return rng_state * 2685821657736338717ULL;
+}
+static double rng_unif(double a, double b){
+  return a + (b - a)*((rng_next() >> 11)*(1.0/9007199254740992.0));
+}
+static int rng_int(int a, int b){
+  return a + (int) (rng_next() % (unsigned long long) (b - a + 1));
+}
+
+/* Cas de test : matrice tridiagonale à diagonale dominante, de facteur
+   d'échelle aléatoire, second membre et vecteur aléatoires */
+typedef struct {
+  int n;
+  int sym;            /* sub[i] = sup[i-1] */
+  int toeplitz;       /* coefficients constants */
+  double *sub;        /* A(i,i-1), i >= 1 */
+  double *diag;
+  double *sup;        /* A(i,i+1), i <= n-2 */
+  double *b;
+  double *x;
+  double T0, T1;
+} check_case;
+
+static void case_alloc(check_case *c, unsigned long long seed, int n, int sym, int toeplitz){
+  double scale, d0, o0;
+  int i;
+  rng_seed(seed ^ ((unsigned long long) n << 32));
+  c->n = n;
+  c->sym = sym;
+  c->toeplitz = toeplitz;
+  c->sub = (double *) calloc(n, sizeof(double));
+  c->diag = (double *) calloc(n, sizeof(double));
+  c->sup = (double *) calloc(n, sizeof(double));
+  c->b = (double *) malloc(sizeof(double)*n);
+  c->x = (double *) malloc(sizeof(double)*n);
+  scale = pow(10.0, rng_unif(-3.0, 3.0));
+  o0 = scale*rng_unif(-1.0, 1.0);
+  d0 = 2.0*fabs(o0) + scale*rng_unif(0.1, 1.0);
+  for (i=0;i<n;i++){
+    if (toeplitz){
+      c->diag[i] = d0;
+      if (i > 0) c->sub[i] = o0;
+      if (i < n-1) c->sup[i] = o0;
+    } else {
+      if (i > 0) c->sub[i] = sym ? c->sup[i-1] : scale*rng_unif(-1.0, 1.0);
+      if (i < n-1) c->sup[i] = scale*rng_unif(-1.0, 1.0);
+    }
+  }
+  if (!toeplitz){
+    for (i=0;i<n;i++){
+      double off = fabs(c->sub[i]) + fabs(c->sup[i]);
+      // Dominance stricte sur les lignes et les colonnes
+      if (i > 0) off = fmax(off, fabs(c->sup[i-1]) + ((i < n-1) ? fabs(c->sub[i+1]) : 0.0));
+      c->diag[i] = (rng_next() & 1 ? 1.0 : -1.0)*(off + scale*rng_unif(0.1, 2.0));
+      if (sym) c->diag[i] = fabs(c->diag[i]);
+    }
+  }
+  for (i=0;i<n;i++){
+    c->b[i] = rng_unif(-1.0, 1.0);
+    c->x[i] = rng_unif(-1.0, 1.0);
+  }
+  c->T0 = rng_unif(-10.0, 10.0);
+  c->T1 = rng_unif(-10.0, 10.0);
+}
+
+static void case_free(check_case *c){
+  free(c->sub); free(c->diag); free(c->sup); free(c->b); free(c->x);
+}
+
+/* Stockage GB colonne : lab = kv + 3, A(i,j) = AB[j*lab + kv+1+i-j] */
+static double *case_AB(check_case *c, int kv){
+  int lab = kv + 3, j;
+  double *AB = (double *) calloc((size_t) lab*c->n, sizeof(double));
+  for (j=0;j<c->n;j++){
+    if (j > 0) AB[j*lab + kv] = c->sup[j-1];
+    AB[j*lab + kv+1] = c->diag[j];
+    if (j < c->n-1) AB[j*lab + kv+2] = c->sub[j+1];
+  }
+  return AB;
+}
+
+/* Référence : y = A x par cblas_dgbmv */
+static void ref_matvec(check_case *c, double *x, double *y){
+  double *AB = case_AB(c, 0);
+  cblas_dgbmv(CblasColMajor, CblasNoTrans, c->n, c->n, 1, 1, 1.0, AB, 3, x, 1, 0.0, y, 1);
+  free(AB);
+}
+
+/* Référence : x = A^-1 b par dgbsv_ */
+static int ref_solve(check_case *c, double *b, double *x){
+  int n = c->n, kl = 1, ku = 1, lab = 4, nrhs = 1, info;
+  double *AB = case_AB(c, 1);
+  int *ipiv = (int *) malloc(sizeof(int)*n);
+  memcpy(x, b, sizeof(double)*n);
+  dgbsv_(&n, &kl, &ku, &nrhs, AB, &lab, ipiv, x, &n, &info);
+  free(AB);
+  free(ipiv);
+  return info;
+}
+
+/* Erreur inverse normwise ||b - Ax||inf / (||A||inf ||x||inf + ||b||inf) */
+static double backward_error(check_case *c, double *b, double *x){
+  double *r = (double *) malloc(sizeof(double)*c->n);
+  double nr = 0.0, na = 0.0, nx = 0.0, nb = 0.0, den;
+  int i;
+  ref_matvec(c, x, r);
+  for (i=0;i<c->n;i++){
+    nr = fmax(nr, fabs(b[i] - r[i]));
+    na = fmax(na, fabs(c->sub[i]) + fabs(c->diag[i]) + fabs(c->sup[i]));
+    nx = fmax(nx, fabs(x[i]));
+    nb = fmax(nb, fabs(b[i]));
+  }
+  free(r);
+  den = na*nx + nb;
+  return (den > 0.0) ? nr/den : nr;
+}
+
+/* Écart composante par composante d'un produit matrice-vecteur, rapporté à
+   la borne gamma_3 |A||x| (3 termes par ligne) */
+static double matvec_ratio(check_case *c, double *x, double *y){
+  double *yr = (double *) malloc(sizeof(double)*c->n);
+  double worst = 0.0;
+  int i;
+  ref_matvec(c, x, yr);
+  for (i=0;i<c->n;i++){
+    double ax = fabs(c->diag[i]*x[i]);
+    if (i > 0) ax += fabs(c->sub[i]*x[i-1]);
+    if (i < c->n-1) ax += fabs(c->sup[i]*x[i+1]);
+    // gamma_3 pour chacun des deux calculs, plus une marge de 2
+    double bound = 2.0*2.0*(3.0*EPS/(1.0 - 3.0*EPS))*ax;
+    double d = fabs(y[i] - yr[i]);
+    if (d > 0.0) worst = fmax(worst, (bound > 0.0) ? d/bound : INFINITY);
+  }
+  free(yr);
+  return worst;
+}
+
+/* Écart relatif entre deux itérés de solveurs équivalents */
+static double rel_diff(int n, double *x, double *y){
+  double d = 0.0, m = 0.0;
+  int i;
+  for (i=0;i<n;i++){
+    d = fmax(d, fabs(x[i] - y[i]));
+    m = fmax(m, fabs(y[i]));
+  }
+  return (m > 0.0) ? d/m : d;
+}
+
+/* Chaque noyau renvoie le rapport erreur/tolérance : > 1 est un échec */
+typedef double (*check_fn)(unsigned long long seed, int n, int nthreads);
+
+static double chk_dgbmv_poisson1D(unsigned long long seed, int n, int nthreads){
+  check_case c;
+  int lab = 3, kl = 1, ku = 1, kv = 0;
+  double *AB, *y, r;
+  case_alloc(&c, seed, n, 0, 0);
+  AB = case_AB(&c, 0);
+  y = (double *) malloc(sizeof(double)*n);
+  omp_set_num_threads(nthreads);
+  dgbmv_poisson1D(AB, c.x, y, &n, &lab, &ku, &kl, &kv);
+  r = matvec_ratio(&c, c.x, y);
+  free(AB); free(y);
+  case_free(&c);
+  return r;
+}
+
+static double chk_spmv(unsigned long long seed, int n, int nthreads, int sell){
+  check_case c;
+  csr_matrix A;
+  sell_matrix S;
+  int lab = 3, kl = 1, ku = 1, kv = 0, C, sigma;
+  double *AB, *y, *y1, r;
+  case_alloc(&c, seed, n, 0, 0);
+  AB = case_AB(&c, 0);
+  y = (double *) malloc(sizeof(double)*n);
+  y1 = (double *) malloc(sizeof(double)*n);
+  GB2CSR_operator_colMajor(AB, &lab, &n, &ku, &kl, &kv, &A);
+  C = 1 << rng_int(0, 4);
+  sigma = C*rng_int(1, 8);
+  if (sell) CSR2SELL(&A, C, sigma, &S);
+  omp_set_num_threads(nthreads);
+  if (sell) sell_spmv(&S, c.x, y); else csr_spmv(&A, c.x, y);
+  r = matvec_ratio(&c, c.x, y);
+  // Même résultat au bit près avec un seul thread
+  omp_set_num_threads(1);
+  if (sell) sell_spmv(&S, c.x, y1); else csr_spmv(&A, c.x, y1);
+  if (memcmp(y, y1, sizeof(double)*n) != 0) r = fmax(r, 2.0);
+  if (sell) sell_free(&S);
+  csr_free(&A);
+  free(AB); free(y); free(y1);
+  case_free(&c);
+  return r;
+}
+static double chk_csr_spmv(unsigned long long seed, int n, int nthreads){ return chk_spmv(seed, n, nthreads, 0); }
+static double chk_sell_spmv(unsigned long long seed, int n, int nthreads){ return chk_spmv(seed, n, nthreads, 1); }
+
+/* Réductions : borne gamma_n sum |x_i y_i| par rapport à cblas_ddot,
+   et reproductibilité bit à bit quel que soit le nombre de threads */
+static double chk_dot_repro(unsigned long long seed, int n, int nthreads){
+  check_case c;
+  double d, d1, ref, abs_sum = 0.0, bound, r, nd, nd1;
+  int i;
+  case_alloc(&c, seed, n, 0, 0);
+  for (i=0;i<n;i++) abs_sum += fabs(c.x[i]*c.b[i]);
+  ref = cblas_ddot(n, c.x, 1, c.b, 1);
+  omp_set_num_threads(nthreads);
+  d = dot_repro(&n, c.x, c.b);
+  nd = nrm2_diff_repro(&n, c.x, c.b);
+  omp_set_num_threads(1);
+  d1 = dot_repro(&n, c.x, c.b);
+  nd1 = nrm2_diff_repro(&n, c.x, c.b);
+  bound = 2.0*(n*EPS/(1.0 - n*EPS))*abs_sum;
+  r = (fabs(d - ref) > 0.0) ? fabs(d - ref)/bound : 0.0;
+  if (d != d1 || nd != nd1) r = fmax(r, 2.0);
+  case_free(&c);
+  return r;
+}
+
+static double chk_nrm2_repro(unsigned long long seed, int n, int nthreads){
+  check_case c;
+  double v, ref, r, *z;
+  int k;
+  case_alloc(&c, seed, n, 0, 0);
+  ref = cblas_dnrm2(n, c.x, 1);
+  omp_set_num_threads(nthreads);
+  v = nrm2_repro(&n, c.x);
+  r = (ref > 0.0) ? fabs(v - ref)/(2.0*(n + 2)*EPS*ref) : fabs(v);
+  // Hors de portée de sqrt(sum x^2) (carrés > DBL_MAX ou sous-normaux) : la
+  // mise à l'échelle par puissances de 2 doit rendre exactement v 2^k
+  z = (double *) calloc(n, sizeof(double));
+  for (k=-700;k<=700;k+=1400){
+    int i;
+    for (i=0;i<n;i++) c.b[i] = ldexp(c.x[i], k);
+    if (nrm2_repro(&n, c.b) != ldexp(v, k)) r = INFINITY;
+    if (nrm2_diff_repro(&n, z, c.b) != ldexp(v, k)) r = INFINITY;
+  }
+  free(z);
+  case_free(&c);
+  return r;
+}
+
+/* Solveurs directs : erreur inverse de la solution, comparée à une
+   tolérance fixe et à celle de la référence dgbsv_ */
+#define BERR_TOL (16.0*EPS)
+static double solve_ratio(check_case *c, double *x, double tol){
+  double *xr = (double *) malloc(sizeof(double)*c->n);
+  double be = backward_error(c, c->b, x), ber;
+  ref_solve(c, c->b, xr);
+  ber = backward_error(c, c->b, xr);
+  free(xr);
+  return be/fmax(tol, 4.0*ber);
+}
+
+static double chk_dgbtrftridiag(unsigned long long seed, int n, int nthreads){
+  check_case c;
+  int kl = 1, ku = 1, lab = 4, nrhs = 1, info;
+  double *AB, *x, r;
+  int *ipiv;
+  case_alloc(&c, seed, n, 0, 0);
+  AB = case_AB(&c, 1);
+  x = (double *) malloc(sizeof(double)*n);
+  ipiv = (int *) malloc(sizeof(int)*n);
+  memcpy(x, c.b, sizeof(double)*n);
+  omp_set_num_threads(nthreads);
+  dgbtrftridiag(&n, &n, &kl, &ku, AB, &lab, ipiv, &info);
+  if (info == 0) dgbtrs_("N", &n, &kl, &ku, &nrhs, AB, &lab, ipiv, x, &n, &info);
+  r = (info != 0) ? INFINITY : solve_ratio(&c, x, BERR_TOL);
+  free(AB); free(x); free(ipiv);
+  case_free(&c);
+  return r;
+}
+
+/* DST : un second membre (toute l'équipe dans chaque transformée) et deux
+   seconds membres (un par thread) doivent donner les mêmes bits */
+static double chk_dst_solve(unsigned long long seed, int n, int nthreads){
+  check_case c;
+  dst_plan plan;
+  int nrhs = 1, nrhs2 = 2;
+  double *x, *x2, r, d, o;
+  case_alloc(&c, seed, n, 1, 1);
+  x = (double *) malloc(sizeof(double)*n);
+  x2 = (double *) malloc(sizeof(double)*2*n);
+  memcpy(x, c.b, sizeof(double)*n);
+  memcpy(x2, c.b, sizeof(double)*n);
+  memcpy(x2 + n, c.b, sizeof(double)*n);
+  d = c.diag[0];
+  o = (n > 1) ? c.sup[0] : 0.0;
+  omp_set_num_threads(nthreads);
+  dst_plan_create(&plan, &n);
+  poisson1D_dst_solve(&plan, x, &nrhs, &n, &d, &o);
+  poisson1D_dst_solve(&plan, x2, &nrhs2, &n, &d, &o);
+  dst_plan_free(&plan);
+  // Transformées en O(log n) opérations par coefficient
+  r = solve_ratio(&c, x, BERR_TOL*(1.0 + log2(n + 1.0)));
+  if (memcmp(x, x2, sizeof(double)*n) != 0 || memcmp(x, x2 + n, sizeof(double)*n) != 0) r = INFINITY;
+  free(x); free(x2);
+  case_free(&c);
+  return r;
+}
+
+static double chk_ooc_tridiag_solve(unsigned long long seed, int n, int nthreads){
+  check_case c;
+  ooc_vec DL, D, DU, RHS, SOL, SPILL;
+  char names[6][256];
+  double *x, r = INFINITY;
+  long long info;
+  int k;
+  (void) nthreads;
+  case_alloc(&c, seed, n, 0, 0);
+  for (k=0;k<6;k++){
+    snprintf(names[k], sizeof(names[k]), "%s/poisson1D_check_%d_%d.bin",
+             getenv("TMPDIR") ? getenv("TMPDIR") : "/tmp", (int) getpid(), k);
+  }
+  x = (double *) malloc(sizeof(double)*n);
+  if (ooc_vec_create(&DL, names[0], n) == 0 && ooc_vec_create(&D, names[1], n) == 0
+      && ooc_vec_create(&DU, names[2], n) == 0 && ooc_vec_create(&RHS, names[3], n) == 0
+      && ooc_vec_create(&SOL, names[4], n) == 0 && ooc_vec_create(&SPILL, names[5], 2LL*n) == 0){
+    memcpy(DL.map, c.sub, sizeof(double)*n);
+    memcpy(D.map, c.diag, sizeof(double)*n);
+    memcpy(DU.map, c.sup, sizeof(double)*n);
+    memcpy(RHS.map, c.b, sizeof(double)*n);
+    info = ooc_tridiag_solve(&DL, &D, &DU, &RHS, &SOL, &SPILL, 1024);
+    memcpy(x, SOL.map, sizeof(double)*n);
+    ooc_vec_close(&DL); ooc_vec_close(&D); ooc_vec_close(&DU);
+    ooc_vec_close(&RHS); ooc_vec_close(&SOL); ooc_vec_close(&SPILL);
+    if (info == 0) r = solve_ratio(&c, x, BERR_TOL);
+  }
+  for (k=0;k<6;k++) unlink(names[k]);
+  free(x);
+  case_free(&c);
+  return r;
+}
+
+static double chk_bc_cache_solve(unsigned long long seed, int n, int nthreads){
+  check_case c;
+  bc_cache cache;
+  double *x, r;
+  int i;
+  case_alloc(&c, seed, n, 1, 1);
+  // Opérateur [-1 2 -1] et second membre de Dirichlet
+  for (i=0;i<n;i++){
+    c.diag[i] = 2.0;
+    c.sub[i] = (i > 0) ? -1.0 : 0.0;
+    c.sup[i] = (i < n-1) ? -1.0 : 0.0;
+  }
+  set_dense_RHS_DBC_1D(c.b, &n, &c.T0, &c.T1);
+  x = (double *) malloc(sizeof(double)*n);
+  omp_set_num_threads(nthreads);
+  bc_cache_init(&cache, 0);
+  r = (bc_cache_solve(&cache, &n, &c.T0, &c.T1, x) != 0) ? INFINITY : solve_ratio(&c, x, BERR_TOL);
+  bc_cache_free(&cache);
+  free(x);
+  case_free(&c);
+  return r;
+}
+
+static double chk_set_GB_par(unsigned long long seed, int n, int nthreads){
+  double *A1, *A2;
+  int lab, kv, r = 0;
+  (void) seed;
+  omp_set_num_threads(nthreads);
+  for (kv=0;kv<=1;kv++){
+    lab = kv + 3;
+    A1 = (double *) malloc(sizeof(double)*lab*n);
+    A2 = (double *) malloc(sizeof(double)*lab*n);
+    set_GB_operator_colMajor_poisson1D_quiet(A1, &lab, &n, &kv);
+    set_GB_operator_colMajor_poisson1D_par(A2, &lab, &n, &kv);
+    if (memcmp(A1, A2, sizeof(double)*lab*n) != 0) r = 1;
+    free(A1);
+    free(A2);
+  }
+  return r ? 2.0 : 0.0;
+}
+
+/* Itératifs : stockage bande et CSR doivent produire les mêmes itérés */
+static double chk_iter_csr(unsigned long long seed, int n, int nthreads, int gs){
+  check_case c;
+  csr_matrix A;
+  int lab = 3, kl = 1, ku = 1, kv = 0, maxit = 20, nb1, nb2;
+  double tol = 0.0, *AB, *x1, *x2, *rv1, *rv2, r;
+  case_alloc(&c, seed, n, 0, 0);
+  AB = case_AB(&c, 0);
+  x1 = (double *) calloc(n, sizeof(double));
+  x2 = (double *) calloc(n, sizeof(double));
+  rv1 = (double *) calloc(maxit+1, sizeof(double));
+  rv2 = (double *) calloc(maxit+1, sizeof(double));
+  GB2CSR_operator_colMajor(AB, &lab, &n, &ku, &kl, &kv, &A);
+  omp_set_num_threads(nthreads);
+  if (gs){
+    gauss_seidel_tridiag(AB, c.b, x1, &lab, &n, &ku, &kl, &tol, &maxit, rv1, &nb1);
+    gauss_seidel_csr(&A, c.b, x2, &tol, &maxit, rv2, &nb2);
+  } else {
+    jacobi_tridiag(AB, c.b, x1, &lab, &n, &ku, &kl, &tol, &maxit, rv1, &nb1);
+    jacobi_csr(&A, c.b, x2, &tol, &maxit, rv2, &nb2);
+  }
+  r = (nb1 != nb2) ? INFINITY : rel_diff(n, x1, x2)/(64.0*maxit*EPS);
+  csr_free(&A);
+  free(AB); free(x1); free(x2); free(rv1); free(rv2);
+  case_free(&c);
+  return r;
+}
+static double chk_jacobi(unsigned long long seed, int n, int nthreads){ return chk_iter_csr(seed, n, nthreads, 0); }
+static double chk_gauss_seidel(unsigned long long seed, int n, int nthreads){ return chk_iter_csr(seed, n, nthreads, 1); }
+
+/* Krylov : résidu vrai sous la tolérance demandée, et itérés identiques
+   bit à bit avec un seul thread (réductions par blocs fixes) */
+static double chk_krylov(unsigned long long seed, int n, int nthreads, int bicg){
+  check_case c;
+  krylov_ws ws;
+  int lab = 3, kv = 0, m = 4 + (int) (seed % 37), maxit = 4*n + 100, nb1, nb2, i;
+  int prec = (int) ((seed >> 8) % 3);
+  double tol = 1e-10, *AB, *x1, *x2, *rv, *r, nr = 0.0, nbn = 0.0, res;
+  case_alloc(&c, seed, n, 0, 0);
+  // Sans préconditionneur, une diagonale de signe aléatoire rend A indéfinie
+  // et GMRES(m) redémarré peut stagner ; diagonale positive et dominance
+  // lignes + colonnes : A + A^T définie positive, convergence pour tout m
+  if (prec == KRYLOV_PREC_NONE){
+    for (i=0;i<n;i++) c.diag[i] = fabs(c.diag[i]);
+  }
+  AB = case_AB(&c, 0);
+  x1 = (double *) calloc(n, sizeof(double));
+  x2 = (double *) calloc(n, sizeof(double));
+  r = (double *) malloc(sizeof(double)*n);
+  rv = (double *) calloc(maxit+1, sizeof(double));
+  if (krylov_ws_init(&ws, AB, &lab, &n, &kv, &m, prec) != 0){
+    free(AB); free(x1); free(x2); free(r); free(rv);
+    case_free(&c);
+    return INFINITY;
+  }
+  omp_set_num_threads(nthreads);
+  if (bicg) bicgstab_tridiag(&ws, c.b, x1, &tol, &maxit, rv, &nb1);
+  else gmres_tridiag(&ws, c.b, x1, &tol, &maxit, rv, &nb1);
+  omp_set_num_threads(1);
+  if (bicg) bicgstab_tridiag(&ws, c.b, x2, &tol, &maxit, rv, &nb2);
+  else gmres_tridiag(&ws, c.b, x2, &tol, &maxit, rv, &nb2);
+  ref_matvec(&c, x1, r);
+  for (i=0;i<n;i++){
+    nr += (c.b[i] - r[i])*(c.b[i] - r[i]);
+    nbn += c.b[i]*c.b[i];
+  }
+  // Marge de 10 : le critère d'arrêt de BiCGStab porte sur le résidu récursif
+  res = sqrt(nr/nbn)/(10.0*tol);
+  if (nb1 != nb2 || memcmp(x1, x2, sizeof(double)*n) != 0) res = INFINITY;
+  krylov_ws_free(&ws);
+  free(AB); free(x1); free(x2); free(r); free(rv);
+  case_free(&c);
+  return res;
+}
+static double chk_gmres(unsigned long long seed, int n, int nthreads){ return chk_krylov(seed, n, nthreads, 0); }
+static double chk_bicgstab(unsigned long long seed, int n, int nthreads){ return chk_krylov(seed, n, nthreads, 1); }
+
+/* y = A x pour une tridiagonale à coins A(0,n-1) = c0, A(n-1,0) = c1 */
+static void cyclic_matvec(double *AB, int lab, int kv, int n, double c0, double c1, double *x, double *y){
+  int i;
+  for (i=0;i<n;i++){
+    y[i] = AB[i*lab + kv+1]*x[i];
+    if (i > 0) y[i] += AB[(i-1)*lab + kv+2]*x[i-1];
+    if (i < n-1) y[i] += AB[(i+1)*lab + kv]*x[i+1];
+  }
+  y[0] += c0*x[n-1];
+  y[n-1] += c1*x[0];
+}
+
+static double cyclic_berr(double *AB, int lab, int kv, int n, double *corner, double *b, double *x){
+  double *r = (double *) malloc(sizeof(double)*n);
+  double nr = 0.0, na = 0.0, nx = 0.0, nb = 0.0, den;
+  int i;
+  cyclic_matvec(AB, lab, kv, n, corner[0], corner[1], x, r);
+  for (i=0;i<n;i++){
+    double a = fabs(AB[i*lab + kv+1]);
+    if (i > 0) a += fabs(AB[(i-1)*lab + kv+2]);
+    if (i < n-1) a += fabs(AB[(i+1)*lab + kv]);
+    if (i == 0) a += fabs(corner[0]);
+    if (i == n-1) a += fabs(corner[1]);
+    nr = fmax(nr, fabs(b[i] - r[i]));
+    na = fmax(na, a);
+    nx = fmax(nx, fabs(x[i]));
+    nb = fmax(nb, fabs(b[i]));
+  }
+  free(r);
+  den = na*nx + nb;
+  return (den > 0.0) ? nr/den : nr;
+}
+
+/* Sherman-Morrison : coins aléatoires, dominance diagonale conservée */
+static double chk_cyclic(unsigned long long seed, int n, int nthreads){
+  check_case c;
+  int lab = 3, kv = 0, info;
+  double corner[2], *AB, *x, r;
+  (void) nthreads;
+  if (n < 3) n = 3;
+  case_alloc(&c, seed, n, 0, 0);
+  corner[0] = rng_unif(-1.0, 1.0)*fabs(c.diag[0]);
+  corner[1] = rng_unif(-1.0, 1.0)*fabs(c.diag[n-1]);
+  c.diag[0] += copysign(fabs(corner[0]), c.diag[0]);
+  c.diag[n-1] += copysign(fabs(corner[1]), c.diag[n-1]);
+  AB = case_AB(&c, 0);
+  x = (double *) malloc(sizeof(double)*n);
+  memcpy(x, c.b, sizeof(double)*n);
+  info = cyclic_tridiag_solve(AB, &lab, &n, &kv, corner, x);
+  r = (info != 0) ? INFINITY : cyclic_berr(AB, lab, kv, n, corner, c.b, x)/(4.0*BERR_TOL);
+  free(AB); free(x);
+  case_free(&c);
+  return r;
+}
+
+/* Conditions aux limites aléatoires ; cas singuliers : résidu par rapport au
+   second membre projeté et moyenne pondérée nulle */
+static double chk_bc_solve(unsigned long long seed, int n, int nthreads){
+  poisson1D_bc bc[2];
+  int lab = 3, kv = 0, info, i, k, singular;
+  double corner[2], sigma, mean, *AB, *b, *x, sw = 0.0, sb = 0.0, sx = 0.0, nx = 0.0, r, g;
+  (void) nthreads;
+  if (n < 3) n = 3;
+  rng_seed(seed ^ ((unsigned long long) n << 32));
+  bc[0].type = rng_int(0, 3);
+  bc[1].type = (bc[0].type == BC_PERIODIC) ? BC_PERIODIC : rng_int(0, 2);
+  for (k=0;k<2;k++){
+    bc[k].alpha = (bc[k].type == BC_NEUMANN) ? 0.0 : rng_unif(0.1, 10.0);
+    bc[k].beta = (bc[k].type == BC_DIRICHLET) ? 0.0 : rng_unif(0.5, 2.0);
+    bc[k].g = rng_unif(-10.0, 10.0);
+  }
+  sigma = (rng_next() & 1) ? 0.0 : rng_unif(0.1, 100.0);
+  singular = (sigma == 0.0) && ((bc[0].type == BC_PERIODIC)
+             || (bc[0].type == BC_NEUMANN && bc[1].type == BC_NEUMANN));
+  AB = (double *) malloc(sizeof(double)*lab*n);
+  b = (double *) malloc(sizeof(double)*n);
+  x = (double *) malloc(sizeof(double)*n);
+  for (i=0;i<n;i++) b[i] = rng_unif(-1.0, 1.0);
+  memcpy(x, b, sizeof(double)*n);
+  set_GB_operator_colMajor_bc(AB, &lab, &n, &kv, &sigma, &bc[0], &bc[1], corner);
+  info = poisson1D_bc_solve(AB, &lab, &n, &kv, corner, &bc[0], &bc[1], x, &mean);
+  if (info != 0){
+    free(AB); free(b); free(x);
+    return INFINITY;
+  }
+  if (singular){
+    for (i=0;i<n;i++){
+      double w = ((i == 0 && bc[0].type == BC_NEUMANN) || (i == n-1 && bc[1].type == BC_NEUMANN)) ? 0.5 : 1.0;
+      sw += w;
+      sb += b[i];
+    }
+    g = sb/sw;
+    for (i=0;i<n;i++){
+      double w = ((i == 0 && bc[0].type == BC_NEUMANN) || (i == n-1 && bc[1].type == BC_NEUMANN)) ? 0.5 : 1.0;
+      b[i] -= g*w;
+      sx += w*x[i];
+      nx = fmax(nx, fabs(x[i]));
+    }
+  }
+  r = cyclic_berr(AB, lab, kv, n, corner, b, x)/(4.0*BERR_TOL);
+  // Jauge : somme pondérée de n termes
+  if (singular && nx > 0.0) r = fmax(r, fabs(sx)/(sw*nx)/(4.0*n*EPS));
+  free(AB); free(b); free(x);
+  return r;
+}
+
+/* Équipe persistante contre les versions séquentielles : mêmes nbite et
+   itérés ; tol tombe entre deux résidus de référence pour tester l'arrêt
+   anticipé (réduction décalée) */
+static double chk_team(unsigned long long seed, int n, int nthreads, int rich){
+  check_case c;
+  p1d_team team;
+  int lab = 3, kl = 1, ku = 1, maxit = 20, nb1, nb2, i, k, stop;
+  double tol = 0.0, alpha, *AB, *x1, *x2, *rv1, *rv2, *r, nrm = 0.0, res;
+  case_alloc(&c, seed, n, 0, 0);
+  AB = case_AB(&c, 0);
+  x1 = (double *) calloc(n, sizeof(double));
+  x2 = (double *) calloc(n, sizeof(double));
+  r = (double *) malloc(sizeof(double)*n);
+  rv1 = (double *) calloc(maxit+1, sizeof(double));
+  rv2 = (double *) calloc(maxit+1, sizeof(double));
+  // Richardson : alpha < 1/||A||inf, convergent pour une matrice à dominance
+  // diagonale de diagonale positive
+  for (i=0;i<n;i++){
+    c.diag[i] = fabs(c.diag[i]);
+    AB[i*lab + 1] = c.diag[i];
+    nrm = fmax(nrm, fabs(c.sub[i]) + c.diag[i] + fabs(c.sup[i]));
+  }
+  alpha = 1.0/nrm;
+  stop = 1 + (int) (seed % maxit);
+  for (k=0;k<2;k++){
+    memset(x1, 0, sizeof(double)*n);
+    if (rich){
+      double nb2r = dot_repro(&n, c.b, c.b);
+      for (nb1=0;nb1<maxit;){
+        double s = 0.0;
+        ref_matvec(&c, x1, r);
+        for (i=0;i<n;i++){
+          r[i] = c.b[i] - r[i];
+          s += r[i]*r[i];
+        }
+        for (i=0;i<n;i++) x1[i] += alpha*r[i];
+        rv1[nb1++] = sqrt(s/nb2r);
+        if (rv1[nb1-1] <= tol) break;
+      }
+    } else {
+      jacobi_tridiag(AB, c.b, x1, &lab, &n, &ku, &kl, &tol, &maxit, rv1, &nb1);
+    }
+    // Second passage : arrêt entre les résidus stop-1 et stop de la référence
+    if (k == 0){
+      int j = rich ? stop-1 : stop;
+      double a = rv1[j], b = (j > (rich ? 0 : 1)) ? rv1[j-1] : 2.0*rv1[j];
+      if (!(a > 0.0 && b > a*(1.0 + 1e-6))) break;
+      tol = sqrt(a*b);
+    }
+  }
+  p1d_team_create(&team, nthreads, POISSON1D_PIN_NONE);
+  if (rich) richardson_alpha_team(&team, AB, c.b, x2, &alpha, &lab, &n, &tol, &maxit, rv2, &nb2);
+  else jacobi_tridiag_team(&team, AB, c.b, x2, &lab, &n, &tol, &maxit, rv2, &nb2);
+  p1d_team_free(&team);
+  res = (nb1 != nb2) ? INFINITY : rel_diff(n, x2, x1)/(64.0*maxit*EPS);
+  free(AB); free(x1); free(x2); free(r); free(rv1); free(rv2);
+  case_free(&c);
+  return res;
+}
+static double chk_jacobi_team(unsigned long long seed, int n, int nthreads){ return chk_team(seed, n, nthreads, 0); }
+static double chk_richardson_team(unsigned long long seed, int n, int nthreads){ return chk_team(seed, n, nthreads, 1); }
+
+/* Parareal à tol = 0 et nslices itérations : chaque état de tranche doit être
+   celui du pas à pas séquentiel, bit à bit, quel que soit le nombre de threads */
+static double chk_parareal(unsigned long long seed, int n, int nthreads){
+  heat_ie_plan fine, coarse;
+  int N, nfine, ncoarse, nbite, i, k;
+  double T0, T1, dtf, dtc, tol = 0.0, *U, *V, *resvec, r = 0.0;
+  rng_seed(seed ^ ((unsigned long long) n << 32));
+  N = rng_int(1, 8);
+  nfine = rng_int(1, 6);
+  ncoarse = rng_int(1, 2);
+  T0 = rng_unif(-10.0, 10.0);
+  T1 = rng_unif(-10.0, 10.0);
+  dtf = pow(10.0, rng_unif(-7.0, -2.0));
+  dtc = dtf*nfine/ncoarse;
+  U = (double *) malloc(sizeof(double)*(N+1)*n);
+  V = (double *) malloc(sizeof(double)*n);
+  resvec = (double *) malloc(sizeof(double)*N);
+  for (i=0;i<n;i++) U[i] = V[i] = rng_unif(-10.0, 10.0);
+  heat_ie_plan_create(&fine, &n, &dtf, &T0, &T1);
+  heat_ie_plan_create(&coarse, &n, &dtc, &T0, &T1);
+  heat_parareal(&fine, &coarse, &N, &nfine, &ncoarse, U, &tol, &N, &nthreads, resvec, &nbite);
+  for (k=1;k<=N;k++){
+    heat_ie_step(&fine, V, &nfine);
+    for (i=0;i<n;i++) if (U[(size_t) k*n + i] != V[i]) r = INFINITY;
+  }
+  heat_ie_plan_free(&fine);
+  heat_ie_plan_free(&coarse);
+  free(U); free(V); free(resvec);
+  return r;
+}
+
+/* Mises à jour de rang 1 aléatoires (arêtes et diagonale), kmax petit pour
+   passer par les refactorisations ; dominance diagonale conservée */
+static double chk_lowrank(unsigned long long seed, int n, int nthreads){
+  check_case c;
+  p1d_lowrank lr;
+  int lab = 3, kv = 0, nrhs = 1, kmax, nup, u, i, info;
+  double *AB, *x, margin = INFINITY, r;
+  (void) nthreads;
+  case_alloc(&c, seed, n, 0, 0);
+  AB = case_AB(&c, 0);
+  x = (double *) malloc(sizeof(double)*n);
+  for (i=0;i<n;i++) margin = fmin(margin, fabs(c.diag[i]) - fabs(c.sub[i]) - fabs(c.sup[i]));
+  kmax = rng_int(1, 4);
+  nup = rng_int(1, 12);
+  info = p1d_lowrank_init(&lr, AB, &lab, &n, &kv, &kmax);
+  for (u=0;u<nup && info==0;u++){
+    double delta = rng_unif(-0.25, 0.25)*margin/nup;
+    int e;
+    if (rng_next() & 1){
+      e = rng_int(0, n);
+      info = p1d_lowrank_update_edge(&lr, &e, &delta);
+      if (e > 0) c.diag[e-1] += delta;
+      if (e < n) c.diag[e] += delta;
+      if (e > 0 && e < n){
+        c.sup[e-1] -= delta;
+        c.sub[e] -= delta;
+      }
+    } else {
+      e = rng_int(0, n-1);
+      info = p1d_lowrank_update_diag(&lr, &e, &delta);
+      c.diag[e] += delta;
+    }
+  }
+  memcpy(x, c.b, sizeof(double)*n);
+  if (info == 0) info = p1d_lowrank_solve(&lr, x, &nrhs);
+  r = (info != 0) ? INFINITY : solve_ratio(&c, x, BERR_TOL);
+  p1d_lowrank_free(&lr);
+  free(AB); free(x);
+  case_free(&c);
+  return r;
+}
+
+/* Instantanés p1z : champ régulier, bruit ou valeurs spéciales, tranches
+   courtes ; erreur bornée par eb (ou nulle sans perte) et lecture d'un
+   intervalle identique au décodage complet */
+static double chk_p1z(unsigned long long seed, int n, int nthreads, int lossless){
+  p1z_reader rd;
+  char name[256];
+  int chunk, i, kind;
+  long long i0, m;
+  double *v, *w, *s, scale, eb, r = 0.0;
+  rng_seed(seed ^ ((unsigned long long) n << 32));
+  snprintf(name, sizeof(name), "%s/poisson1D_check_%d.p1z",
+           getenv("TMPDIR") ? getenv("TMPDIR") : "/tmp", (int) getpid());
+  v = (double *) malloc(sizeof(double)*n);
+  w = (double *) malloc(sizeof(double)*n);
+  s = (double *) malloc(sizeof(double)*n);
+  scale = pow(10.0, rng_unif(-3.0, 3.0));
+  kind = rng_int(0, 3);
+  // 0, 3 : régulier ; 1 : bruit ; 2 : régulier proche de 0
+  for (i=0;i<n;i++){
+    double x = (i + 1.0)/(n + 1.0);
+    v[i] = scale*(x*x + sin(7.0*x));
+    if (kind == 1) v[i] = scale*rng_unif(-1.0, 1.0);
+    if (kind == 2) v[i] = x*(1e-6 + x)*scale;
+  }
+  if (kind == 3 && n > 2){
+    v[rng_int(0, n-1)] = NAN;
+    v[rng_int(0, n-1)] = INFINITY;
+    v[rng_int(0, n-1)] = 1e300;
+  }
+  chunk = rng_int(1, 300);
+  eb = lossless ? 0.0 : scale*pow(10.0, rng_unif(-12.0, -1.0));
+  omp_set_num_threads(nthreads);
+  if (p1z_write(v, n, eb, chunk, name) != 0 || p1z_open(&rd, name) != 0){
+    unlink(name);
+    free(v); free(w); free(s);
+    return INFINITY;
+  }
+  i0 = rng_int(0, n-1);
+  m = rng_int(0, n - (int) i0);
+  if (p1z_read(&rd, 0, n, w) != 0 || p1z_read(&rd, i0, m, s) != 0) r = INFINITY;
+  p1z_close(&rd);
+  unlink(name);
+  for (i=0;i<n && r==0.0;i++){
+    if (lossless || !isfinite(v[i])){
+      if (memcmp(&v[i], &w[i], sizeof(double)) != 0) r = INFINITY;
+    } else {
+      r = fmax(r, fabs(w[i] - v[i])/eb);
+    }
+  }
+  if (memcmp(s, w + i0, sizeof(double)*m) != 0) r = INFINITY;
+  free(v); free(w); free(s);
+  return r;
+}
+static double chk_p1z_lossy(unsigned long long seed, int n, int nthreads){ return chk_p1z(seed, n, nthreads, 0); }
+static double chk_p1z_lossless(unsigned long long seed, int n, int nthreads){ return chk_p1z(seed, n, nthreads, 1); }
+
+/* k-ième plus petite valeur propre de la tridiagonale symétrique (a, b) :
+   bissection de Sturm jusqu'à la précision machine */
+static double ref_eig(const double *a, const double *b, int n, int k){
+  double lo = a[0], hi = a[0], q;
+  int i, it, cnt;
+  for (i=0;i<n;i++){
+    double r = ((i > 0) ? fabs(b[i-1]) : 0.0) + ((i < n-1) ? fabs(b[i]) : 0.0);
+    lo = fmin(lo, a[i] - r);
+    hi = fmax(hi, a[i] + r);
+  }
+  for (it=0;it<200;it++){
+    double mid = 0.5*(lo + hi);
+    if (mid <= lo || mid >= hi) break;
+    q = 1.0;
+    cnt = 0;
+    for (i=0;i<n;i++){
+      q = (a[i] - mid) - ((i > 0) ? b[i-1]*b[i-1]/q : 0.0);
+      if (q == 0.0) q = -EPS*(fabs(a[i]) + fabs(mid) + DBL_MIN);
+      if (q < 0.0) cnt++;
+    }
+    if (cnt > k) hi = mid; else lo = mid;
+  }
+  return 0.5*(lo + hi);
+}
+
+/* Lanczos : valeurs de Ritz dans [lmin, lmax] exact (entrelacement de
+   Cauchy), extrêmes à moins de leur borne de résidu quand m >= n (sans
+   réorthogonalisation, T_n n'est pas exacte), lmax estimé au-dessus du
+   vrai lmax (sinon Chebyshev diverge), et refus d'un AB non symétrique */
+static double chk_spectrum(unsigned long long seed, int n, int nthreads){
+  check_case c;
+  p1d_spectrum spec;
+  int lab = 3, m = SPECTRUM_M, i;
+  int prec = ((seed >> 8) & 1) ? KRYLOV_PREC_JACOBI : KRYLOV_PREC_NONE;
+  double *AB, *a, *b, lmin, lmax, tol, r;
+  case_alloc(&c, seed, n, 1, 0);
+  AB = case_AB(&c, 0);
+  a = (double *) malloc(sizeof(double)*n);
+  b = (double *) calloc(n, sizeof(double));
+  for (i=0;i<n;i++){
+    a[i] = (prec == KRYLOV_PREC_JACOBI) ? 1.0 : c.diag[i];
+    if (i < n-1) b[i] = (prec == KRYLOV_PREC_JACOBI) ? c.sup[i]/sqrt(c.diag[i]*c.diag[i+1]) : c.sup[i];
+  }
+  lmin = ref_eig(a, b, n, 0);
+  lmax = ref_eig(a, b, n, n-1);
+  omp_set_num_threads(nthreads);
+  if (spectrum_lanczos_tridiag(AB, &lab, &n, prec, &m, &spec) != 0){
+    r = INFINITY;
+  } else {
+    tol = 64.0*n*EPS*lmax;
+    r = fmax(lmin - spec.theta_min, spec.theta_max - lmax)/tol;
+    if (n <= m){
+      r = fmax(r, (fabs(spec.theta_min - lmin) - spec.res_min)/tol);
+      r = fmax(r, (fabs(spec.theta_max - lmax) - spec.res_max)/tol);
+    }
+    r = fmax(r, (lmax - spec.lmax)/tol);
+  }
+  // Opérateur rendu non symétrique : refusé, pas d'estimation silencieuse
+  if (n > 1){
+    i = (int) (seed % (n-1));
+    AB[i*lab + 2] += 1e-6*(fabs(AB[i*lab + 2]) + 1.0);
+    if (spectrum_lanczos_tridiag(AB, &lab, &n, prec, &m, &spec) != SPECTRUM_ENONSYM) r = INFINITY;
+  }
+  free(AB); free(a); free(b);
+  case_free(&c);
+  return r;
+}
+
+/* Chebyshev : résidu vrai sous la tolérance demandée */
+static double chk_chebyshev(unsigned long long seed, int n, int nthreads){
+  check_case c;
+  int lab = 3, maxit = 4*n + 200, nbite, i;
+  int prec = ((seed >> 8) & 1) ? KRYLOV_PREC_JACOBI : KRYLOV_PREC_NONE;
+  double tol = 1e-10, *AB, *x, *r, *rv, nr = 0.0, nb = 0.0;
+  case_alloc(&c, seed, n, 1, 0);
+  AB = case_AB(&c, 0);
+  x = (double *) calloc(n, sizeof(double));
+  r = (double *) malloc(sizeof(double)*n);
+  rv = (double *) calloc(maxit+1, sizeof(double));
+  omp_set_num_threads(nthreads);
+  chebyshev_tridiag(AB, c.b, x, &lab, &n, prec, &tol, &maxit, rv, &nbite);
+  ref_matvec(&c, x, r);
+  for (i=0;i<n;i++){
+    nr += (c.b[i] - r[i])*(c.b[i] - r[i]);
+    nb += c.b[i]*c.b[i];
+  }
+  free(AB); free(x); free(r); free(rv);
+  case_free(&c);
+  // Marge de 10 : le critère d'arrêt porte sur le résidu récursif
+  return sqrt(nr/nb)/(10.0*tol);
+}
+
+/* Richardson MB : M = D (pas estimé par spectrum_get) sur une matrice
+   symétrique, M = D - E (pas 1) sur une matrice quelconque ; résidu vrai
+   sous la tolérance */
+static double chk_richardson_MB(unsigned long long seed, int n, int nthreads){
+  check_case c;
+  int lab = 3, kl = 1, ku = 1, kv = 1, maxit = 20000, nbite, i;
+  int gs = (int) ((seed >> 8) & 1);
+  double tol = 1e-10, *AB, *MB, *x, *r, *rv, nr = 0.0, nb = 0.0;
+  case_alloc(&c, seed, n, !gs, 0);
+  // Diagonale positive : D^-1 A à valeurs propres dans ]0, 2[
+  for (i=0;i<n;i++) c.diag[i] = fabs(c.diag[i]);
+  AB = case_AB(&c, 0);
+  MB = (double *) malloc(sizeof(double)*lab*n);
+  x = (double *) calloc(n, sizeof(double));
+  r = (double *) malloc(sizeof(double)*n);
+  rv = (double *) calloc(maxit+1, sizeof(double));
+  omp_set_num_threads(nthreads);
+  if (gs) extract_MB_gauss_seidel_tridiag(AB, MB, &lab, &n, &ku, &kl, &kv);
+  else extract_MB_jacobi_tridiag(AB, MB, &lab, &n, &ku, &kl, &kv);
+  richardson_MB(AB, c.b, x, MB, &lab, &n, &ku, &kl, &tol, &maxit, rv, &nbite);
+  ref_matvec(&c, x, r);
+  for (i=0;i<n;i++){
+    nr += (c.b[i] - r[i])*(c.b[i] - r[i]);
+    nb += c.b[i]*c.b[i];
+  }
+  free(AB); free(MB); free(x); free(r); free(rv);
+  case_free(&c);
+  return sqrt(nr/nb)/(10.0*tol);
+}
+
+/* Boucle adaptative : la solution renvoyée doit être la solution discrète sur
+   la grille renvoyée (erreur inverse), quel que soit le niveau d'arrêt */
+static double chk_adaptive_src(double x, void *ctx){
+  return exp(-(*(double *) ctx)*x);
+}
+
+static double chk_adaptive(unsigned long long seed, int n, int nthreads){
+  int la0, maxlevel, la, nlevel, info, i, lab = 4, kv = 1;
+  double a, tol, T0, T1, *x, *u, *AB, *RHS, nr = 0.0, na = 0.0, nu = 0.0, nb = 0.0;
+  rng_seed(seed ^ ((unsigned long long) n << 32));
+  la0 = (n < 64) ? n : 64;
+  maxlevel = rng_int(1, 6);
+  a = rng_unif(1.0, 200.0);
+  tol = pow(10.0, rng_unif(-8.0, -3.0));
+  T0 = rng_unif(-10.0, 10.0);
+  T1 = rng_unif(-10.0, 10.0);
+  omp_set_num_threads(nthreads);
+  info = poisson1D_adaptive(chk_adaptive_src, &a, &T0, &T1, &tol, la0, 4*CHECK_MAXN, maxlevel, &x, &u, &la, &nlevel);
+  if (info != 0 || nlevel > maxlevel){
+    free(x); free(u);
+    return INFINITY;
+  }
+  AB = (double *) malloc(sizeof(double)*lab*la);
+  RHS = (double *) malloc(sizeof(double)*la);
+  set_GB_operator_colMajor_poisson1D_nonuniform(AB, &lab, &la, x, &kv);
+  set_dense_RHS_nonuniform_1D(RHS, &la, x, chk_adaptive_src, &a, &T0, &T1);
+  // A(i,j) en AB[j*lab + kv+1+i-j]
+  for (i=0;i<la;i++){
+    double r = RHS[i] - AB[i*lab + kv+1]*u[i], ra = fabs(AB[i*lab + kv+1]);
+    if (i > 0){
+      r -= AB[(i-1)*lab + kv+2]*u[i-1];
+      ra += fabs(AB[(i-1)*lab + kv+2]);
+    }
+    if (i < la-1){
+      r -= AB[(i+1)*lab + kv]*u[i+1];
+      ra += fabs(AB[(i+1)*lab + kv]);
+    }
+    nr = fmax(nr, fabs(r));
+    na = fmax(na, ra);
+    nu = fmax(nu, fabs(u[i]));
+    nb = fmax(nb, fabs(RHS[i]));
+  }
+  free(x); free(u); free(AB); free(RHS);
+  return nr/(na*nu + nb)/(4.0*BERR_TOL);
+}
+
+typedef struct {
+  const char *name;
+  check_fn fn;
+  int maxn;
+} check_kernel;
+
+static const check_kernel kernels[] = {
+  {"dgbmv_poisson1D", chk_dgbmv_poisson1D, CHECK_MAXN},
+  {"csr_spmv", chk_csr_spmv, CHECK_MAXN},
+  {"sell_spmv", chk_sell_spmv, CHECK_MAXN},
+  {"dot_repro", chk_dot_repro, 4*CHECK_MAXN},
+  {"nrm2_repro", chk_nrm2_repro, 4*CHECK_MAXN},
+  {"dgbtrftridiag", chk_dgbtrftridiag, CHECK_MAXN},
+  {"dst_solve", chk_dst_solve, 4*CHECK_MAXN},
+  {"ooc_tridiag_solve", chk_ooc_tridiag_solve, CHECK_MAXN},
+  {"bc_cache_solve", chk_bc_cache_solve, CHECK_MAXN},
+  {"set_GB_par", chk_set_GB_par, CHECK_MAXN},
+  {"jacobi_tridiag", chk_jacobi, CHECK_MAXN},
+  {"gauss_seidel_tridiag", chk_gauss_seidel, CHECK_MAXN},
+  {"gmres_tridiag", chk_gmres, CHECK_MAXN},
+  {"bicgstab_tridiag", chk_bicgstab, CHECK_MAXN},
+  {"cyclic_tridiag_solve", chk_cyclic, CHECK_MAXN},
+  {"poisson1D_bc_solve", chk_bc_solve, CHECK_MAXN},
+  {"jacobi_tridiag_team", chk_jacobi_team, CHECK_MAXN},
+  {"richardson_alpha_team", chk_richardson_team, CHECK_MAXN},
+  {"heat_parareal", chk_parareal, CHECK_MAXN},
+  {"p1d_lowrank_solve", chk_lowrank, CHECK_MAXN},
+  {"p1z_lossy", chk_p1z_lossy, 4*CHECK_MAXN},
+  {"p1z_lossless", chk_p1z_lossless, 4*CHECK_MAXN},
+  {"spectrum_lanczos", chk_spectrum, CHECK_MAXN},
+  {"chebyshev_tridiag", chk_chebyshev, CHECK_MAXN},
+  {"richardson_MB", chk_richardson_MB, CHECK_MAXN},
+  {"poisson1D_adaptive", chk_adaptive, CHECK_MAXN},
+};
+#define NKERNEL ((int) (sizeof(kernels)/sizeof(kernels[0])))
+
+/* Tailles : petites, impaires, autour des largeurs vectorielles, ou aléatoires */
+static int random_size(int maxn){
+  static const int special[] = {1, 2, 3, 4, 5, 7, 8, 9, 15, 16, 17, 31, 33, 63, 65, 127, 129, 255, 257, 2047, 2049};
+  int ns = (int) (sizeof(special)/sizeof(special[0]));
+  int k = rng_int(0, 3);
+  if (k == 0){
+    int s = special[rng_int(0, ns-1)];
+    return (s <= maxn) ? s : maxn;
+  }
+  if (k == 1) return rng_int(1, 40);
+  return rng_int(1, maxn);
+}
+
+static int fails(const check_kernel *k, unsigned long long seed, int n, int t){
+  double r = k->fn(seed, n, t);
+  return !(r <= 1.0);
+}
+
+/* Réduction d'un cas en échec : plus petite taille puis un seul thread,
+   tant que l'échec persiste */
+static void shrink(const check_kernel *k, unsigned long long seed, int *n, int *t){
+  int progress = 1;
+  while (progress){
+    int cand[4], nc = 0, i;
+    progress = 0;
+    cand[nc++] = 1;
+    cand[nc++] = 2;
+    cand[nc++] = *n/2;
+    cand[nc++] = *n - 1;
+    for (i=0;i<nc;i++){
+      if (cand[i] >= 1 && cand[i] < *n && fails(k, seed, cand[i], *t)){
+        *n = cand[i];
+        progress = 1;
+        break;
+      }
+    }
+    if (!progress && *t > 1 && fails(k, seed, *n, 1)){
+      *t = 1;
+      progress = 1;
+    }
+  }
+}
+
+int main(int argc,char *argv[])
+{
+  unsigned long long seed = 20240101ULL;
+  int ncases = 200, maxthreads = omp_get_max_threads();
+  int only = -1, fixed_n = 0, fixed_t = 0, id, q, nfail = 0;
+
+  for (q=1;q<argc;q++){
+    if (strcmp(argv[q], "-c") == 0 && q+1 < argc) ncases = atoi(argv[++q]);
+    else if (strcmp(argv[q], "-s") == 0 && q+1 < argc) seed = strtoull(argv[++q], NULL, 10);
+    else if (strcmp(argv[q], "-n") == 0 && q+1 < argc) fixed_n = atoi(argv[++q]);
+    else if (strcmp(argv[q], "-t") == 0 && q+1 < argc) fixed_t = atoi(argv[++q]);
+    else if (strcmp(argv[q], "-k") == 0 && q+1 < argc){
+      q++;
+      for (id=0;id<NKERNEL;id++) if (strcmp(argv[q], kernels[id].name) == 0) only = id;
+      if (only < 0){
+        printf("Noyau inconnu : %s\n", argv[q]);
+        exit(1);
+      }
+    } else {
+      printf("Usage: %s [-c ncases] [-s seed] [-k kernel -n la -t threads]\n", argv[0]);
+      exit(1);
+    }
+  }
+  if (maxthreads < 4) maxthreads = 4;
+
+  printf("--------- Poisson 1D differential check ---------\n\n");
+  printf("graine %llu, %d cas par noyau, jusqu'à %d threads\n\n", seed, ncases, maxthreads);
+
+  for (id=0;id<NKERNEL;id++){
+    const check_kernel *k = &kernels[id];
+    double worst = 0.0;
+    int c, bad = 0;
+    if (only >= 0 && id != only) continue;
+    for (c=0;c<ncases;c++){
+      // En mode reproduction (-k -n), la graine donnée est celle du cas
+      unsigned long long cs = seed + 7919ULL*c + ((only >= 0 && fixed_n) ? 0ULL : 104729ULL*id);
+      int n, t;
+      double r;
+      rng_seed(cs);
+      n = fixed_n ? fixed_n : random_size(k->maxn);
+      t = fixed_t ? fixed_t : rng_int(1, maxthreads);
+      r = k->fn(cs, n, t);
+      if (r <= 1.0){
+        worst = fmax(worst, r);
+        continue;
+      }
+      // Les premiers échecs suffisent : réduction et reproducteur
+      if (++bad > 5) continue;
+      shrink(k, cs, &n, &t);
+      printf("ÉCHEC %-22s rapport %e ; reproduire : %s -k %s -s %llu -n %d -t %d -c 1\n",
+             k->name, r, argv[0], k->name, cs, n, t);
+      if (fixed_n) break;
+    }
+    printf("%-22s %5d cas  %s  (pire rapport erreur/tolérance %.3f)\n",
+           k->name, ncases, bad ? "ÉCHEC" : "ok   ", worst);
+    nfail += bad;
+  }
+  omp_set_num_threads(omp_get_num_procs());
+
+  if (nfail > 0){
+    printf("\n%d cas en échec\n", nfail);
+    exit(1);
+  }
+  printf("\nTous les noyaux sont conformes à la référence\n");
+  printf("\n\n--------- End -----------\n");
+  return 0;
+}
@@ -13,6 +13,10 @@
 #define SV 2
 #define DGBMV_TEST 3  
 #define LU_TEST 4  
+#define DST 5
+#define AUTO 6
+#define BCCACHE 7
+#define LOWRANK 8
 
 int main(int argc,char *argv[])
 
@@ -21,7 +25,7 @@ int main(int argc,char *argv[])
   int jj;
   int nbpoints, la;
   int ku, kl, kv, lab;
-  int *ipiv;
+  int *ipiv = NULL;
   int info = 1;
   int NRHS;
   int IMPLEM = 0;
@@ -174,6 +178,95 @@ int main(int argc,char *argv[])
       cpu_time_used = ((double) (end - start)) / CLOCKS_PER_SEC;
       printf("\nTemps d'exécution (DGBSV) : %f secondes\n", cpu_time_used);
     }
+    /* Fast spectral solver (DST-I) */
+    if (IMPLEM == DST) {
+      dst_plan plan;
+      start = clock();
+      dst_plan_create(&plan, &la);
+      poisson1D_dst_solve(&plan, RHS, &NRHS, &la, NULL, NULL);
+      end = clock();
+      dst_plan_free(&plan);
+      info = 0;
+      cpu_time_used = ((double) (end - start)) / CLOCKS_PER_SEC;
+      printf("\nTemps d'exécution (DST-I) : %f secondes\n", cpu_time_used);
+    }
+    /* Autotuned dispatch */
+    if (IMPLEM == AUTO) {
+      double tol = 1e-12;
+      start = clock();
+      info = poisson1D_solve(RHS, &la, &NRHS, &tol);
+      end = clock();
+      cpu_time_used = ((double) (end - start)) / CLOCKS_PER_SEC;
+      printf("\nTemps d'exécution (poisson1D_solve) : %f secondes\n", cpu_time_used);
+    }
+    /* Superposition of the cached unit-boundary solutions */
+    if (IMPLEM == BCCACHE) {
+      bc_cache cache;
+      double bc0, bc1, err = 0.0;
+      bc_cache_init(&cache, 0);
+      start = clock();
+      // Balayage de conditions aux limites : une seule résolution
+      for (int q = 0; q < 1000; q++) {
+        bc0 = -10.0 + 0.02*q;
+        bc1 = 10.0 - 0.03*q;
+        bc_cache_solve(&cache, &la, &bc0, &bc1, X_TEST);
+        set_analytical_solution_DBC_1D(EX_SOL, X, &la, &bc0, &bc1);
+        err = fmax(err, relative_forward_error(X_TEST, EX_SOL, &la));
+      }
+      end = clock();
+      printf("\n1000 jeux (T0, T1), %llu résolution(s), erreur max = %e\n", cache.nsolves, err);
+      bc_cache_solve(&cache, &la, &T0, &T1, RHS);
+      set_analytical_solution_DBC_1D(EX_SOL, X, &la, &T0, &T1);
+      bc_cache_free(&cache);
+      info = 0;
+      cpu_time_used = ((double) (end - start)) / CLOCKS_PER_SEC;
+      printf("\nTemps d'exécution (cache de superposition) : %f secondes\n", cpu_time_used);
+    }
+    /* What-if queries: conductivity changes by low-rank updates */
+    if (IMPLEM == LOWRANK) {
+      p1d_lowrank lr;
+      int kmax = 0, e0, e1, q;
+      double *kappa = (double *) malloc(sizeof(double)*(la+1));
+      double *ABk = (double *) malloc(sizeof(double)*lab*la);
+      double dk0, dk1, err = 0.0;
+      for (jj = 0; jj <= la; jj++) kappa[jj] = 1.0;
+      start = clock();
+      p1d_lowrank_init(&lr, AB, &lab, &la, &kv, &kmax);
+      // Perturbation de deux arêtes intérieures, résolution, retour à kappa = 1
+      for (q = 0; q < 100; q++) {
+        e0 = 1 + (3*q) % (la-1);
+        e1 = 1 + (5*q + 1) % (la-1);
+        dk0 = 0.1*(1 + q % 7);
+        dk1 = -0.05*(1 + q % 5);
+        p1d_lowrank_update_edge(&lr, &e0, &dk0);
+        p1d_lowrank_update_edge(&lr, &e1, &dk1);
+        memcpy(X_TEST, RHS, sizeof(double)*la);
+        p1d_lowrank_solve(&lr, X_TEST, &NRHS);
+        // Référence : assemblage et dgbsv complets
+        kappa[e0] += dk0;
+        kappa[e1] += dk1;
+        set_GB_operator_colMajor_conductivity(ABk, &lab, &la, &kv, kappa);
+        set_dense_RHS_DBC_conductivity(EX_SOL, &la, kappa, &T0, &T1);
+        dgbsv_(&la, &kl, &ku, &NRHS, ABk, &lab, ipiv, EX_SOL, &la, &info);
+        err = fmax(err, relative_forward_error(X_TEST, EX_SOL, &la));
+        kappa[e0] -= dk0;
+        kappa[e1] -= dk1;
+        dk0 = -dk0;
+        dk1 = -dk1;
+        p1d_lowrank_update_edge(&lr, &e0, &dk0);
+        p1d_lowrank_update_edge(&lr, &e1, &dk1);
+      }
+      end = clock();
+      printf("\n100 requêtes, %d mises à jour de rang 1, %d factorisation(s), écart max à dgbsv = %e\n",
+             lr.nupdate, lr.nrefactor, err);
+      info = p1d_lowrank_solve(&lr, RHS, &NRHS);
+      set_analytical_solution_DBC_1D(EX_SOL, X, &la, &T0, &T1);
+      p1d_lowrank_free(&lr);
+      free(kappa);
+      free(ABk);
+      cpu_time_used = ((double) (end - start)) / CLOCKS_PER_SEC;
+      printf("\nTemps d'exécution (mises à jour de rang faible) : %f secondes\n", cpu_time_used);
+    }
     // Sauvegarde de la solution
     write_GB_operator_colMajor_poisson1D(AB, &lab, &la, "LU.dat");
     write_xy(RHS, X, &la, "SOL.dat");
@@ -189,8 +282,6 @@ int main(int argc,char *argv[])
   free(X);
   free(X_TEST);
   free(AB);
-  if (IMPLEM == TRF || IMPLEM == TRI) {
-    free(ipiv);
-  }
+  free(ipiv);
   printf("\n\n--------- End -----------\n");
 }
@@ -0,0 +1,90 @@
+/******************************************/
+/* tp_poisson1D_heat.c                    */
+/* Transient heat equation: sequential    */
+/* implicit Euler against Parareal,       */
+/* speedup versus the number of threads   */
+/******************************************/
+#include "lib_poisson1D.h"
+#include <time.h>
+#include <omp.h>
+
+static double wtime(void){
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + 1e-9*ts.tv_nsec;
+}
+
+int main(int argc,char *argv[])
+{
+  int la = 1000, N = 32, nfine = 100, ncoarse = 1, maxthreads, maxk, nsteps, nbite, nt, jj;
+  double T0 = -5.0, T1 = 5.0, tfinal = 0.1, tol = 1e-6;  // tol : sous l'erreur en temps du schéma fin
+  double dtf, dtc, tseq, *X, *U0, *Useq, *U, *resvec;
+  heat_ie_plan fine, coarse;
+
+  maxthreads = omp_get_max_threads();
+  if (argc > 5) {
+    perror("Usage: tpPoisson1D_heat [la] [nslices] [nfine] [threads]");
+    exit(1);
+  }
+  if (argc > 1) la = atoi(argv[1]);
+  if (argc > 2) N = atoi(argv[2]);
+  if (argc > 3) nfine = atoi(argv[3]);
+  if (argc > 4) maxthreads = atoi(argv[4]);
+  if (la < 1 || N < 1 || nfine < 1 || maxthreads < 1) {
+    printf("Erreur: arguments invalides\n");
+    exit(1);
+  }
+  maxk = N;
+  dtf = tfinal/(N*nfine);
+  dtc = tfinal/(N*ncoarse);
+
+  X = (double *) malloc(sizeof(double)*la);
+  U0 = (double *) malloc(sizeof(double)*la);
+  Useq = (double *) malloc(sizeof(double)*la);
+  U = (double *) malloc(sizeof(double)*(N+1)*la);
+  resvec = (double *) calloc(N, sizeof(double));
+
+  // Condition initiale : profil d'équilibre perturbé par deux modes
+  set_grid_points_1D(X, &la);
+  for (jj=0;jj<la;jj++){
+    U0[jj] = T0 + X[jj]*(T1 - T0) + 10.0*sin(M_PI*X[jj]) + 2.0*sin(8.0*M_PI*X[jj]);
+  }
+  if (heat_ie_plan_create(&fine, &la, &dtf, &T0, &T1) != 0) exit(1);
+  if (heat_ie_plan_create(&coarse, &la, &dtc, &T0, &T1) != 0) exit(1);
+
+  printf("--------- Equation de la chaleur, Euler implicite ---------\n");
+  printf("la = %d, t final = %g, %d tranches x %d pas fins (dt = %.3e), %d pas grossiers par tranche\n",
+         la, tfinal, N, nfine, dtf, ncoarse);
+
+  // Référence : pas à pas séquentiel
+  nsteps = N*nfine;
+  memcpy(Useq, U0, sizeof(double)*la);
+  tseq = wtime();
+  heat_ie_step(&fine, Useq, &nsteps);
+  tseq = wtime() - tseq;
+  printf("Séquentiel : %d pas, %.4f s\n\n", nsteps, tseq);
+
+  printf(" threads | itérations |  temps (s) | accélération | écart au séquentiel\n");
+  for (nt=1;nt<=maxthreads;nt=(nt < maxthreads && 2*nt > maxthreads) ? maxthreads : 2*nt){
+    double t, err;
+    memcpy(U, U0, sizeof(double)*la);
+    t = wtime();
+    heat_parareal(&fine, &coarse, &N, &nfine, &ncoarse, U, &tol, &maxk, &nt, resvec, &nbite);
+    t = wtime() - t;
+    err = relative_forward_error(Useq, U + (size_t) N*la, &la);
+    printf("%8d | %10d | %10.4f | %12.2f | %e\n", nt, nbite, t, tseq/t, err);
+  }
+  // Accélération idéale : N tranches en nbite vagues parallèles, plus le
+  // grossier séquentiel
+  printf("\nAccélération maximale pour %d itérations sur %d threads : %.2f\n", nbite, maxthreads,
+         1.0/((double) nbite/fmin(maxthreads, N) + (double) (nbite+1)*ncoarse/nfine));
+  printf("Historique des corrections :");
+  for (jj=0;jj<nbite;jj++) printf(" %.2e", resvec[jj]);
+  printf("\n");
+
+  heat_ie_plan_free(&fine);
+  heat_ie_plan_free(&coarse);
+  free(X); free(U0); free(Useq); free(U); free(resvec);
+  printf("\n\n--------- End -----------\n");
+  return 0;
+}
@@ -8,6 +8,10 @@
 #define ALPHA 0
 #define JAC 1
 #define GS 2
+#define CSR 3
+#define GMRES 4
+#define BICGSTAB 5
+#define CHEBYSHEV 6
 
 int main(int argc,char *argv[])
 {
@@ -78,31 +82,60 @@ int main(int argc,char *argv[])
   opt_alpha = richardson_alpha_opt(&la);
   printf("Optimal alpha for simple Richardson iteration is : %lf",opt_alpha); 
 
+  /* Same parameter from a Lanczos estimate of the spectrum of AB: valid
+     for any symmetric tridiagonal operator, not only [-1 2 -1] */
+  double auto_alpha = richardson_alpha_auto(AB, &lab, &la);
+  printf("\nAlpha from the estimated spectrum : %lf (closed form : %lf)\n", auto_alpha, opt_alpha);
+
   /* Solve */
   double tol=1e-3;
   int maxit=1000;
   double *resvec;
   int nbite=0;
+  int nres=0; /* nombre de résidus stockés dans resvec */
+
+  resvec=(double *) calloc(maxit+1, sizeof(double));
+
+  /* Optional checkpoint/restart: POISSON1D_CHECKPOINT=file [POISSON1D_CHECKPOINT_EVERY=n] */
+  char *ckpt_file = getenv("POISSON1D_CHECKPOINT");
+  int ckpt_every = getenv("POISSON1D_CHECKPOINT_EVERY") ? atoi(getenv("POISSON1D_CHECKPOINT_EVERY")) : 100;
+  ckpt_ctx ckpt;
+  if (ckpt_file != NULL) {
+    ckpt_init(&ckpt, ckpt_file, ckpt_every);
+  }
 
-  resvec=(double *) calloc(maxit, sizeof(double));
+  /* Optional persistent thread team: POISSON1D_TEAM=nthreads [POISSON1D_PIN=policy] */
+  char *team_env = getenv("POISSON1D_TEAM");
+  p1d_team team;
+  memset(&team, 0, sizeof(p1d_team));
+  if (team_env != NULL) {
+    p1d_team_create(&team, atoi(team_env), poisson1D_pin_policy(getenv("POISSON1D_PIN")));
+  }
 
   /* Solve with Richardson alpha */
   if (IMPLEM == ALPHA) {
-    richardson_alpha(AB, RHS, SOL, &opt_alpha, &lab, &la, &ku, &kl, &tol, &maxit, resvec, &nbite);
+    if (ckpt_file != NULL) {
+      iterative_solve_ckpt(CKPT_RICHARDSON, AB, RHS, SOL, &auto_alpha, &lab, &la, &ku, &kl, &tol, &maxit, resvec, &nbite, &ckpt);
+    } else if (team.nthreads > 0) {
+      richardson_alpha_team(&team, AB, RHS, SOL, &auto_alpha, &lab, &la, &tol, &maxit, resvec, &nbite);
+    } else {
+      richardson_alpha(AB, RHS, SOL, &auto_alpha, &lab, &la, &ku, &kl, &tol, &maxit, resvec, &nbite);
+    }
+    nres = nbite;
     printf("\nRichardson :\n");
     printf("Nombre d'itérations : %d\n", nbite);
-    printf("Résidu final : %e\n", resvec[nbite-1]);
+    printf("Résidu final : %e\n", resvec[nres-1]);
     
     // Analyse de la convergence
     printf("\nAnalyse de la convergence :\n");
     printf("Iteration |    Résidu    | Ratio de convergence\n");
     printf("-----------------------------------------\n");
-    for(int i = 0; i < nbite; i += nbite/5) {  // Affiche ~5 points
+    for(int i = 0; i < nres; i += nres/5) {  // Affiche ~5 points
         double ratio = (i > 0) ? resvec[i]/resvec[i-1] : 0.0;
         printf("%9d | %11.1e | %19.2f\n", i, resvec[i], ratio);
     }
-    printf("%9d | %11.1e | %19.2f\n", nbite-1, resvec[nbite-1], 
-           resvec[nbite-1]/resvec[nbite-2]);
+    printf("%9d | %11.1e | %19.2f\n", nres-1, resvec[nres-1], 
+           resvec[nres-1]/resvec[nres-2]);
     
     // Affichage des solutions pour comparaison
     printf("\nComparaison des solutions :\n");
@@ -122,6 +155,108 @@ int main(int argc,char *argv[])
     write_vec(EX_SOL, &la, "EX_SOL.dat");
   }
 
+  /* Solve with Richardson alpha on CSR / SELL-C-sigma storage */
+  if (IMPLEM == CSR) {
+    csr_matrix A;
+    sell_matrix S;
+    double *Y_GB = (double *) malloc(sizeof(double)*la);
+    double *Y_SP = (double *) malloc(sizeof(double)*la);
+
+    GB2CSR_operator_colMajor(AB, &lab, &la, &ku, &kl, &kv, &A);
+    CSR2SELL(&A, 4, 32, &S);
+    printf("\nStockage CSR : n = %d, nnz = %d\n", A.n, A.nnz);
+
+    // Vérification du produit creux contre dgbmv
+    dgbmv_poisson1D(AB, EX_SOL, Y_GB, &la, &lab, &ku, &kl, &kv);
+    csr_spmv(&A, EX_SOL, Y_SP);
+    printf("Ecart SpMV CSR / DGBMV : %e\n", relative_forward_error(Y_SP, Y_GB, &la));
+    sell_spmv(&S, EX_SOL, Y_SP);
+    printf("Ecart SpMV SELL / DGBMV : %e\n", relative_forward_error(Y_SP, Y_GB, &la));
+
+    richardson_alpha_csr(&A, RHS, SOL, &opt_alpha, &tol, &maxit, resvec, &nbite);
+    nres = nbite;
+    printf("\nRichardson (CSR) :\n");
+    printf("Nombre d'itérations : %d\n", nbite);
+    printf("Résidu final : %e\n", resvec[nres-1]);
+
+    relres = relative_forward_error(SOL, EX_SOL, &la);
+    printf("\nErreur relative par rapport à la solution analytique : %e\n", relres);
+
+    write_vec(SOL, &la, "SOL_csr.dat");
+    csr_free(&A);
+    sell_free(&S);
+    free(Y_GB);
+    free(Y_SP);
+  }
+
+  /* Convection-diffusion -u'' + v u' = 0 with GMRES(m) / BiCGStab */
+  if (IMPLEM == GMRES || IMPLEM == BICGSTAB) {
+    krylov_ws ws;
+    double vel = 20.0;
+    int scheme = CONVDIFF_CENTRAL;
+    int prec = KRYLOV_PREC_JACOBI;
+    int restart = 30;
+    char *env;
+    double *CD = (double *) malloc(sizeof(double)*lab*la);
+
+    if ((env = getenv("POISSON1D_VELOCITY")) != NULL) vel = atof(env);
+    if ((env = getenv("POISSON1D_SCHEME")) != NULL && strcmp(env, "upwind") == 0) scheme = CONVDIFF_UPWIND;
+    if ((env = getenv("POISSON1D_PREC")) != NULL) {
+      if (strcmp(env, "none") == 0) prec = KRYLOV_PREC_NONE;
+      else if (strcmp(env, "ilu") == 0) prec = KRYLOV_PREC_ILU0;
+    }
+    set_GB_operator_colMajor_convdiff(CD, &lab, &la, &kv, &vel, scheme);
+    set_dense_RHS_DBC_convdiff(RHS, &la, &vel, scheme, &T0, &T1);
+    set_analytical_solution_convdiff(EX_SOL, X, &la, &vel, &T0, &T1);
+
+    if (krylov_ws_init(&ws, CD, &lab, &la, &kv, &restart, prec) != 0) {
+      printf("Erreur: allocation de l'espace de travail Krylov\n");
+      exit(1);
+    }
+    if (IMPLEM == GMRES) {
+      gmres_tridiag(&ws, RHS, SOL, &tol, &maxit, resvec, &nbite);
+      printf("\nGMRES(%d) (v = %g, %s) :\n", restart, vel, scheme == CONVDIFF_UPWIND ? "décentré" : "centré");
+    } else {
+      bicgstab_tridiag(&ws, RHS, SOL, &tol, &maxit, resvec, &nbite);
+      printf("\nBiCGStab (v = %g, %s) :\n", vel, scheme == CONVDIFF_UPWIND ? "décentré" : "centré");
+    }
+    nres = nbite+1;
+    printf("Nombre d'itérations : %d\n", nbite);
+    printf("Résidu final : %e\n", resvec[nres-1]);
+
+    relres = relative_forward_error(SOL, EX_SOL, &la);
+    printf("\nErreur relative par rapport à la solution analytique : %e\n", relres);
+
+    write_vec(SOL, &la, IMPLEM == GMRES ? "SOL_gmres.dat" : "SOL_bicgstab.dat");
+    write_vec(EX_SOL, &la, "EX_SOL.dat");
+    krylov_ws_free(&ws);
+    free(CD);
+  }
+
+  /* Chebyshev iteration on the estimated spectrum [lmin, lmax] */
+  if (IMPLEM == CHEBYSHEV) {
+    p1d_spectrum spec;
+    int prec = KRYLOV_PREC_JACOBI;
+    char *env;
+
+    if ((env = getenv("POISSON1D_PREC")) != NULL && strcmp(env, "none") == 0) prec = KRYLOV_PREC_NONE;
+    if (spectrum_get(AB, &lab, &la, prec, &spec) != 0
+        || chebyshev_tridiag(AB, RHS, SOL, &lab, &la, prec, &tol, &maxit, resvec, &nbite) != 0) {
+      printf("Erreur: pas d'estimation du spectre (opérateur non symétrique ?)\n");
+      exit(1);
+    }
+    printf("\nChebyshev (%s) sur [%e, %e] :\n", prec == KRYLOV_PREC_JACOBI ? "Jacobi" : "sans préconditionneur",
+           spec.lmin, spec.lmax);
+    nres = nbite+1;
+    printf("Nombre d'itérations : %d\n", nbite);
+    printf("Résidu final : %e\n", resvec[nres-1]);
+
+    relres = relative_forward_error(SOL, EX_SOL, &la);
+    printf("\nErreur relative par rapport à la solution analytique : %e\n", relres);
+
+    write_vec(SOL, &la, "SOL_chebyshev.dat");
+  }
+
   /* Richardson General Tridiag */
 
   /* get MB (:=M, D for Jacobi, (D-E) for Gauss-seidel) */
@@ -140,26 +275,33 @@ int main(int argc,char *argv[])
     write_GB_operator_colMajor_poisson1D(MB, &lab, &la, "MB.dat");
     
     // Résolution avec Jacobi
-    jacobi_tridiag(AB, RHS, SOL, &lab, &la, &ku, &kl, &tol, &maxit, resvec, &nbite);
+    if (ckpt_file != NULL) {
+      iterative_solve_ckpt(CKPT_JACOBI, AB, RHS, SOL, NULL, &lab, &la, &ku, &kl, &tol, &maxit, resvec, &nbite, &ckpt);
+    } else if (team.nthreads > 0) {
+      jacobi_tridiag_team(&team, AB, RHS, SOL, &lab, &la, &tol, &maxit, resvec, &nbite);
+    } else {
+      jacobi_tridiag(AB, RHS, SOL, &lab, &la, &ku, &kl, &tol, &maxit, resvec, &nbite);
+    }
     
+    nres = nbite+1;
     printf("\nJacobi :\n");
     printf("Nombre d'itérations : %d\n", nbite);
-    printf("Résidu final : %e\n", resvec[nbite-1]);
+    printf("Résidu final : %e\n", resvec[nres-1]);
     
     // Analyse de la convergence
     printf("\nAnalyse de la convergence :\n");
     printf("Iteration |    Résidu    | Ratio de convergence\n");
     printf("-----------------------------------------\n");
-    for(int i = 0; i < nbite; i += nbite/5) {  // Affiche ~5 points
+    for(int i = 0; i < nres; i += nres/5) {  // Affiche ~5 points
         double ratio = (i > 0) ? resvec[i]/resvec[i-1] : 0.0;
         printf("%9d | %11.1e | %19.2f\n", i, resvec[i], ratio);
     }
-    printf("%9d | %11.1e | %19.2f\n", nbite-1, resvec[nbite-1], 
-           resvec[nbite-1]/resvec[nbite-2]);
+    printf("%9d | %11.1e | %19.2f\n", nres-1, resvec[nres-1], 
+           resvec[nres-1]/resvec[nres-2]);
     /* 
      // Affichage des résidus pour chaque itération
     printf("\nRésidus pour chaque itération :\n");
-    for(int i = 0; i <= nbite; i++) {
+    for(int i = 0; i < nres; i++) {
         printf("%e\n", resvec[i]);
     }
     */
@@ -185,22 +327,27 @@ int main(int argc,char *argv[])
     write_GB_operator_colMajor_poisson1D(MB, &lab, &la, "MB.dat");
     
     // Résolution avec Gauss-Seidel
-    gauss_seidel_tridiag(AB, RHS, SOL, &lab, &la, &ku, &kl, &tol, &maxit, resvec, &nbite);
+    if (ckpt_file != NULL) {
+      iterative_solve_ckpt(CKPT_GS, AB, RHS, SOL, NULL, &lab, &la, &ku, &kl, &tol, &maxit, resvec, &nbite, &ckpt);
+    } else {
+      gauss_seidel_tridiag(AB, RHS, SOL, &lab, &la, &ku, &kl, &tol, &maxit, resvec, &nbite);
+    }
     
+    nres = nbite+1;
     printf("\nGauss-Seidel :\n");
     printf("Nombre d'itérations : %d\n", nbite);
-    printf("Résidu final : %e\n", resvec[nbite-1]);
+    printf("Résidu final : %e\n", resvec[nres-1]);
     
     // Analyse de la convergence
     printf("\nAnalyse de la convergence :\n");
     printf("Iteration |    Résidu    | Ratio de convergence\n");
     printf("-----------------------------------------\n");
-    for(int i = 0; i < nbite; i += nbite/5) {  // Affiche ~5 points
+    for(int i = 0; i < nres; i += nres/5) {  // Affiche ~5 points
         double ratio = (i > 0) ? resvec[i]/resvec[i-1] : 0.0;
         printf("%9d | %11.1e | %19.2f\n", i, resvec[i], ratio);
     }
-    printf("%9d | %11.1e | %19.2f\n", nbite-1, resvec[nbite-1], 
-           resvec[nbite-1]/resvec[nbite-2]);
+    printf("%9d | %11.1e | %19.2f\n", nres-1, resvec[nres-1], 
+           resvec[nres-1]/resvec[nres-2]);
     
     // Affichage des solutions pour comparaison
     printf("\nComparaison des solutions :\n");
@@ -220,25 +367,45 @@ int main(int argc,char *argv[])
     /*
     // Sauvegarde des résidus pour le graphe
     printf("\nRésidus pour chaque itération :\n");
-    for(int i = 0; i <= nbite; i++) {
+    for(int i = 0; i < nres; i++) {
         printf("%e\n", resvec[i]);
     }
     */
   }
 
+  /* Same splitting in the general form X += alpha M^-1 (RHS - AX) */
+  if (IMPLEM == JAC || IMPLEM == GS) {
+    double *SOL_MB = (double *) calloc(la, sizeof(double));
+    double *resvec_MB = (double *) calloc(maxit+1, sizeof(double));
+    int nbite_MB;
+
+    richardson_MB(AB, RHS, SOL_MB, MB, &lab, &la, &ku, &kl, &tol, &maxit, resvec_MB, &nbite_MB);
+    printf("\nRichardson MB (alpha = %f) :\n", richardson_MB_alpha(AB, MB, &lab, &la, &kl));
+    printf("Nombre d'itérations : %d\n", nbite_MB);
+    printf("Résidu final : %e\n", resvec_MB[nbite_MB-1]);
+    printf("Erreur relative par rapport à la solution analytique : %e\n",
+           relative_forward_error(SOL_MB, EX_SOL, &la));
+    free(SOL_MB);
+    free(resvec_MB);
+  }
+
   /* Write solution */
   write_vec(SOL, &la, "SOL.dat");
 
-  /* Write convergence history */
-  write_vec(resvec, &nbite, "RESVEC.dat");
+  /* Write convergence history (nres entries, final residual included) */
+  write_vec_history(resvec, &nres, "RESVEC.dat");
 /*
   printf("\nDonnées pour le graphe (format CSV) :\n");
   printf("Iteration,Residu\n");
-  for(int i = 0; i < nbite; i++) {
+  for(int i = 0; i < nres; i++) {
       printf("%d,%e\n", i, resvec[i]);
   }
 */
 
+  if (ckpt_file != NULL) {
+    ckpt_free(&ckpt);
+  }
+  p1d_team_free(&team);
   free(resvec);
   free(RHS);
   free(SOL);
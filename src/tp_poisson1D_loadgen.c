@@ -0,0 +1,144 @@
+/******************************************/
+/* tp_poisson1D_loadgen.c                 */
+/* Load generator for the solver daemon:  */
+/* latency percentiles and throughput     */
+/******************************************/
+#include "lib_poisson1D.h"
+#include <time.h>
+#include <signal.h>
+
+typedef struct {
+  char *path;
+  int la;
+  int solver;
+  int nreq;
+  double *lat;              /* per-request latency (s) */
+  int ndone;                /* completed requests: lat[0..ndone-1] */
+  double err;               /* max relative forward error */
+  int status;
+} loadgen_arg;
+
+static double now(void){
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec + 1e-9*t.tv_nsec;
+}
+
+static int cmp_double(const void *a, const void *b){
+  double x = *(const double *) a, y = *(const double *) b;
+  return (x > y) - (x < y);
+}
+
+static void *loadgen_worker(void *arg){
+  loadgen_arg *a = (loadgen_arg *) arg;
+  p1d_client cli;
+  p1d_request req;
+  p1d_reply rep;
+  double *X = (double *) malloc(sizeof(double)*a->la);
+  double *EX_SOL = (double *) malloc(sizeof(double)*a->la);
+  int q;
+
+  a->ndone = 0;
+  a->status = p1d_client_connect(&cli, a->path, a->la);
+  if (a->status != 0){
+    free(X);
+    free(EX_SOL);
+    return NULL;
+  }
+  set_grid_points_1D(X, &a->la);
+  memset(&req, 0, sizeof(req));
+  req.la = a->la;
+  req.solver = a->solver;
+  req.tol = 1e-10;
+  a->err = 0.0;
+  for (q=0;q<a->nreq;q++){
+    double t;
+    req.T0 = -10.0 + 0.02*(q % 1000);
+    req.T1 = 10.0 - 0.03*(q % 1000);
+    if (req.solver == P1D_SOLVER_LU){
+      set_dense_RHS_DBC_1D(cli.X, &req.la, &req.T0, &req.T1);
+    }
+    t = now();
+    a->status = p1d_client_solve(&cli, &req, &rep);
+    if (a->status != 0) break;
+    a->lat[a->ndone++] = now() - t;
+    // Vérification ponctuelle de la solution renvoyée
+    if (q % 97 == 0){
+      set_analytical_solution_DBC_1D(EX_SOL, X, &req.la, &req.T0, &req.T1);
+      a->err = fmax(a->err, relative_forward_error(cli.X, EX_SOL, &req.la));
+    }
+  }
+  p1d_client_close(&cli);
+  free(X);
+  free(EX_SOL);
+  return NULL;
+}
+
+int main(int argc,char *argv[])
+{
+  char *path = "/tmp/poisson1D.sock";
+  int nconn = 4, nreq = 10000, la = 1000, solver = P1D_SOLVER_BCCACHE;
+  int c, ntot = 0, failed = 0;
+  loadgen_arg *args;
+  pthread_t *th;
+  double *lat, t, err = 0.0;
+
+  // Serveur arrêté en cours de test : erreur de write, pas de SIGPIPE
+  signal(SIGPIPE, SIG_IGN);
+  if (argc > 1 && strcmp(argv[1], "stop") == 0){
+    p1d_client cli;
+    if (p1d_client_connect(&cli, (argc > 2) ? argv[2] : path, 1) != 0) exit(1);
+    p1d_client_shutdown(&cli);
+    p1d_client_close(&cli);
+    return 0;
+  }
+  if (argc > 6) {
+    printf("Usage: %s [socket] [nconn] [nreq] [la] [solver]\n", argv[0]);
+    printf("       %s stop [socket]\n", argv[0]);
+    exit(1);
+  }
+  if (argc > 1) path = argv[1];
+  if (argc > 2) nconn = atoi(argv[2]);
+  if (argc > 3) nreq = atoi(argv[3]);
+  if (argc > 4) la = atoi(argv[4]);
+  if (argc > 5) solver = atoi(argv[5]);
+
+  args = (loadgen_arg *) calloc(nconn, sizeof(loadgen_arg));
+  th = (pthread_t *) malloc(sizeof(pthread_t)*nconn);
+  lat = (double *) malloc(sizeof(double)*(size_t) nconn*nreq);
+  t = now();
+  for (c=0;c<nconn;c++){
+    args[c].path = path;
+    args[c].la = la;
+    args[c].solver = solver;
+    args[c].nreq = nreq;
+    args[c].lat = lat + (size_t) c*nreq;
+    pthread_create(&th[c], NULL, loadgen_worker, &args[c]);
+  }
+  for (c=0;c<nconn;c++){
+    pthread_join(th[c], NULL);
+    if (args[c].status != 0) failed++;
+    err = fmax(err, args[c].err);
+  }
+  t = now() - t;
+  // Seules les requêtes abouties comptent : on les regroupe en tête de lat
+  for (c=0;c<nconn;c++){
+    memmove(lat + ntot, args[c].lat, sizeof(double)*args[c].ndone);
+    ntot += args[c].ndone;
+  }
+  qsort(lat, ntot, sizeof(double), cmp_double);
+
+  printf("%d connexion(s) x %d requêtes, la = %d, solveur %d : %d abouties\n", nconn, nreq, la, solver, ntot);
+  if (ntot > 0){
+    printf("Latence (us) : p50 = %.1f  p99 = %.1f  max = %.1f\n",
+           1e6*lat[ntot/2], 1e6*lat[(int) (0.99*(ntot-1))], 1e6*lat[ntot-1]);
+    printf("Débit : %.0f requêtes/s\n", ntot/t);
+  }
+  printf("Erreur avant relative max = %e\n", err);
+  if (failed) printf("Erreur: %d connexion(s) en échec\n", failed);
+
+  free(args);
+  free(th);
+  free(lat);
+  return failed ? 1 : 0;
+}
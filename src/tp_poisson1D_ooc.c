@@ -0,0 +1,99 @@
+/******************************************/
+/* tp_poisson1D_ooc.c                     */
+/* Out-of-core solve of the Poisson 1D    */
+/* problem: la may exceed the RAM         */
+/******************************************/
+#include "lib_poisson1D.h"
+#include <time.h>
+#include <unistd.h>
+
+int main(int argc,char *argv[])
+{
+  long long la, chunk, jj, lo, hi;
+  double T0, T1, h, err, nrm;
+  double chunk_mb = 64.0;
+  char *dir = ".";
+  char frhs[512], fsol[512], fspill[512];
+  ooc_vec RHS, SOL, SPILL;
+  struct timespec t0, t1;
+  double elapsed, gbytes;
+  long long info;
+
+  if (argc < 2 || argc > 4) {
+    printf("Usage: %s la [chunk_MB] [dir]\n", argv[0]);
+    exit(1);
+  }
+  la = atoll(argv[1]);
+  if (argc > 2) chunk_mb = atof(argv[2]);
+  if (argc > 3) dir = argv[3];
+  // Validation avant toute création de fichier
+  if (la < 1){
+    printf("Erreur: la doit être >= 1 (la = %s)\n", argv[1]);
+    exit(1);
+  }
+  if (!(chunk_mb > 0.0)){
+    printf("Erreur: chunk_MB doit être > 0 (chunk_MB = %s)\n", argv[2]);
+    exit(1);
+  }
+  chunk = (long long) (chunk_mb*1024.0*1024.0/sizeof(double));
+  if (chunk < 1) chunk = 1;
+  T0 = -5.0;
+  T1 = 5.0;
+
+  printf("--------- Poisson 1D out-of-core ---------\n\n");
+  printf("la = %lld, chunk = %lld, dir = %s\n", la, chunk, dir);
+  snprintf(frhs, sizeof(frhs), "%s/RHS_ooc.bin", dir);
+  snprintf(fsol, sizeof(fsol), "%s/SOL_ooc.bin", dir);
+  snprintf(fspill, sizeof(fspill), "%s/LU_ooc.bin", dir);
+
+  RHS.map = SOL.map = SPILL.map = NULL;
+  RHS.fd = SOL.fd = SPILL.fd = -1;
+  if (ooc_vec_create(&RHS, frhs, la) != 0
+      || ooc_vec_create(&SOL, fsol, la) != 0
+      || ooc_vec_create(&SPILL, fspill, 2*la) != 0){
+    // Pas de fichiers partiels laissés sur le disque
+    ooc_vec_close(&RHS);
+    ooc_vec_close(&SOL);
+    ooc_vec_close(&SPILL);
+    unlink(frhs);
+    unlink(fsol);
+    unlink(fspill);
+    exit(1);
+  }
+  ooc_set_dense_RHS_DBC_1D(&RHS, &T0, &T1);
+
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+  info = ooc_tridiag_solve(NULL, NULL, NULL, &RHS, &SOL, &SPILL, chunk);
+  clock_gettime(CLOCK_MONOTONIC, &t1);
+  elapsed = (t1.tv_sec - t0.tv_sec) + 1e-9*(t1.tv_nsec - t0.tv_nsec);
+  // Trafic : RHS lu, facteur écrit puis relu, solution écrite
+  gbytes = 5.0*sizeof(double)*(double) la/1e9;
+  printf("\nINFO = %lld\n", info);
+  printf("Temps = %.3f s, débit = %.2f Go/s\n", elapsed, gbytes/elapsed);
+
+  // Erreur avant relative par rapport à la solution analytique, en flux
+  h = 1.0/(la + 1);
+  err = 0.0;
+  nrm = 0.0;
+  for (lo=0;lo<la;lo+=chunk){
+    double e = 0.0, s = 0.0;
+    hi = (lo + chunk < la) ? lo + chunk : la;
+    for (jj=lo;jj<hi;jj++){
+      double ex = T0 + (jj + 1)*h*(T1 - T0);
+      double d = SOL.map[jj] - ex;
+      e += d*d;
+      s += ex*ex;
+    }
+    err += e;
+    nrm += s;
+  }
+  // Solution exacte nulle (la = 1, T0 = -T1) : erreur absolue
+  printf("\nThe relative forward error is relres = %e\n", (nrm > 0.0) ? sqrt(err/nrm) : sqrt(err));
+
+  ooc_vec_close(&RHS);
+  ooc_vec_close(&SOL);
+  ooc_vec_close(&SPILL);
+  unlink(fspill);
+  printf("\n\n--------- End -----------\n");
+  return (info != 0);
+}
@@ -0,0 +1,125 @@
+/******************************************/
+/* tp_poisson1D_order.c                   */
+/* Accuracy per second: second-order      */
+/* stencil vs fourth-order Numerov        */
+/* (+ Richardson extrapolation)           */
+/******************************************/
+#include "lib_poisson1D.h"
+#include <time.h>
+
+#define ORDER2 0
+#define NUMEROV 1
+#define NUMEROV_RICH 2
+#define NMETH 3
+#define KMIN 2
+#define KMAX 20
+
+typedef struct {
+  double T0, T1, A;
+} problem_ctx;
+
+/* u(x) = T0 + x(T1-T0) + A sin(pi x), donc f = -u'' = A pi^2 sin(pi x) */
+static double source(double x, void *ctx){
+  problem_ctx *p = (problem_ctx *) ctx;
+  return p->A*M_PI*M_PI*sin(M_PI*x);
+}
+
+static double wtime(void){
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec + 1e-9*t.tv_nsec;
+}
+
+static int solve_level(int method, int la, problem_ctx *pb, double *AB, int *ipiv, double *U){
+  int kv = 1, ku = 1, kl = 1, lab = 4, NRHS = 1, info;
+  set_GB_operator_colMajor_poisson1D_quiet(AB, &lab, &la, &kv);
+  if (method == ORDER2){
+    set_dense_RHS_source_1D(U, &la, source, pb, &pb->T0, &pb->T1);
+  } else {
+    set_dense_RHS_numerov_1D(U, &la, source, pb, &pb->T0, &pb->T1);
+  }
+  dgbsv_(&la, &kl, &ku, &NRHS, AB, &lab, ipiv, U, &la, &info);
+  return info;
+}
+
+/* Résolution complète (assemblage compris) ; U reçoit la solution sur la points */
+static int solve(int method, int la, problem_ctx *pb, double *AB, int *ipiv, double *U, double *Uf){
+  int laf = 2*la + 1, p = 4, info;
+  if (method != NUMEROV_RICH) return solve_level(method, la, pb, AB, ipiv, U);
+  info = solve_level(NUMEROV, la, pb, AB, ipiv, U);
+  info += solve_level(NUMEROV, laf, pb, AB, ipiv, Uf);
+  richardson_extrapolate_1D(U, Uf, &la, &p, U);
+  return info;
+}
+
+int main(int argc,char *argv[])
+{
+  const char *names[NMETH] = {"ordre 2", "Numerov", "Numerov+Richardson"};
+  double targets[] = {1e-4, 1e-6, 1e-8, 1e-10};
+  int ntarget = (int) (sizeof(targets)/sizeof(targets[0]));
+  double err[NMETH][KMAX+1], tim[NMETH][KMAX+1];
+  problem_ctx pb = {-5.0, 5.0, 1.0};
+  int lamax = (1 << KMAX) - 1, lafmax = 2*lamax + 1;
+  double *AB = (double *) malloc(sizeof(double)*4*lafmax);
+  double *U = (double *) malloc(sizeof(double)*lafmax);
+  double *Uf = (double *) malloc(sizeof(double)*lafmax);
+  double *X = (double *) malloc(sizeof(double)*lamax);
+  double *EX_SOL = (double *) malloc(sizeof(double)*lamax);
+  int *ipiv = (int *) malloc(sizeof(int)*lafmax);
+  int m, k, jj, t;
+  (void) argc; (void) argv;
+
+  printf("--------- Poisson 1D : ordre 2 / ordre 4 ---------\n\n");
+  printf("u(x) = T0 + x(T1-T0) + sin(pi x)\n\n");
+  printf("%-20s %9s %12s %12s %10s\n", "schéma", "la", "relres", "temps (s)", "chiffres/ms");
+  for (m=0;m<NMETH;m++){
+    for (k=KMIN;k<=KMAX;k++){
+      int la = (1 << k) - 1, nrep = 0;
+      double t0 = wtime(), el;
+      // Répétitions jusqu'à 20 ms pour les petites tailles
+      do {
+        solve(m, la, &pb, AB, ipiv, U, Uf);
+        nrep++;
+        el = wtime() - t0;
+      } while (el < 0.02);
+      tim[m][k] = el/nrep;
+      set_grid_points_1D(X, &la);
+      for (jj=0;jj<la;jj++){
+        EX_SOL[jj] = pb.T0 + X[jj]*(pb.T1 - pb.T0) + pb.A*sin(M_PI*X[jj]);
+      }
+      err[m][k] = relative_forward_error(U, EX_SOL, &la);
+      printf("%-20s %9d %12e %12e %10.2f\n", names[m], la, err[m][k], tim[m][k],
+             -log10(err[m][k])/(1e3*tim[m][k]));
+    }
+    printf("\n");
+  }
+
+  // Plus petite grille (et temps) atteignant chaque précision cible
+  printf("%-10s", "cible");
+  for (m=0;m<NMETH;m++) printf(" %28s", names[m]);
+  printf("   gain la / gain temps (Numerov)\n");
+  for (t=0;t<ntarget;t++){
+    int kbest[NMETH];
+    printf("%-10.0e", targets[t]);
+    for (m=0;m<NMETH;m++){
+      kbest[m] = -1;
+      for (k=KMIN;k<=KMAX;k++){
+        if (err[m][k] <= targets[t]){
+          kbest[m] = k;
+          break;
+        }
+      }
+      if (kbest[m] < 0) printf(" %28s", "non atteinte");
+      else printf("   la=%8d  %12.3e s", (1 << kbest[m]) - 1, tim[m][kbest[m]]);
+    }
+    if (kbest[ORDER2] >= 0 && kbest[NUMEROV] >= 0){
+      printf("   %6.0fx / %6.0fx", (double) ((1 << kbest[ORDER2]) - 1)/((1 << kbest[NUMEROV]) - 1),
+             tim[ORDER2][kbest[ORDER2]]/tim[NUMEROV][kbest[NUMEROV]]);
+    }
+    printf("\n");
+  }
+
+  free(AB); free(U); free(Uf); free(X); free(EX_SOL); free(ipiv);
+  printf("\n\n--------- End -----------\n");
+  return 0;
+}
@@ -0,0 +1,458 @@
+/******************************************/
+/* tp_poisson1D_perf.c                    */
+/* This file contains the main function   */
+/* of the performance regression suite    */
+/* of the Poisson 1D solvers              */
+/******************************************/
+#include "lib_poisson1D.h"
+#include <time.h>
+#include <omp.h>
+
+#define PERF_NREP 11
+#define PERF_NROUND 3
+#define PERF_MAXBENCH 32
+#define PERF_DEFAULT_TOL 0.50
+
+typedef struct {
+  char name[64];
+  int la;
+  double median;      /* min over rounds of the median time (s) */
+  double bandwidth;   /* achieved bandwidth (GB/s) */
+  double tol;         /* relative tolerance on both metrics */
+} perf_result;
+
+static double wtime(void){
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + 1e-9*ts.tv_nsec;
+}
+
+static int cmp_double(const void *a, const void *b){
+  double da = *(const double *) a;
+  double db = *(const double *) b;
+  return (da < db) ? -1 : (da > db);
+}
+
+/* Problem shared by all the benchmarks */
+typedef struct {
+  int la;
+  double *AB3;      /* lab=3, kv=0 : matvec and iterative solvers */
+  double *AB4;      /* lab=4, kv=1 : LAPACK factorizations */
+  double *LU;
+  double *RHS;
+  double *X;
+  double *Y;
+  double *resvec;
+  int *ipiv;
+  csr_matrix A;
+  sell_matrix S;
+  dst_plan plan;
+  krylov_ws ws;     /* allocated on first Krylov run (warm-up) */
+  p1d_team team;    /* created on first team run (warm-up) */
+  heat_ie_plan fine, coarse;  /* created on first Parareal run (warm-up) */
+  double *Uh;       /* Parareal slice states */
+  p1d_lowrank lr;   /* factorized on first low-rank run (warm-up) */
+  double *snap;     /* smooth field for the p1z snapshots */
+} perf_problem;
+
+#define PERF_ITMAX 99
+#define PERF_NSLICE 16
+
+static void perf_setup(perf_problem *p, int la){
+  int lab3 = 3, lab4 = 4, ku = 1, kl = 1, kv = 0, kv1 = 1, jj;
+  double T0 = 5.0, T1 = 20.0;
+  p->la = la;
+  p->AB3 = (double *) malloc(sizeof(double)*3*la);
+  p->AB4 = (double *) malloc(sizeof(double)*4*la);
+  p->LU = (double *) malloc(sizeof(double)*4*la);
+  p->RHS = (double *) malloc(sizeof(double)*la);
+  p->X = (double *) malloc(sizeof(double)*la);
+  p->Y = (double *) malloc(sizeof(double)*la);
+  p->resvec = (double *) calloc(PERF_ITMAX+1, sizeof(double));
+  p->ipiv = (int *) malloc(sizeof(int)*la);
+  // Premier accès par les threads qui exécuteront les noyaux
+  set_GB_operator_colMajor_poisson1D_par(p->AB3, &lab3, &la, &kv);
+  set_GB_operator_colMajor_poisson1D_par(p->AB4, &lab4, &la, &kv1);
+  set_GB_operator_colMajor_poisson1D_par(p->LU, &lab4, &la, &kv1);
+  set_dense_RHS_DBC_1D_par(p->RHS, &la, &T0, &T1);
+  set_grid_points_1D_par(p->Y, &la);
+  #pragma omp parallel for schedule(static)
+  for (jj=0;jj<la;jj++) p->X[jj] = 1.0;
+  GB2CSR_operator_colMajor(p->AB3, &lab3, &la, &ku, &kl, &kv, &p->A);
+  CSR2SELL(&p->A, 4, 64, &p->S);
+  dst_plan_create(&p->plan, &la);
+  memset(&p->ws, 0, sizeof(krylov_ws));
+  memset(&p->team, 0, sizeof(p1d_team));
+  memset(&p->fine, 0, sizeof(heat_ie_plan));
+  memset(&p->coarse, 0, sizeof(heat_ie_plan));
+  p->Uh = NULL;
+  memset(&p->lr, 0, sizeof(p1d_lowrank));
+  p->snap = NULL;
+}
+
+static void perf_release(perf_problem *p){
+  free(p->AB3); free(p->AB4); free(p->LU);
+  free(p->RHS); free(p->X); free(p->Y);
+  free(p->resvec); free(p->ipiv);
+  csr_free(&p->A);
+  sell_free(&p->S);
+  dst_plan_free(&p->plan);
+  if (p->ws.n > 0) krylov_ws_free(&p->ws);
+  p1d_team_free(&p->team);
+  heat_ie_plan_free(&p->fine);
+  heat_ie_plan_free(&p->coarse);
+  free(p->Uh);
+  p1d_lowrank_free(&p->lr);
+  free(p->snap);
+}
+
+/* One run of benchmark 'id', returns the number of bytes moved */
+static double perf_kernel(int id, perf_problem *p){
+  int la = p->la, lab3 = 3, lab4 = 4, ku = 1, kl = 1, kv = 0, kv1 = 1;
+  int NRHS = 1, info, maxit = PERF_ITMAX, nbite, m = 30;
+  double tol = 0.0, alpha = 0.5;
+  double T0 = 5.0, T1 = 20.0;
+  double n = (double) la;
+
+  switch (id){
+  case 0:
+    dgbmv_poisson1D(p->AB3, p->X, p->Y, &la, &lab3, &ku, &kl, &kv);
+    return 8.0*n*(3+2);
+  case 1:
+    csr_spmv(&p->A, p->X, p->Y);
+    return 12.0*p->A.nnz + 8.0*n*2 + 4.0*n;
+  case 2:
+    sell_spmv(&p->S, p->X, p->Y);
+    return 12.0*p->S.chunkptr[p->S.nchunks] + 8.0*n*2;
+  case 3:
+    memcpy(p->LU, p->AB4, sizeof(double)*4*la);
+    memcpy(p->Y, p->RHS, sizeof(double)*la);
+    dgbsv_(&la, &kl, &ku, &NRHS, p->LU, &lab4, p->ipiv, p->Y, &la, &info);
+    return 8.0*n*(4*2+2) + 4.0*n;
+  case 4:
+    memcpy(p->LU, p->AB4, sizeof(double)*4*la);
+    memcpy(p->Y, p->RHS, sizeof(double)*la);
+    dgbtrf_(&la, &la, &kl, &ku, p->LU, &lab4, p->ipiv, &info);
+    dgbtrs_("N", &la, &kl, &ku, &NRHS, p->LU, &lab4, p->ipiv, p->Y, &la, &info);
+    return 8.0*n*(4*3+2) + 8.0*n;
+  case 5:
+    memset(p->Y, 0, sizeof(double)*la);
+    richardson_alpha_csr(&p->A, p->RHS, p->Y, &alpha, &tol, &maxit, p->resvec, &nbite);
+    return (12.0*p->A.nnz + 8.0*n*5) * nbite;
+  case 6:
+    memset(p->Y, 0, sizeof(double)*la);
+    jacobi_tridiag(p->AB3, p->RHS, p->Y, &lab3, &la, &ku, &kl, &tol, &maxit, p->resvec, &nbite);
+    return 8.0*n*(3+2+5) * nbite;
+  case 7:
+    memset(p->Y, 0, sizeof(double)*la);
+    gauss_seidel_tridiag(p->AB3, p->RHS, p->Y, &lab3, &la, &ku, &kl, &tol, &maxit, p->resvec, &nbite);
+    return 8.0*n*(3+2+5+2) * nbite;
+  case 8:
+    memcpy(p->Y, p->RHS, sizeof(double)*la);
+    poisson1D_dst_solve(&p->plan, p->Y, &NRHS, &la, NULL, NULL);
+    return 8.0*n*(2+2*4+1);
+  case 9:
+    set_grid_points_1D_par(p->Y, &la);
+    set_dense_RHS_DBC_1D_par(p->RHS, &la, &T0, &T1);
+    set_analytical_solution_DBC_1D_par(p->LU, p->Y, &la, &T0, &T1);
+    set_GB_operator_colMajor_poisson1D_par(p->AB3, &lab3, &la, &kv);
+    return 8.0*n*(1+1+2+3);
+  case 10:
+  case 11:
+    if (p->ws.n == 0) krylov_ws_init(&p->ws, p->AB3, &lab3, &la, &kv, &m, KRYLOV_PREC_JACOBI);
+    memset(p->Y, 0, sizeof(double)*la);
+    if (id == 10){
+      gmres_tridiag(&p->ws, p->RHS, p->Y, &tol, &maxit, p->resvec, &nbite);
+      // Base de taille moyenne m/2 : produit, 2 passes CGS2 (lecture base + w)
+      return 8.0*n*(5 + 3 + 2*(2*(0.5*m + 1) + 2)) * nbite;
+    }
+    bicgstab_tridiag(&p->ws, p->RHS, p->Y, &tol, &maxit, p->resvec, &nbite);
+    return 8.0*n*30 * nbite;
+  case 12:
+  case 13:
+  case 14:
+    if (p->team.nthreads == 0){
+      p1d_team_create(&p->team, omp_get_max_threads(), poisson1D_pin_policy(getenv("POISSON1D_PIN")));
+    }
+    memset(p->Y, 0, sizeof(double)*la);
+    if (id == 13){
+      richardson_alpha_team(&p->team, p->AB3, p->RHS, p->Y, &alpha, &lab3, &la, &tol, &maxit, p->resvec, &nbite);
+    } else {
+      jacobi_tridiag_team(&p->team, p->AB3, p->RHS, p->Y, &lab3, &la, &tol, &maxit, p->resvec, &nbite);
+    }
+    // Balayage fusionné : bande, second membre, lecture et écriture de l'itéré
+    return 8.0*n*(3+1+2) * nbite;
+  case 15:
+    {
+      int N = PERF_NSLICE, nfine = 8, ncoarse = 1, maxk = 4, nth = omp_get_max_threads(), k;
+      double dtf = 1e-6, dtc = dtf*nfine, steps = 0.0;
+      if (p->Uh == NULL){
+        heat_ie_plan_create(&p->fine, &la, &dtf, &T0, &T1);
+        heat_ie_plan_create(&p->coarse, &la, &dtc, &T0, &T1);
+        p->Uh = (double *) malloc(sizeof(double)*(N+1)*la);
+      }
+      memcpy(p->Uh, p->X, sizeof(double)*la);
+      heat_parareal(&p->fine, &p->coarse, &N, &nfine, &ncoarse, p->Uh, &tol, &maxk, &nth, p->resvec, &nbite);
+      // Prédiction, puis par itération k : fins sur N-k tranches, grossiers sur N-k-1
+      steps = N*ncoarse;
+      for (k=0;k<nbite;k++) steps += (N-k)*nfine + (N-k-1)*ncoarse;
+      // Descente-remontée : facteurs L, U (2 bandes) et état lu puis écrit
+      return 8.0*n*(3+2) * steps;
+    }
+  case 16:
+    {
+      // Requête : deux conductivités modifiées, résolution, retour à l'état initial
+      int kmax = 0, e0 = la/3, e1 = (2*la)/3;
+      double dk = 0.5, mdk = -0.5;
+      if (p->lr.la == 0) p1d_lowrank_init(&p->lr, p->AB4, &lab4, &la, &kv1, &kmax);
+      p1d_lowrank_update_edge(&p->lr, &e0, &dk);
+      p1d_lowrank_update_edge(&p->lr, &e1, &dk);
+      memcpy(p->Y, p->RHS, sizeof(double)*la);
+      p1d_lowrank_solve(&p->lr, p->Y, &NRHS);
+      p1d_lowrank_update_edge(&p->lr, &e0, &mdk);
+      p1d_lowrank_update_edge(&p->lr, &e1, &mdk);
+      // dgbtrs (facteurs et second membre), puis une lecture de Z et une
+      // lecture-écriture de Y par colonne
+      return 8.0*n*(4+2) + 8.0*n*3*p->lr.k;
+    }
+  case 17:
+  case 18:
+    {
+      char name[512];
+      double eb = 1e-6;
+      snprintf(name, sizeof(name), "%s/poisson1D_perf.p1z", getenv("TMPDIR") ? getenv("TMPDIR") : "/tmp");
+      if (p->snap == NULL){
+        int jj;
+        p->snap = (double *) malloc(sizeof(double)*la);
+        set_grid_points_1D(p->snap, &la);
+        for (jj=0;jj<la;jj++) p->snap[jj] = T0 + (T1 - T0)*p->snap[jj] + 10.0*sin(M_PI*p->snap[jj]);
+        p1z_write(p->snap, la, eb, 0, name);
+      }
+      if (id == 17){
+        p1z_write(p->snap, la, eb, 0, name);
+      } else {
+        p1z_reader r;
+        p1z_open(&r, name);
+        p1z_read(&r, 0, la, p->Y);
+        p1z_close(&r);
+      }
+      // Débit rapporté au vecteur non compressé
+      return 8.0*n;
+    }
+  case 19:
+    {
+      p1d_spectrum spec;
+      int msp = SPECTRUM_M;
+      spectrum_lanczos_tridiag(p->AB3, &lab3, &la, KRYLOV_PREC_NONE, &msp, &spec);
+      // par pas : produit (3+2), dot (2), mise à jour (4), nrm2 (1), normalisation (2)
+      return 8.0*n*(5+2+4+1+2) * spec.nmatvec;
+    }
+  case 20:
+    // Estimation du spectre en cache après l'échauffement
+    memset(p->Y, 0, sizeof(double)*la);
+    chebyshev_tridiag(p->AB3, p->RHS, p->Y, &lab3, &la, KRYLOV_PREC_JACOBI, &tol, &maxit, p->resvec, &nbite);
+    return 8.0*n*(5+6+4+1) * nbite;
+  }
+  return 0.0;
+}
+
+static const char *perf_names[] = {
+  "dgbmv_poisson1D", "csr_spmv", "sell_spmv", "dgbsv",
+  "dgbtrf_dgbtrs", "richardson_alpha_csr", "jacobi_tridiag", "gauss_seidel_tridiag",
+  "dst_solve", "assembly_par", "gmres_tridiag", "bicgstab_tridiag",
+  "jacobi_tridiag_team", "richardson_alpha_team", "jacobi_tridiag_team_mid", "heat_parareal",
+  "lowrank_whatif", "p1z_write", "p1z_read", "spectrum_lanczos",
+  "chebyshev_tridiag"
+};
+static const int perf_sizes[] = {
+  1000000, 1000000, 1000000, 1000000,
+  1000000, 100000, 100000, 100000,
+  1048575, 1000000, 100000, 100000,
+  100000, 100000, 10000, 10000,
+  1000000, 1000000, 1000000, 100000,
+  100000
+};
+#define PERF_NB ((int)(sizeof(perf_sizes)/sizeof(perf_sizes[0])))
+
+/* Médiane de PERF_NREP répétitions d'un noyau, après un échauffement */
+static double perf_measure(int id, perf_problem *p, double *bytes){
+  double t[PERF_NREP];
+  int rep;
+  perf_kernel(id, p);
+  for (rep=0;rep<PERF_NREP;rep++){
+    double t0 = wtime();
+    *bytes = perf_kernel(id, p);
+    t[rep] = wtime() - t0;
+  }
+  qsort(t, PERF_NREP, sizeof(double), cmp_double);
+  return t[PERF_NREP/2];
+}
+
+/* Minimum sur PERF_NROUND tours des médianes des noyaux sélectionnés. Les
+   tours parcourent toute la sélection : une perturbation passagère de la
+   machine ne touche qu'un tour d'un noyau donné, et le minimum l'écarte */
+static void perf_run(perf_result *res, int *sel){
+  perf_problem p;
+  double bytes[PERF_MAXBENCH];
+  int id, round, la;
+
+  for (round=0;round<PERF_NROUND;round++){
+    la = -1;
+    for (id=0;id<PERF_NB;id++){
+      double med;
+      if (!sel[id]) continue;
+      if (perf_sizes[id] != la){
+        if (la > 0) perf_release(&p);
+        la = perf_sizes[id];
+        perf_setup(&p, la);
+      }
+      med = perf_measure(id, &p, &bytes[id]);
+      if (round == 0 || med < res[id].median) res[id].median = med;
+    }
+    if (la > 0) perf_release(&p);
+  }
+  for (id=0;id<PERF_NB;id++){
+    if (!sel[id]) continue;
+    snprintf(res[id].name, sizeof(res[id].name), "%s", perf_names[id]);
+    res[id].la = perf_sizes[id];
+    res[id].bandwidth = bytes[id] / res[id].median * 1e-9;
+    res[id].tol = PERF_DEFAULT_TOL;
+  }
+}
+
+static int read_baseline(char *filename, perf_result *base){
+  FILE *file;
+  char line[256];
+  int nb = 0;
+  file = fopen(filename, "r");
+  if (file == NULL){
+    perror(filename);
+    return -1;
+  }
+  while (fgets(line, sizeof(line), file) != NULL && nb < PERF_MAXBENCH){
+    if (line[0] == '#' || line[0] == '\n') continue;
+    if (sscanf(line, "%63s %d %lf %lf %lf", base[nb].name, &base[nb].la,
+               &base[nb].median, &base[nb].bandwidth, &base[nb].tol) == 5){
+      nb++;
+    }
+  }
+  fclose(file);
+  return nb;
+}
+
+static int write_baseline(char *filename, perf_result *res, int nb){
+  FILE *file;
+  char tmpname[512];
+  int id;
+  snprintf(tmpname, sizeof(tmpname), "%s.tmp", filename);
+  file = fopen(tmpname, "w");
+  if (file == NULL){
+    perror(tmpname);
+    return -1;
+  }
+  fprintf(file, "# poisson1D perf baseline v1\n");
+  fprintf(file, "# machine-local: absolute times, regenerate with 'make perfbaseline' on the target machine\n");
+  fprintf(file, "# name\tla\tmedian_s\tbandwidth_GBs\ttolerance\n");
+  for (id=0;id<nb;id++){
+    fprintf(file, "%s\t%d\t%e\t%e\t%.2f\n", res[id].name, res[id].la,
+            res[id].median, res[id].bandwidth, res[id].tol);
+  }
+  fclose(file);
+  return rename(tmpname, filename);
+}
+
+static perf_result *find_bench(perf_result *base, int nb, char *name){
+  int id;
+  for (id=0;id<nb;id++){
+    if (strcmp(base[id].name, name) == 0) return &base[id];
+  }
+  return NULL;
+}
+
+static int perf_slow(perf_result *r, perf_result *b){
+  return r->median > b->median * (1.0 + b->tol)
+      || r->bandwidth < b->bandwidth / (1.0 + b->tol)
+      || r->la != b->la;
+}
+
+int main(int argc,char *argv[])
+{
+  perf_result res[PERF_MAXBENCH], base[PERF_MAXBENCH];
+  perf_result *b, again[PERF_MAXBENCH];
+  int sel[PERF_MAXBENCH], nsuspect = 0;
+  char *mode, *filename, *pin;
+  int nbase, id, nfail = 0;
+
+  if (argc != 3 || (strcmp(argv[1], "check") != 0 && strcmp(argv[1], "record") != 0)) {
+    printf("Usage: %s check|record baseline_file\n", argv[0]);
+    exit(1);
+  }
+  mode = argv[1];
+  filename = argv[2];
+
+  printf("--------- Poisson 1D performance suite ---------\n\n");
+  // Placement des threads : POISSON1D_PIN=compact|spread, compact par défaut
+  // pour que deux mesures voient le même placement
+  pin = getenv("POISSON1D_PIN");
+  poisson1D_pin_threads(poisson1D_pin_policy((pin != NULL) ? pin : "compact"));
+  for (id=0;id<PERF_NB;id++) sel[id] = 1;
+  perf_run(res, sel);
+
+  if (strcmp(mode, "record") == 0) {
+    // Les tolérances réglées à la main dans l'ancienne référence sont conservées
+    nbase = read_baseline(filename, base);
+    for (id=0;id<PERF_NB;id++){
+      b = (nbase > 0) ? find_bench(base, nbase, res[id].name) : NULL;
+      if (b != NULL) res[id].tol = b->tol;
+      printf("%-22s la=%-8d median = %e s  bw = %6.2f GB/s\n",
+             res[id].name, res[id].la, res[id].median, res[id].bandwidth);
+    }
+    if (write_baseline(filename, res, PERF_NB) != 0) exit(1);
+    printf("\nBaseline written to %s\n", filename);
+    printf("\n\n--------- End -----------\n");
+    return 0;
+  }
+
+  nbase = read_baseline(filename, base);
+  if (nbase < 0) exit(1);
+
+  // Un noyau hors tolérance est remesuré avant d'être déclaré en régression :
+  // il garde le meilleur des deux passages
+  for (id=0;id<PERF_NB;id++){
+    b = find_bench(base, nbase, res[id].name);
+    sel[id] = (b != NULL && perf_slow(&res[id], b));
+    nsuspect += sel[id];
+  }
+  if (nsuspect > 0){
+    printf("Re-measuring %d benchmark(s) outside tolerance\n\n", nsuspect);
+    perf_run(again, sel);
+    for (id=0;id<PERF_NB;id++){
+      if (sel[id] && again[id].median < res[id].median) res[id] = again[id];
+    }
+  }
+
+  printf("%-22s %9s %12s %12s %8s %9s %9s %8s  %s\n", "benchmark", "la",
+         "base (s)", "now (s)", "dt (%)", "base GB/s", "now GB/s", "tol (%)", "status");
+  for (id=0;id<PERF_NB;id++){
+    b = find_bench(base, nbase, res[id].name);
+    if (b == NULL) {
+      printf("%-22s %9d %12s %12e %8s %9s %9.2f %8s  NEW\n", res[id].name, res[id].la,
+             "-", res[id].median, "-", "-", res[id].bandwidth, "-");
+      continue;
+    }
+    int slow = perf_slow(&res[id], b);
+    printf("%-22s %9d %12e %12e %+8.1f %9.2f %9.2f %8.0f  %s\n", res[id].name, res[id].la,
+           b->median, res[id].median, 100.0*(res[id].median/b->median - 1.0),
+           b->bandwidth, res[id].bandwidth, 100.0*b->tol, slow ? "REGRESSION" : "ok");
+    nfail += slow;
+  }
+
+  if (nfail > 0) {
+    printf("\n%d benchmark(s) regressed against %s\n", nfail, filename);
+    printf("Re-record with 'make perfbaseline' if the slowdown is intended.\n");
+    exit(1);
+  }
+  printf("\nAll benchmarks within tolerance of %s\n", filename);
+  printf("\n\n--------- End -----------\n");
+  return 0;
+}
@@ -0,0 +1,42 @@
+/******************************************/
+/* tp_poisson1D_server.c                  */
+/* Resident Poisson 1D solver daemon      */
+/******************************************/
+#include "lib_poisson1D.h"
+#include <signal.h>
+
+static p1d_server server;
+
+static void on_signal(int sig){
+  (void) sig;
+  p1d_server_stop(&server);
+}
+
+int main(int argc,char *argv[])
+{
+  char *path = "/tmp/poisson1D.sock";
+  size_t cache_mb = 256;
+
+  if (argc > 3) {
+    printf("Usage: %s [socket] [cache_MB]\n", argv[0]);
+    exit(1);
+  }
+  if (argc > 1) path = argv[1];
+  if (argc > 2) cache_mb = (size_t) atol(argv[2]);
+
+  if (p1d_server_init(&server, path, cache_mb*1024*1024) != 0){
+    exit(1);
+  }
+  signal(SIGINT, on_signal);
+  signal(SIGTERM, on_signal);
+  signal(SIGPIPE, SIG_IGN);
+  printf("Serveur Poisson 1D en écoute sur %s\n", path);
+  fflush(stdout);
+
+  p1d_server_run(&server);
+
+  printf("Arrêt : %llu requête(s), %llu résolution(s) de base, %d factorisation(s) (%d en cache)\n",
+         server.nrequests, server.bc.nsolves, server.nfactor, server.nlu);
+  p1d_server_free(&server);
+  return 0;
+}
@@ -0,0 +1,116 @@
+/******************************************/
+/* tp_poisson1D_snap.c                    */
+/* Compressed snapshots: ratio, error and */
+/* throughput of the p1z modes; decoding  */
+/* of a range of a .p1z file              */
+/******************************************/
+#include "lib_poisson1D.h"
+#include <time.h>
+#include <sys/stat.h>
+
+static double wtime(void){
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + 1e-9*ts.tv_nsec;
+}
+
+static long long file_size(char *filename){
+  struct stat st;
+  return (stat(filename, &st) == 0) ? (long long) st.st_size : -1;
+}
+
+/* Compression, relecture complète et 1000 lectures aléatoires de 16 valeurs */
+static void snap_report(const char *name, double *v, long long n, double eb, char *filename){
+  p1z_reader r;
+  double *w = (double *) malloc(sizeof(double)*n), tw, tr, ta, err = 0.0, seg[16];
+  long long size, jj;
+  int q;
+  tw = wtime();
+  p1z_write(v, n, eb, 0, filename);
+  tw = wtime() - tw;
+  size = file_size(filename);
+  tr = wtime();
+  p1z_open(&r, filename);
+  p1z_read(&r, 0, n, w);
+  tr = wtime() - tr;
+  ta = wtime();
+  for (q=0;q<1000;q++){
+    long long i0 = ((long long) q*7919*7919) % (n > 16 ? n - 16 : 1);
+    p1z_read(&r, i0, (n < 16) ? n : 16, seg);
+  }
+  ta = wtime() - ta;
+  p1z_close(&r);
+  for (jj=0;jj<n;jj++){
+    double d = fabs(w[jj] - v[jj]);
+    if (eb == 0.0 && memcmp(&w[jj], &v[jj], sizeof(double)) != 0) d = INFINITY;
+    err = fmax(err, d);
+  }
+  printf("%-22s | %9.1e | %8.2f | %9.2e | %8.0f | %8.0f | %7.1f\n", name, eb,
+         8.0*n/size, err, 8e-6*n/tw, 8e-6*n/tr, 1e6*ta/1000);
+  free(w);
+}
+
+int main(int argc,char *argv[])
+{
+  long long n = 1000000, jj;
+  double *U, *resvec, *X, *RHS, T0 = -5.0, T1 = 5.0, eb[3] = {1e-4, 1e-6, 1e-9};
+  char filename[512];
+  double *AB;
+  int la, lab = 3, kv = 0, maxit = 100000, nbite, k;
+
+  // Décodage : tpPoisson1D_snap fichier.p1z [i0 [n]]
+  if (argc >= 2) {
+    p1z_reader r;
+    long long i0 = 0, m;
+    double *v;
+    if (p1z_open(&r, argv[1]) != 0) exit(1);
+    if (argc >= 3) i0 = atoll(argv[2]);
+    m = (argc >= 4) ? atoll(argv[3]) : r.n - i0;
+    v = (double *) malloc(sizeof(double)*(m > 0 ? m : 1));
+    if (p1z_read(&r, i0, m, v) != 0) {
+      printf("Erreur: intervalle [%lld, %lld[ hors de [0, %lld[\n", i0, i0 + m, r.n);
+      exit(1);
+    }
+    for (jj=0;jj<m;jj++) printf("%.17g\n", v[jj]);
+    free(v);
+    p1z_close(&r);
+    return 0;
+  }
+
+  snprintf(filename, sizeof(filename), "%s/SNAP.p1z", getenv("TMPDIR") ? getenv("TMPDIR") : "/tmp");
+  printf("--------- Poisson 1D, instantanés compressés ---------\n");
+  printf("taux : octets en double précision / octets du fichier ; débits en Mo/s ; accès aléatoire en us\n\n");
+  printf("%-22s | %9s | %8s | %9s | %8s | %8s | %7s\n", "champ", "borne", "taux", "err max",
+         "écriture", "lecture", "16 val.");
+
+  // Champ régulier : solution transitoire de la chaleur sur 10^6 points
+  U = (double *) malloc(sizeof(double)*n);
+  X = (double *) malloc(sizeof(double)*n);
+  la = (int) n;
+  set_grid_points_1D(X, &la);
+  for (jj=0;jj<n;jj++){
+    U[jj] = T0 + X[jj]*(T1 - T0) + 10.0*sin(M_PI*X[jj])*exp(-0.1) + 2.0*sin(8.0*M_PI*X[jj])*exp(-6.4);
+  }
+  for (k=0;k<3;k++) snap_report("chaleur", U, n, eb[k], filename);
+  snap_report("chaleur (sans perte)", U, n, 0.0, filename);
+
+  // Historique de résidus de Jacobi (sans perte)
+  la = 100;
+  resvec = (double *) calloc(maxit+1, sizeof(double));
+  RHS = (double *) malloc(sizeof(double)*la);
+  free(X);
+  X = (double *) calloc(la, sizeof(double));
+  AB = (double *) malloc(sizeof(double)*lab*la);
+  set_GB_operator_colMajor_poisson1D_quiet(AB, &lab, &la, &kv);
+  set_dense_RHS_DBC_1D(RHS, &la, &T0, &T1);
+  for (nbite=0;nbite<maxit;nbite++){
+    resvec[nbite] = jacobi_tridiag_step(AB, RHS, X, U, &lab, &la);
+    if (resvec[nbite] <= 1e-12) break;
+  }
+  snap_report("résidus Jacobi", resvec, (nbite < maxit) ? nbite + 1 : nbite, 0.0, filename);
+
+  remove(filename);
+  free(U); free(X); free(RHS); free(resvec); free(AB);
+  printf("\n\n--------- End -----------\n");
+  return 0;
+}
@@ -0,0 +1,84 @@
+/******************************************/
+/* tp_poisson_nd.c                        */
+/* 2D and 3D Poisson by fast              */
+/* diagonalization on the 1D kernels      */
+/******************************************/
+#include "lib_poisson1D.h"
+#include <time.h>
+
+/* u = sin(pi x) sin(2 pi y) sin(pi z) + x y (z), le second terme harmonique
+   porte des conditions de bord non nulles */
+static double exact(double x, double y, double z, void *ctx){
+  int dim = *(int *) ctx;
+  if (dim == 2) return sin(M_PI*x)*sin(2.0*M_PI*y) + x*y;
+  return sin(M_PI*x)*sin(2.0*M_PI*y)*sin(M_PI*z) + x*y*z;
+}
+
+static double source(double x, double y, double z, void *ctx){
+  int dim = *(int *) ctx;
+  if (dim == 2) return 5.0*M_PI*M_PI*sin(M_PI*x)*sin(2.0*M_PI*y);
+  return 6.0*M_PI*M_PI*sin(M_PI*x)*sin(2.0*M_PI*y)*sin(M_PI*z);
+}
+
+static double wtime(void){
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec + 1e-9*t.tv_nsec;
+}
+
+static void run(int dim, int nx, int ny, int nz){
+  poisson_nd_plan plan;
+  long N = (long) nx*ny*nz, idx;
+  double *U = (double *) malloc(sizeof(double)*N);
+  double *EX_SOL = (double *) malloc(sizeof(double)*N);
+  double t0, tplan, tsolve, err = 0.0, nrm = 0.0;
+  int rep, nrep = 5, i, j, l;
+
+  t0 = wtime();
+  if (dim == 2) poisson2D_plan_create(&plan, &nx, &ny);
+  else poisson3D_plan_create(&plan, &nx, &ny, &nz);
+  tplan = wtime() - t0;
+
+  for (l=0;l<nz;l++){
+    for (j=0;j<ny;j++){
+      for (i=0;i<nx;i++){
+        double z = (dim == 3) ? (l+1.0)/(nz+1) : 0.0;
+        EX_SOL[i + (long) nx*(j + (long) ny*l)] = exact((i+1.0)/(nx+1), (j+1.0)/(ny+1), z, &dim);
+      }
+    }
+  }
+  // Médiane grossière : meilleur temps sur nrep résolutions
+  tsolve = 1e30;
+  for (rep=0;rep<nrep;rep++){
+    set_dense_RHS_DBC_nd(U, &plan, source, exact, &dim);
+    t0 = wtime();
+    poisson_nd_solve(&plan, U);
+    tsolve = fmin(tsolve, wtime() - t0);
+  }
+  for (idx=0;idx<N;idx++){
+    err = fmax(err, fabs(U[idx] - EX_SOL[idx]));
+    nrm = fmax(nrm, fabs(EX_SOL[idx]));
+  }
+  if (dim == 2) printf("2D %5d x %-5d       ", nx, ny);
+  else printf("3D %4d x %4d x %-4d  ", nx, ny, nz);
+  printf(" plan %8.3f s  résolution %8.4f s  %7.1f Mpoints/s  erreur max rel %e\n",
+         tplan, tsolve, 1e-6*N/tsolve, err/nrm);
+  poisson_nd_plan_free(&plan);
+  free(U);
+  free(EX_SOL);
+}
+
+int main(int argc,char *argv[])
+{
+  (void) argc; (void) argv;
+  printf("--------- Poisson 2D/3D : diagonalisation rapide ---------\n\n");
+  run(2, 255, 255, 1);
+  run(2, 511, 511, 1);
+  run(2, 1023, 1023, 1);
+  run(2, 1000, 700, 1);
+  run(3, 63, 63, 63);
+  run(3, 127, 127, 127);
+  run(3, 100, 120, 90);
+  printf("\n\n--------- End -----------\n");
+  return 0;
+}